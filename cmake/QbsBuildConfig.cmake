@@ -6,6 +6,12 @@ option(QBS_USE_BUNDLED_QT_SCRIPT "Whether to use bundled QtScript module" OFF)
 option(QBS_INSTALL_HTML_DOCS "Whether to install HTML Documentation" OFF)
 option(QBS_INSTALL_QCH_DOCS "Whether to install QCH Documentation" OFF)
 
+set(QBS_SCRIPT_BACKEND "qtscript" CACHE STRING "JavaScript engine backend to use. Only \"qtscript\" is available.")
+if(NOT QBS_SCRIPT_BACKEND STREQUAL "qtscript")
+    message(FATAL_ERROR "Unknown script backend \"${QBS_SCRIPT_BACKEND}\".")
+endif()
+string(TOUPPER "${QBS_SCRIPT_BACKEND}" QBS_SCRIPT_BACKEND_DEFINE_SUFFIX)
+
 set(QBS_APP_INSTALL_DIR "bin" CACHE STRING "Relative install location for Qbs binaries.")
 # default paths
 set(QBS_LIBDIR_NAME "lib")
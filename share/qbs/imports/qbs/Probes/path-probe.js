@@ -109,34 +109,36 @@ function configure(selectors, names, nameSuffixes, nameFilter, candidateFilter,
     var _suffixes = ModUtils.concatAll('', pathSuffixes);
     _paths = _paths.map(function(p) { return FileInfo.fromNativeSeparators(p); });
     _suffixes = _suffixes.map(function(p) { return FileInfo.fromNativeSeparators(p); });
+    var _dirs = [];
+    for (var j = 0; j < _paths.length; ++j) {
+        for (var k = 0; k < _suffixes.length; ++k)
+            _dirs.push(FileInfo.joinPaths(_paths[j], _suffixes[k]));
+    }
 
     var findFile = function(selector) {
         var file = { found: false, candidatePaths: [] };
-        for (var i = 0; i < selector.names.length; ++i) {
-            for (var j = 0; j < _paths.length; ++j) {
-                for (var k = 0; k < _suffixes.length; ++k) {
-                    var _filePath = FileInfo.joinPaths(_paths[j], _suffixes[k], selector.names[i]);
-                    file.candidatePaths.push(_filePath);
-                    if (File.exists(_filePath)
-                            && (!candidateFilter || candidateFilter(_filePath))) {
-                        file.found = true;
-                        file.filePath = _filePath;
+        var from = 0;
+        while (true) {
+            var match = File.findFirst(_dirs, selector.names, from);
+            file.candidatePaths = file.candidatePaths.concat(match.candidatePaths);
+            if (match.index === -1)
+                return file;
+            from = match.index + 1;
+            if (candidateFilter && !candidateFilter(match.filePath))
+                continue;
+            file.found = true;
+            file.filePath = match.filePath;
 
-                        // Manually specify the path components that constitute _filePath rather
-                        // than using the FileInfo.path and FileInfo.fileName functions because we
-                        // want to break _filePath into its constituent parts based on the input
-                        // originally given by the user. For example, the FileInfo functions would
-                        // produce a different result if any of the items in the names property
-                        // contained more than a single path component.
-                        file.fileName = selector.names[i];
-                        file.path = FileInfo.joinPaths(_paths[j], _suffixes[k]);
-                        return file;
-                    }
-                }
-            }
+            // Manually specify the path components that constitute filePath rather
+            // than using the FileInfo.path and FileInfo.fileName functions because we
+            // want to break filePath into its constituent parts based on the input
+            // originally given by the user. For example, the FileInfo functions would
+            // produce a different result if any of the items in the names property
+            // contained more than a single path component.
+            file.fileName = selector.names[Math.floor(match.index / _dirs.length)];
+            file.path = _dirs[match.index % _dirs.length];
+            return file;
         }
-
-        return file;
     };
 
     result.files = selectors.map(findFile);
@@ -58,8 +58,10 @@
 #include <QtCore/qprocess.h>
 #include <QtCore/qtimer.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
+#include <vector>
 
 namespace qbs {
 using namespace Internal;
@@ -124,6 +126,8 @@ void CommandLineFrontend::start()
         case InstallCommandType:
         case DumpNodesTreeCommandType:
         case ListProductsCommandType:
+        case ResourceUsageCommandType:
+        case QueryCommandType:
             if (m_parser.buildConfigurations().size() > 1) {
                 QString error = Tr::tr("Invalid use of command '%1': There can be only one "
                                "build configuration.\n").arg(m_parser.commandName());
@@ -421,6 +425,14 @@ void CommandLineFrontend::handleProjectsResolved()
         listProducts();
         qApp->quit();
         break;
+    case ResourceUsageCommandType:
+        listResourceUsage();
+        qApp->quit();
+        break;
+    case QueryCommandType:
+        queryBuildGraph();
+        qApp->quit();
+        break;
     case HelpCommandType:
     case VersionCommandType:
     case SessionCommandType:
@@ -607,6 +619,86 @@ void CommandLineFrontend::listProducts()
     qbsInfo() << output.join(QLatin1Char('\n'));
 }
 
+static QString formatResourceValue(qint64 value, qint64 divisor, const char *unit)
+{
+    if (value < 0)
+        return QStringLiteral("-");
+    return QStringLiteral("%1 %2").arg(double(value) / divisor, 0, 'f', 1)
+            .arg(QLatin1String(unit));
+}
+
+void CommandLineFrontend::listResourceUsage()
+{
+    const Project &project = m_projects.front();
+    const QList<ProductData> products = productsToUse().value(project);
+    ErrorInfo error;
+    const ProjectTransformerData projectTransformerData = project.transformerData(&error);
+    if (error.hasError())
+        throw error;
+
+    struct Entry {
+        QString productName;
+        TransformerData transformerData;
+        qint64 cpuTime;
+    };
+    std::vector<Entry> entries;
+    for (const auto &productTransformerData : projectTransformerData) {
+        if (!products.contains(productTransformerData.first))
+            continue;
+        for (const TransformerData &t : productTransformerData.second) {
+            if (t.userTime() < 0 && t.systemTime() < 0)
+                continue;
+            entries.push_back({productTransformerData.first.fullDisplayName(), t,
+                               std::max<qint64>(t.userTime(), 0)
+                               + std::max<qint64>(t.systemTime(), 0)});
+        }
+    }
+    const auto topCount = std::min<size_t>(m_parser.topCount(), entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + topCount, entries.end(),
+                      [](const Entry &e1, const Entry &e2) { return e1.cpuTime > e2.cpuTime; });
+    entries.resize(topCount);
+
+    if (entries.empty()) {
+        qbsInfo() << Tr::tr("No resource usage has been recorded. "
+                            "Commands need to be run by a build first.");
+        return;
+    }
+    qbsInfo() << Tr::tr("%1 %2 %3 %4  %5").arg(Tr::tr("CPU time"), 10)
+                 .arg(Tr::tr("Peak memory"), 12).arg(Tr::tr("Read"), 10)
+                 .arg(Tr::tr("Written"), 10).arg(Tr::tr("Command"));
+    for (const Entry &e : entries) {
+        QStringList descriptions;
+        const auto commands = e.transformerData.commands();
+        for (const RuleCommand &command : commands) {
+            descriptions << (command.description().isEmpty()
+                             ? command.executable() : command.description());
+        }
+        qbsInfo() << QStringLiteral("%1 %2 %3 %4  %5")
+                     .arg(formatResourceValue(e.cpuTime, 1000, "s"), 10)
+                     .arg(formatResourceValue(e.transformerData.peakMemoryUsage(),
+                                              1024 * 1024, "MiB"), 12)
+                     .arg(formatResourceValue(e.transformerData.bytesRead(), 1024 * 1024, "MiB"),
+                          10)
+                     .arg(formatResourceValue(e.transformerData.bytesWritten(), 1024 * 1024,
+                                              "MiB"), 10)
+                     .arg(QStringLiteral("[%1] %2").arg(e.productName,
+                                                        descriptions.join(QLatin1String("; "))));
+    }
+}
+
+void CommandLineFrontend::queryBuildGraph()
+{
+    ErrorInfo error;
+    const QStringList results = m_projects.front().queryBuildGraph(
+                m_parser.queryName(), m_parser.queryArguments(), &error);
+    if (error.hasError())
+        throw error;
+    if (results.isEmpty())
+        qbsInfo() << Tr::tr("No results.");
+    else
+        qbsInfo() << results.join(QLatin1Char('\n'));
+}
+
 void CommandLineFrontend::connectBuildJobs()
 {
     for (AbstractJob * const job : qAsConst(m_buildJobs))
@@ -97,6 +97,8 @@ private:
     void updateTimestamps();
     void dumpNodesTree();
     void listProducts();
+    void listResourceUsage();
+    void queryBuildGraph();
     void connectBuildJobs();
     void connectBuildJob(AbstractJob *job);
     void connectJob(AbstractJob *job);
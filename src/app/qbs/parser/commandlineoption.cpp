@@ -522,6 +522,20 @@ QString NoBuildOption::longRepresentation() const
 }
 
 
+QString UninstallOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1\n\tRemove the files that were previously installed, instead of installing.\n"
+                  "\tThe project is not built.\n")
+            .arg(longRepresentation());
+}
+
+QString UninstallOption::longRepresentation() const
+{
+    return QStringLiteral("--uninstall");
+}
+
+
 QString LogTimeOption::description(CommandType command) const
 {
     Q_UNUSED(command);
@@ -611,6 +625,56 @@ void JobLimitsOption::doParse(const QString &representation, QStringList &input)
     }
 }
 
+QString MemoryBudgetOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <n>\n"
+                  "\tDo not start new build jobs if the memory they are expected to use\n"
+                  "\twould exceed <n> MiB. <n> must be an integer greater than zero.\n"
+                  "\tThe expectation is based on what a command used in earlier builds.\n")
+            .arg(longRepresentation());
+}
+
+QString MemoryBudgetOption::longRepresentation() const
+{
+    return QStringLiteral("--memory-budget");
+}
+
+void MemoryBudgetOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString budgetString = getArgument(representation, input);
+    bool stringOk;
+    m_memoryBudget = budgetString.toInt(&stringOk);
+    if (!stringOk || m_memoryBudget <= 0)
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal memory budget '%2'.\n"
+                               "Usage: %3")
+                    .arg(representation, budgetString, description(command())));
+}
+
+QString TopCountOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <n>\n"
+                  "\tShow at most <n> entries. The default is 10.\n")
+            .arg(longRepresentation());
+}
+
+QString TopCountOption::longRepresentation() const
+{
+    return QStringLiteral("--top");
+}
+
+void TopCountOption::doParse(const QString &representation, QStringList &input)
+{
+    const QString countString = getArgument(representation, input);
+    bool stringOk;
+    m_topCount = countString.toInt(&stringOk);
+    if (!stringOk || m_topCount <= 0)
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': Illegal count '%2'.\n"
+                               "Usage: %3")
+                    .arg(representation, countString, description(command())));
+}
+
 QString RespectProjectJobLimitsOption::description(CommandType command) const
 {
     Q_UNUSED(command);
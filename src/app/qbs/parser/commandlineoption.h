@@ -64,6 +64,7 @@ public:
         ProductsOptionType,
         NoInstallOptionType,
         InstallRootOptionType, RemoveFirstOptionType, NoBuildOptionType,
+        UninstallOptionType,
         ForceTimestampCheckOptionType,
         ForceOutputCheckOptionType,
         BuildNonDefaultOptionType,
@@ -72,10 +73,12 @@ public:
         SettingsDirOptionType,
         JobLimitsOptionType,
         RespectProjectJobLimitsOptionType,
+        MemoryBudgetOptionType,
         GeneratorOptionType,
         WaitLockOptionType,
         RunEnvConfigOptionType,
         DisableFallbackProviderType,
+        TopCountOptionType,
     };
 
     virtual ~CommandLineOption();
@@ -343,6 +346,14 @@ public:
     QString longRepresentation() const override;
 };
 
+class UninstallOption : public OnOffOption
+{
+public:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return {}; }
+    QString longRepresentation() const override;
+};
+
 class LogTimeOption : public OnOffOption
 {
 public:
@@ -399,6 +410,36 @@ private:
     JobLimits m_jobLimits;
 };
 
+class MemoryBudgetOption : public CommandLineOption
+{
+public:
+    int memoryBudget() const { return m_memoryBudget; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return {}; }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    int m_memoryBudget = 0;
+};
+
+class TopCountOption : public CommandLineOption
+{
+public:
+    int topCount() const { return m_topCount; }
+
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return {}; }
+    QString longRepresentation() const override;
+
+private:
+    void doParse(const QString &representation, QStringList &input) override;
+
+    int m_topCount = 10;
+};
+
 class RespectProjectJobLimitsOption : public OnOffOption
 {
 public:
@@ -98,6 +98,9 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::NoBuildOptionType:
             option = new NoBuildOption;
             break;
+        case CommandLineOption::UninstallOptionType:
+            option = new UninstallOption;
+            break;
         case CommandLineOption::ForceTimestampCheckOptionType:
             option = new ForceTimeStampCheckOption;
             break;
@@ -122,6 +125,12 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::RespectProjectJobLimitsOptionType:
             option = new RespectProjectJobLimitsOption;
             break;
+        case CommandLineOption::MemoryBudgetOptionType:
+            option = new MemoryBudgetOption;
+            break;
+        case CommandLineOption::TopCountOptionType:
+            option = new TopCountOption;
+            break;
         case CommandLineOption::GeneratorOptionType:
             option = new GeneratorOption;
             break;
@@ -221,6 +230,11 @@ NoBuildOption *CommandLineOptionPool::noBuildOption() const
     return static_cast<NoBuildOption *>(getOption(CommandLineOption::NoBuildOptionType));
 }
 
+UninstallOption *CommandLineOptionPool::uninstallOption() const
+{
+    return static_cast<UninstallOption *>(getOption(CommandLineOption::UninstallOptionType));
+}
+
 ForceTimeStampCheckOption *CommandLineOptionPool::forceTimestampCheckOption() const
 {
     return static_cast<ForceTimeStampCheckOption *>(
@@ -260,6 +274,16 @@ JobLimitsOption *CommandLineOptionPool::jobLimitsOption() const
     return static_cast<JobLimitsOption *>(getOption(CommandLineOption::JobLimitsOptionType));
 }
 
+MemoryBudgetOption *CommandLineOptionPool::memoryBudgetOption() const
+{
+    return static_cast<MemoryBudgetOption *>(getOption(CommandLineOption::MemoryBudgetOptionType));
+}
+
+TopCountOption *CommandLineOptionPool::topCountOption() const
+{
+    return static_cast<TopCountOption *>(getOption(CommandLineOption::TopCountOptionType));
+}
+
 RespectProjectJobLimitsOption *CommandLineOptionPool::respectProjectJobLimitsOption() const
 {
     return static_cast<RespectProjectJobLimitsOption *>(
@@ -67,6 +67,7 @@ public:
     InstallRootOption *installRootOption() const;
     RemoveFirstOption *removeFirstoption() const;
     NoBuildOption *noBuildOption() const;
+    UninstallOption *uninstallOption() const;
     ForceTimeStampCheckOption *forceTimestampCheckOption() const;
     ForceOutputCheckOption *forceOutputCheckOption() const;
     BuildNonDefaultOption *buildNonDefaultOption() const;
@@ -75,6 +76,8 @@ public:
     SettingsDirOption *settingsDirOption() const;
     JobLimitsOption *jobLimitsOption() const;
     RespectProjectJobLimitsOption *respectProjectJobLimitsOption() const;
+    MemoryBudgetOption *memoryBudgetOption() const;
+    TopCountOption *topCountOption() const;
     GeneratorOption *generatorOption() const;
     WaitLockOption *waitLockOption() const;
     DisableFallbackProviderOption *disableFallbackProviderOption() const;
@@ -188,6 +188,7 @@ InstallOptions CommandLineParser::installOptions(const QString &profile) const
 {
     InstallOptions options;
     options.setRemoveExistingInstallation(d->optionPool.removeFirstoption()->enabled());
+    options.setUninstall(d->optionPool.uninstallOption()->enabled());
     options.setInstallRoot(d->optionPool.installRootOption()->installRoot());
     options.setInstallIntoSysroot(d->optionPool.installRootOption()->useSysroot());
     if (!options.installRoot().isEmpty()) {
@@ -243,7 +244,8 @@ bool CommandLineParser::withNonDefaultProducts() const
 
 bool CommandLineParser::buildBeforeInstalling() const
 {
-    return !d->optionPool.noBuildOption()->enabled();
+    return !d->optionPool.noBuildOption()->enabled()
+            && !d->optionPool.uninstallOption()->enabled();
 }
 
 QStringList CommandLineParser::runArgs() const
@@ -262,6 +264,23 @@ QStringList CommandLineParser::runEnvConfig() const
     return d->optionPool.runEnvConfigOption()->arguments();
 }
 
+int CommandLineParser::topCount() const
+{
+    return d->optionPool.topCountOption()->topCount();
+}
+
+QString CommandLineParser::queryName() const
+{
+    Q_ASSERT(d->command->type() == QueryCommandType);
+    return static_cast<QueryCommand *>(d->command)->queryName();
+}
+
+QStringList CommandLineParser::queryArguments() const
+{
+    Q_ASSERT(d->command->type() == QueryCommandType);
+    return static_cast<QueryCommand *>(d->command)->queryArguments();
+}
+
 bool CommandLineParser::showProgress() const
 {
     return d->showProgress;
@@ -344,6 +363,8 @@ void CommandLineParser::CommandLineParserPrivate::doParse()
         }
     }
     command->parse(commandLine);
+    if (command->type() == QueryCommandType)
+        static_cast<QueryCommand *>(command)->checkQueryGiven();
 
     if (command->type() == HelpCommandType || command->type() == VersionCommandType)
         return;
@@ -379,6 +400,8 @@ QList<Command *> CommandLineParser::CommandLineParserPrivate::allCommands() cons
             commandPool.getCommand(InstallCommandType),
             commandPool.getCommand(DumpNodesTreeCommandType),
             commandPool.getCommand(ListProductsCommandType),
+            commandPool.getCommand(ResourceUsageCommandType),
+            commandPool.getCommand(QueryCommandType),
             commandPool.getCommand(VersionCommandType),
             commandPool.getCommand(SessionCommandType),
             commandPool.getCommand(HelpCommandType)};
@@ -464,6 +487,7 @@ void CommandLineParser::CommandLineParserPrivate::setupBuildOptions()
     buildOptions.setJobLimits(optionPool.jobLimitsOption()->jobLimits());
     buildOptions.setProjectJobLimitsTakePrecedence(
                 optionPool.respectProjectJobLimitsOption()->enabled());
+    buildOptions.setMemoryBudget(optionPool.memoryBudgetOption()->memoryBudget());
     buildOptions.setSettingsDirectory(settingsDir());
 }
 
@@ -85,6 +85,9 @@ public:
     QStringList runArgs() const;
     QStringList products() const;
     QStringList runEnvConfig() const;
+    int topCount() const;
+    QString queryName() const;
+    QStringList queryArguments() const;
     QList<QVariantMap> buildConfigurations() const;
     bool showProgress() const;
     bool showVersion() const;
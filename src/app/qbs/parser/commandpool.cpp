@@ -89,6 +89,12 @@ qbs::Command *CommandPool::getCommand(CommandType type) const
         case ListProductsCommandType:
             command = new ListProductsCommand(m_optionPool);
             break;
+        case ResourceUsageCommandType:
+            command = new ResourceUsageCommand(m_optionPool);
+            break;
+        case QueryCommandType:
+            command = new QueryCommand(m_optionPool);
+            break;
         case HelpCommandType:
             command = new HelpCommand(m_optionPool);
             break;
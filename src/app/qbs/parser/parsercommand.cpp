@@ -48,6 +48,8 @@
 #include <tools/stlutils.h>
 #include <tools/qttools.h>
 
+#include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qmap.h>
 
 namespace qbs {
@@ -284,6 +286,7 @@ static QList<CommandLineOption::Type> buildOptions()
             << CommandLineOption::RemoveFirstOptionType
             << CommandLineOption::JobLimitsOptionType
             << CommandLineOption::RespectProjectJobLimitsOptionType
+            << CommandLineOption::MemoryBudgetOptionType
             << CommandLineOption::WaitLockOptionType;
 }
 
@@ -357,7 +360,7 @@ QList<CommandLineOption::Type> installOptions()
 
 QList<CommandLineOption::Type> InstallCommand::supportedOptions() const
 {
-    return installOptions();
+    return installOptions() << CommandLineOption::UninstallOptionType;
 }
 
 QString RunCommand::shortDescription() const
@@ -532,6 +535,94 @@ QList<CommandLineOption::Type> ListProductsCommand::supportedOptions() const
             CommandLineOption::BuildDirectoryOptionType};
 }
 
+QString ResourceUsageCommand::shortDescription() const
+{
+    return Tr::tr("Lists the commands that were most expensive in the last build.");
+}
+
+QString ResourceUsageCommand::longDescription() const
+{
+    QString description = Tr::tr("qbs %1 [options] [config:<configuration-name>]\n")
+            .arg(representation());
+    description += Tr::tr("Lists the commands with the highest CPU time, together with their "
+                          "peak memory usage and I/O, as recorded the last time they were run.\n");
+    return description += supportedOptionsDescription();
+}
+
+QString ResourceUsageCommand::representation() const
+{
+    return QStringLiteral("resource-usage");
+}
+
+QList<CommandLineOption::Type> ResourceUsageCommand::supportedOptions() const
+{
+    return {CommandLineOption::BuildDirectoryOptionType,
+            CommandLineOption::ProductsOptionType,
+            CommandLineOption::TopCountOptionType};
+}
+
+QString QueryCommand::shortDescription() const
+{
+    return Tr::tr("Answers questions about the build graph.");
+}
+
+QString QueryCommand::longDescription() const
+{
+    QString description = Tr::tr("qbs %1 [options] [config:<configuration-name>] "
+                                 "<query> <argument> ...\n").arg(representation());
+    description += Tr::tr("Answers questions about the build graph. The possible queries are:\n");
+    description += Tr::tr("\treverse-dependencies <file>\n"
+                          "\t\tLists the generated files that depend on <file>.\n");
+    description += Tr::tr("\tdependency-path <from> <to>\n"
+                          "\t\tShows a chain of dependencies leading from <from> to <to>.\n");
+    description += Tr::tr("\tout-of-date-reasons <file>\n"
+                          "\t\tShows why the next build would or might re-generate <file>.\n");
+    description += Tr::tr("\tproperty-users <property>\n"
+                          "\t\tLists the outputs of the rules that use <property>, which is "
+                          "given as\n\t\t<module>.<name>, product.<name> or project.<name>.\n");
+    return description += supportedOptionsDescription();
+}
+
+QString QueryCommand::representation() const
+{
+    return QStringLiteral("query");
+}
+
+QList<CommandLineOption::Type> QueryCommand::supportedOptions() const
+{
+    return {CommandLineOption::BuildDirectoryOptionType,
+            CommandLineOption::LogLevelOptionType,
+            CommandLineOption::VerboseOptionType,
+            CommandLineOption::QuietOptionType};
+}
+
+void QueryCommand::parseNext(QStringList &input)
+{
+    QBS_CHECK(!input.empty());
+    if (input.front().startsWith(QLatin1Char('-'))
+            || input.front().startsWith(QLatin1String("config:"))) {
+        Command::parseNext(input);
+        return;
+    }
+    if (m_queryName.isEmpty()) {
+        m_queryName = input.takeFirst();
+        return;
+    }
+
+    // Everything but property names is a file path, which may be given relative to the
+    // current directory.
+    QString argument = input.takeFirst();
+    if (m_queryName != QLatin1String("property-users"))
+        argument = QDir::cleanPath(QFileInfo(argument).absoluteFilePath());
+    m_queryArguments << argument;
+}
+
+void QueryCommand::checkQueryGiven()
+{
+    if (m_queryName.isEmpty())
+        throwError(Tr::tr("No query given."));
+}
+
 QString HelpCommand::shortDescription() const
 {
     return Tr::tr("Show general or command-specific help.");
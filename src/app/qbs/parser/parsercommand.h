@@ -217,6 +217,39 @@ private:
     QList<CommandLineOption::Type> supportedOptions() const override;
 };
 
+class ResourceUsageCommand : public Command
+{
+public:
+    ResourceUsageCommand(CommandLineOptionPool &optionPool) : Command(optionPool) {}
+
+private:
+    CommandType type() const override { return ResourceUsageCommandType; }
+    QString shortDescription() const override;
+    QString longDescription() const override;
+    QString representation() const override;
+    QList<CommandLineOption::Type> supportedOptions() const override;
+};
+
+class QueryCommand : public Command
+{
+public:
+    QueryCommand(CommandLineOptionPool &optionPool) : Command(optionPool) {}
+    QString queryName() const { return m_queryName; }
+    QStringList queryArguments() const { return m_queryArguments; }
+    void checkQueryGiven();
+
+private:
+    CommandType type() const override { return QueryCommandType; }
+    QString shortDescription() const override;
+    QString longDescription() const override;
+    QString representation() const override;
+    QList<CommandLineOption::Type> supportedOptions() const override;
+    void parseNext(QStringList &input) override;
+
+    QString m_queryName;
+    QStringList m_queryArguments;
+};
+
 class ListProductsCommand : public Command
 {
 public:
@@ -0,0 +1,223 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "projectdatadelta.h"
+
+#include <tools/stringconstants.h>
+
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonvalue.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+using JsonObjectMap = QHash<QString, QJsonObject>;
+
+// Replaces the products in the project tree by their ids and collects them in a flat map.
+static QJsonObject splitProjectData(const QJsonObject &projectData, JsonObjectMap &products)
+{
+    QJsonObject structure = projectData;
+    QJsonArray productIds;
+    const QJsonArray productArray = projectData.value(StringConstants::productsKey()).toArray();
+    for (const QJsonValue &v : productArray) {
+        const QJsonObject product = v.toObject();
+        const QString id = product.value(StringConstants::fullDisplayNameKey()).toString();
+        products.insert(id, product);
+        productIds.push_back(id);
+    }
+    structure.insert(StringConstants::productsKey(), productIds);
+    QJsonArray subProjects;
+    const QJsonArray subProjectArray = projectData.value(QLatin1String("sub-projects")).toArray();
+    for (const QJsonValue &v : subProjectArray)
+        subProjects.push_back(splitProjectData(v.toObject(), products));
+    structure.insert(QLatin1String("sub-projects"), subProjects);
+    return structure;
+}
+
+// Brings the elements of a delta list into a fixed order, so that it does not depend on
+// the iteration order of hashes. The elements are either objects or plain ids.
+static QJsonArray sortedById(const QJsonArray &array, const QString &idKey)
+{
+    const auto id = [&idKey](const QJsonValue &v) {
+        return v.isString() ? v.toString() : v.toObject().value(idKey).toString();
+    };
+    std::vector<QJsonValue> values(array.begin(), array.end());
+    std::sort(values.begin(), values.end(), [&id](const QJsonValue &v1, const QJsonValue &v2) {
+        return id(v1) < id(v2);
+    });
+    QJsonArray sortedArray;
+    for (const QJsonValue &v : values)
+        sortedArray.push_back(v);
+    return sortedArray;
+}
+
+static void insertSortedList(QJsonObject &delta, const QString &key, const QJsonArray &list,
+                             const QString &idKey)
+{
+    if (!list.isEmpty())
+        delta.insert(key, sortedById(list, idKey));
+}
+
+static bool mapArray(const QJsonArray &array, const QString &idKey, JsonObjectMap &map)
+{
+    for (const QJsonValue &v : array) {
+        const QJsonObject obj = v.toObject();
+        const QString id = obj.value(idKey).toString();
+        if (map.contains(id))
+            return false;
+        map.insert(id, obj);
+    }
+    return true;
+}
+
+// Inserts the elements of the list-valued property listKey that were added, removed
+// or changed. Elements without a unique id make the whole list part of the delta.
+static void insertListDelta(QJsonObject &delta, const QJsonObject &oldObject,
+                            const QJsonObject &newObject, const QString &listKey,
+                            const QString &idKey)
+{
+    const QJsonArray oldArray = oldObject.value(listKey).toArray();
+    const QJsonArray newArray = newObject.value(listKey).toArray();
+    if (oldArray == newArray)
+        return;
+    JsonObjectMap oldElements;
+    JsonObjectMap newElements;
+    if (!mapArray(oldArray, idKey, oldElements) || !mapArray(newArray, idKey, newElements)) {
+        delta.insert(listKey, newArray);
+        return;
+    }
+    QJsonArray added;
+    QJsonArray changed;
+    QJsonArray removed;
+    for (const QJsonValue &v : newArray) {
+        const QJsonObject newElement = v.toObject();
+        const auto it = oldElements.constFind(newElement.value(idKey).toString());
+        if (it == oldElements.constEnd())
+            added.push_back(newElement);
+        else if (it.value() != newElement)
+            changed.push_back(newElement);
+    }
+    for (const QJsonValue &v : oldArray) {
+        const QString id = v.toObject().value(idKey).toString();
+        if (!newElements.contains(id))
+            removed.push_back(id);
+    }
+    insertSortedList(delta, QLatin1String("added-") + listKey, added, idKey);
+    insertSortedList(delta, QLatin1String("changed-") + listKey, changed, idKey);
+    insertSortedList(delta, QLatin1String("removed-") + listKey, removed, idKey);
+}
+
+static QJsonObject productDelta(const QJsonObject &oldProduct, const QJsonObject &newProduct)
+{
+    static const QString groupsKey = QStringLiteral("groups");
+    static const QString generatedArtifactsKey = QStringLiteral("generated-artifacts");
+    QJsonObject delta;
+    for (auto it = newProduct.constBegin(); it != newProduct.constEnd(); ++it) {
+        if (it.key() == groupsKey || it.key() == generatedArtifactsKey)
+            continue;
+        if (oldProduct.value(it.key()) != it.value())
+            delta.insert(it.key(), it.value());
+    }
+    for (auto it = oldProduct.constBegin(); it != oldProduct.constEnd(); ++it) {
+        if (!newProduct.contains(it.key()))
+            delta.insert(it.key(), QJsonValue::Null);
+    }
+    insertListDelta(delta, oldProduct, newProduct, groupsKey, StringConstants::nameProperty());
+    insertListDelta(delta, oldProduct, newProduct, generatedArtifactsKey,
+                    StringConstants::filePathKey());
+    if (!delta.isEmpty()) {
+        delta.insert(StringConstants::fullDisplayNameKey(),
+                     newProduct.value(StringConstants::fullDisplayNameKey()));
+    }
+    return delta;
+}
+
+QJsonObject ProjectDataDelta::update(const QJsonObject &projectData)
+{
+    JsonObjectMap products;
+    const QJsonObject structure = splitProjectData(projectData, products);
+    QJsonObject delta;
+    if (!m_hasBase || structure != m_projectStructure)
+        delta.insert(QLatin1String("project"), structure);
+    QJsonArray added;
+    QJsonArray changed;
+    QJsonArray removed;
+    for (auto it = products.constBegin(); it != products.constEnd(); ++it) {
+        const auto oldIt = m_products.constFind(it.key());
+        if (oldIt == m_products.constEnd()) {
+            added.push_back(it.value());
+            continue;
+        }
+        const QJsonObject d = productDelta(oldIt.value(), it.value());
+        if (!d.isEmpty())
+            changed.push_back(d);
+    }
+    for (auto it = m_products.constBegin(); it != m_products.constEnd(); ++it) {
+        if (!products.contains(it.key()))
+            removed.push_back(it.key());
+    }
+    const QString &idKey = StringConstants::fullDisplayNameKey();
+    insertSortedList(delta, QLatin1String("added-products"), added, idKey);
+    insertSortedList(delta, QLatin1String("changed-products"), changed, idKey);
+    insertSortedList(delta, QLatin1String("removed-products"), removed, idKey);
+    m_hasBase = true;
+    m_projectStructure = structure;
+    m_products = std::move(products);
+    return delta;
+}
+
+void ProjectDataDelta::setBase(const QJsonObject &projectData)
+{
+    m_products.clear();
+    m_projectStructure = splitProjectData(projectData, m_products);
+    m_hasBase = true;
+}
+
+void ProjectDataDelta::reset()
+{
+    m_hasBase = false;
+    m_projectStructure = QJsonObject();
+    m_products.clear();
+}
+
+} // namespace Internal
+} // namespace qbs
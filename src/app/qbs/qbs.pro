@@ -6,9 +6,11 @@ TARGET = qbs
 SOURCES += main.cpp \
     ctrlchandler.cpp \
     application.cpp \
+    projectdatadelta.cpp \
     session.cpp \
     sessionpacket.cpp \
     sessionpacketreader.cpp \
+    sourcefilewatcher.cpp \
     stdinreader.cpp \
     status.cpp \
     consoleprogressobserver.cpp \
@@ -18,9 +20,11 @@ SOURCES += main.cpp \
 HEADERS += \
     ctrlchandler.h \
     application.h \
+    projectdatadelta.h \
     session.h \
     sessionpacket.h \
     sessionpacketreader.h \
+    sourcefilewatcher.h \
     stdinreader.h \
     status.h \
     consoleprogressobserver.h \
@@ -39,8 +39,10 @@
 
 #include "session.h"
 
+#include "projectdatadelta.h"
 #include "sessionpacket.h"
 #include "sessionpacketreader.h"
+#include "sourcefilewatcher.h"
 
 #include <api/jobs.h>
 #include <api/project.h>
@@ -114,7 +116,7 @@ public:
     Session();
 
 private:
-    enum class ProjectDataMode { Never, Always, OnlyIfChanged };
+    enum class ProjectDataMode { Never, Always, OnlyIfChanged, Delta };
     ProjectDataMode dataModeFromRequest(const QJsonObject &request);
     QStringList modulePropertiesFromRequest(const QJsonObject &request);
     void insertProjectDataIfNecessary(
@@ -123,7 +125,10 @@ private:
             const ProjectData &oldProjectData,
             bool includeTopLevelData
             );
+    QJsonObject projectDataToJson(bool includeTopLevelData) const;
+    void insertTopLevelData(QJsonObject &projectData) const;
     void setLogLevelFromRequest(const QJsonObject &request);
+    void updateSourceFileWatcher(bool watch);
     bool checkNormalRequestPrerequisites(const char *replyType);
 
     void sendPacket(const QJsonObject &message);
@@ -135,6 +140,7 @@ private:
     void removeFiles(const QJsonObject &request);
     void getRunEnvironment(const QJsonObject &request);
     void getGeneratedFilesForSources(const QJsonObject &request);
+    void queryBuildGraph(const QJsonObject &request);
     void releaseProject();
     void cancelCurrentJob();
     void quitSession();
@@ -168,6 +174,9 @@ private:
     SessionPacketReader m_packetReader;
     Project m_project;
     ProjectData m_projectData;
+    ProjectDataDelta m_projectDataDelta;
+    bool m_sendProjectDataDeltas = false;
+    std::unique_ptr<SourceFileWatcher> m_sourceFileWatcher;
     SessionLogSink m_logSink;
     std::unique_ptr<Settings> m_settings;
     QJsonObject m_resolveRequest;
@@ -219,6 +228,8 @@ Session::Session()
             getRunEnvironment(packet);
         else if (type == QLatin1String("get-generated-files-for-sources"))
             getGeneratedFilesForSources(packet);
+        else if (type == QLatin1String("query-build-graph"))
+            queryBuildGraph(packet);
         else if (type == QLatin1String("release-project"))
             releaseProject();
         else if (type == QLatin1String("quit"))
@@ -238,12 +249,15 @@ Session::ProjectDataMode Session::dataModeFromRequest(const QJsonObject &request
         return ProjectDataMode::OnlyIfChanged;
     if (modeString == QLatin1String("always"))
         return ProjectDataMode::Always;
+    if (modeString == QLatin1String("delta"))
+        return ProjectDataMode::Delta;
     return ProjectDataMode::Never;
 }
 
 void Session::sendPacket(const QJsonObject &message)
 {
-    std::cout << SessionPacket::createPacket(message).constData() << std::flush;
+    const QByteArray packet = SessionPacket::createPacket(message, m_packetReader.encoding());
+    std::cout.write(packet.constData(), packet.size()) << std::flush;
 }
 
 void Session::setupProject(const QJsonObject &request)
@@ -261,6 +275,7 @@ void Session::setupProject(const QJsonObject &request)
     m_moduleProperties = modulePropertiesFromRequest(request);
     auto params = SetupProjectParameters::fromJson(request);
     const ProjectDataMode dataMode = dataModeFromRequest(request);
+    const bool watchSourceFiles = request.value(QLatin1String("watch-source-files")).toBool();
     m_settings = std::make_unique<Settings>(params.settingsDirectory());
     const Preferences prefs(m_settings.get());
     const QString appDir = QDir::cleanPath(QCoreApplication::applicationDirPath());
@@ -275,7 +290,7 @@ void Session::setupProject(const QJsonObject &request)
     m_currentJob = setupJob;
     connectProgressSignals(setupJob);
     connect(setupJob, &AbstractJob::finished, this,
-            [this, setupJob, dataMode](bool success) {
+            [this, setupJob, dataMode, watchSourceFiles](bool success) {
         if (!m_resolveRequest.isEmpty()) { // Canceled job was superseded.
             const QJsonObject newRequest = std::move(m_resolveRequest);
             m_resolveRequest = QJsonObject();
@@ -287,6 +302,8 @@ void Session::setupProject(const QJsonObject &request)
         const ProjectData oldProjectData = m_projectData;
         m_project = setupJob->project();
         m_projectData = m_project.projectData();
+        if (success)
+            updateSourceFileWatcher(watchSourceFiles);
         QJsonObject reply;
         reply.insert(StringConstants::type(), QLatin1String("project-resolved"));
         if (success)
@@ -307,6 +324,14 @@ void Session::buildProject(const QJsonObject &request)
     setLogLevelFromRequest(request);
     auto options = BuildOptions::fromJson(request);
     options.setSettingsDirectory(m_settings->baseDirectory());
+    QStringList changedFiles;
+    const bool useSourceFileWatcher = m_sourceFileWatcher && m_sourceFileWatcher->isComplete()
+            && !request.contains(QLatin1String("changed-files"));
+    if (useSourceFileWatcher && m_sourceFileWatcher->initialCheckDone()) {
+        changedFiles = m_sourceFileWatcher->takeChangedFiles();
+        options.setChangedFiles(changedFiles);
+        options.setChangedFilesComplete(true);
+    }
     BuildJob * const buildJob = productSelection.products.empty()
             ? m_project.buildAllProducts(options, productSelection.selection, this)
             : m_project.buildSomeProducts(productSelection.products, options, this);
@@ -322,6 +347,11 @@ void Session::buildProject(const QJsonObject &request)
         descData.insert(StringConstants::messageKey(), message);
         sendPacket(descData);
     });
+    connect(buildJob, &BuildJob::reportProcessOutput, this, [this](const ProcessResult &result) {
+        QJsonObject outputData = result.toJson();
+        outputData.insert(StringConstants::type(), QLatin1String("process-output"));
+        sendPacket(outputData);
+    });
     connect(buildJob, &BuildJob::reportProcessResult, this, [this](const ProcessResult &result) {
         if (result.success() && result.stdOut().isEmpty() && result.stdErr().isEmpty())
             return;
@@ -330,7 +360,14 @@ void Session::buildProject(const QJsonObject &request)
         sendPacket(resultData);
     });
     connect(buildJob, &BuildJob::finished, this,
-            [this, dataMode](bool success) {
+            [this, dataMode, useSourceFileWatcher, changedFiles](bool success) {
+        if (useSourceFileWatcher && m_sourceFileWatcher) {
+            // Changed files might not have been looked at if the build did not get far.
+            if (!success)
+                m_sourceFileWatcher->addChangedFiles(changedFiles);
+            else if (!m_sourceFileWatcher->initialCheckDone())
+                m_sourceFileWatcher->setInitialCheckDone();
+        }
         QJsonObject reply;
         reply.insert(StringConstants::type(), QLatin1String("project-built"));
         const ProjectData oldProjectData = m_projectData;
@@ -412,9 +449,14 @@ void Session::addFiles(const QJsonObject &request)
     insertErrorInfoIfNecessary(reply, error);
 
     if (failedFiles.size() != data.filePaths.size()) {
+        if (m_sourceFileWatcher)
+            updateSourceFileWatcher(true);
+
         // Note that Project::addFiles() directly changes the existing project data object, so
         // there's no need to retrieve it from m_project.
-        insertProjectDataIfNecessary(reply, ProjectDataMode::Always, {}, false);
+        insertProjectDataIfNecessary(reply, m_sendProjectDataDeltas ? ProjectDataMode::Delta
+                                                                    : ProjectDataMode::Always,
+                                     {}, false);
     }
 
     if (!failedFiles.isEmpty())
@@ -444,8 +486,13 @@ void Session::removeFiles(const QJsonObject &request)
     QJsonObject reply;
     reply.insert(StringConstants::type(), QLatin1String("files-removed"));
     insertErrorInfoIfNecessary(reply, error);
-    if (failedFiles.size() != data.filePaths.size())
-        insertProjectDataIfNecessary(reply, ProjectDataMode::Always, {}, false);
+    if (failedFiles.size() != data.filePaths.size()) {
+        if (m_sourceFileWatcher)
+            updateSourceFileWatcher(true);
+        insertProjectDataIfNecessary(reply, m_sendProjectDataDeltas ? ProjectDataMode::Delta
+                                                                    : ProjectDataMode::Always,
+                                     {}, false);
+    }
     if (!failedFiles.isEmpty())
         reply.insert(QLatin1String("failed-files"), QJsonArray::fromStringList(failedFiles));
     sendPacket(reply);
@@ -588,6 +635,25 @@ void Session::getGeneratedFilesForSources(const QJsonObject &request)
     sendPacket(reply);
 }
 
+void Session::queryBuildGraph(const QJsonObject &request)
+{
+    const char * const replyType = "build-graph-query-result";
+    if (!checkNormalRequestPrerequisites(replyType))
+        return;
+    ErrorInfo error;
+    const QStringList results = m_project.queryBuildGraph(
+                request.value(QLatin1String("query")).toString(),
+                fromJson<QStringList>(request.value(QLatin1String("arguments"))), &error);
+    if (error.hasError()) {
+        sendErrorReply(replyType, error);
+        return;
+    }
+    QJsonObject reply;
+    reply.insert(StringConstants::type(), QLatin1String(replyType));
+    reply.insert(QLatin1String("results"), QJsonArray::fromStringList(results));
+    sendPacket(reply);
+}
+
 void Session::releaseProject()
 {
     const char * const replyType = "project-released";
@@ -602,6 +668,8 @@ void Session::releaseProject()
     }
     m_project = Project();
     m_projectData = ProjectData();
+    m_projectDataDelta.reset();
+    m_sourceFileWatcher.reset();
     m_resolveRequest = QJsonObject();
     QJsonObject reply;
     reply.insert(StringConstants::type(), QLatin1String(replyType));
@@ -658,25 +726,51 @@ Session::FileUpdateData Session::prepareFileUpdate(const QJsonObject &request)
 void Session::insertProjectDataIfNecessary(QJsonObject &reply, ProjectDataMode dataMode,
         const ProjectData &oldProjectData, bool includeTopLevelData)
 {
+    if (dataMode != ProjectDataMode::Never)
+        m_sendProjectDataDeltas = dataMode == ProjectDataMode::Delta;
+    if (dataMode == ProjectDataMode::Delta) {
+        // The top-level data is always included, so it does not show up as a change
+        // after a build.
+        const QJsonObject delta = m_projectDataDelta.update(projectDataToJson(true));
+        if (!delta.isEmpty())
+            reply.insert(QLatin1String("project-data-delta"), delta);
+        return;
+    }
     const bool sendProjectData = dataMode == ProjectDataMode::Always
             || (dataMode == ProjectDataMode::OnlyIfChanged && m_projectData != oldProjectData);
     if (!sendProjectData)
         return;
+    // Deltas always compare the top-level data as well, so the base must contain it,
+    // even if the client does not get to see it.
+    const QJsonObject projectData = projectDataToJson(false);
+    QJsonObject fullProjectData = projectData;
+    insertTopLevelData(fullProjectData);
+    m_projectDataDelta.setBase(fullProjectData);
+    reply.insert(QLatin1String("project-data"),
+                 includeTopLevelData ? fullProjectData : projectData);
+}
+
+QJsonObject Session::projectDataToJson(bool includeTopLevelData) const
+{
     QJsonObject projectData = m_projectData.toJson(m_moduleProperties);
-    if (includeTopLevelData) {
-        QJsonArray buildSystemFiles;
-        for (const QString &f : m_project.buildSystemFiles())
-            buildSystemFiles.push_back(f);
-        projectData.insert(StringConstants::buildDirectoryKey(), m_projectData.buildDirectory());
-        projectData.insert(QLatin1String("build-system-files"), buildSystemFiles);
-        const Project::BuildGraphInfo bgInfo = m_project.getBuildGraphInfo();
-        projectData.insert(QLatin1String("build-graph-file-path"), bgInfo.bgFilePath);
-        projectData.insert(QLatin1String("profile-data"),
-                           QJsonObject::fromVariantMap(bgInfo.profileData));
-        projectData.insert(QLatin1String("overridden-properties"),
-                           QJsonObject::fromVariantMap(bgInfo.overriddenProperties));
-    }
-    reply.insert(QLatin1String("project-data"), projectData);
+    if (includeTopLevelData)
+        insertTopLevelData(projectData);
+    return projectData;
+}
+
+void Session::insertTopLevelData(QJsonObject &projectData) const
+{
+    QJsonArray buildSystemFiles;
+    for (const QString &f : m_project.buildSystemFiles())
+        buildSystemFiles.push_back(f);
+    projectData.insert(StringConstants::buildDirectoryKey(), m_projectData.buildDirectory());
+    projectData.insert(QLatin1String("build-system-files"), buildSystemFiles);
+    const Project::BuildGraphInfo bgInfo = m_project.getBuildGraphInfo();
+    projectData.insert(QLatin1String("build-graph-file-path"), bgInfo.bgFilePath);
+    projectData.insert(QLatin1String("profile-data"),
+                       QJsonObject::fromVariantMap(bgInfo.profileData));
+    projectData.insert(QLatin1String("overridden-properties"),
+                       QJsonObject::fromVariantMap(bgInfo.overriddenProperties));
 }
 
 void Session::setLogLevelFromRequest(const QJsonObject &request)
@@ -692,6 +786,24 @@ void Session::setLogLevelFromRequest(const QJsonObject &request)
     }
 }
 
+void Session::updateSourceFileWatcher(bool watch)
+{
+    if (!watch) {
+        m_sourceFileWatcher.reset();
+        return;
+    }
+    if (!m_sourceFileWatcher)
+        m_sourceFileWatcher = std::make_unique<SourceFileWatcher>();
+    QStringList filePaths;
+    for (const ProductData &product : m_projectData.allProducts()) {
+        for (const GroupData &group : product.groups()) {
+            for (const ArtifactData &artifact : group.allSourceArtifacts())
+                filePaths << artifact.filePath();
+        }
+    }
+    m_sourceFileWatcher->setFiles(filePaths);
+}
+
 bool Session::checkNormalRequestPrerequisites(const char *replyType)
 {
     if (m_currentJob) {
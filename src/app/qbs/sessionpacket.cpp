@@ -43,24 +43,39 @@
 #include <tools/stringconstants.h>
 #include <tools/version.h>
 
+#include <QtCore/qcborstreamreader.h>
+#include <QtCore/qcborstreamwriter.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qjsonarray.h>
 #include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonvalue.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+
+#include <cmath>
 
 namespace qbs {
 namespace Internal {
 
 const QByteArray packetStart = "qbsmsg:";
+const QByteArray cborPacketStart = "qbscbor:";
 
 SessionPacket::Status SessionPacket::parseInput(QByteArray &input)
 {
     //qDebug() << m_expectedPayloadLength << m_payload << input;
     if (m_expectedPayloadLength == -1) {
-        const int packetStartOffset = input.indexOf(packetStart);
-        if (packetStartOffset == -1)
+        const int jsonStartOffset = input.indexOf(packetStart);
+        const int cborStartOffset = input.indexOf(cborPacketStart);
+        if (jsonStartOffset == -1 && cborStartOffset == -1)
             return Status::Incomplete;
-        const int numberOffset = packetStartOffset + packetStart.length();
+        m_encoding = cborStartOffset != -1
+                && (jsonStartOffset == -1 || cborStartOffset < jsonStartOffset)
+                ? Encoding::Cbor : Encoding::Json;
+        const int packetStartOffset = m_encoding == Encoding::Cbor ? cborStartOffset
+                                                                   : jsonStartOffset;
+        const int numberOffset = packetStartOffset + (m_encoding == Encoding::Cbor
+                                                      ? cborPacketStart.length()
+                                                      : packetStart.length());
         const int newLineOffset = input.indexOf('\n', numberOffset);
         if (newLineOffset == -1)
             return Status::Incomplete;
@@ -74,32 +89,197 @@ SessionPacket::Status SessionPacket::parseInput(QByteArray &input)
     }
     const int bytesToAdd = m_expectedPayloadLength - m_payload.length();
     QBS_ASSERT(bytesToAdd >= 0, return Status::Invalid);
-    m_payload += input.left(bytesToAdd);
-    input.remove(0, bytesToAdd);
+    if (m_payload.isEmpty() && input.length() == bytesToAdd) {
+        m_payload.swap(input); // Avoid copying large packets that arrived in one piece.
+        input.clear();
+    } else {
+        m_payload += input.left(bytesToAdd);
+        input.remove(0, bytesToAdd);
+    }
     return isComplete() ? Status::Complete : Status::Incomplete;
 }
 
+static QString readCborString(QCborStreamReader &reader)
+{
+    QString string;
+    auto result = reader.readString();
+    while (result.status == QCborStreamReader::Ok) {
+        string += result.data;
+        result = reader.readString();
+    }
+    return string;
+}
+
+static QByteArray readCborByteArray(QCborStreamReader &reader)
+{
+    QByteArray byteArray;
+    auto result = reader.readByteArray();
+    while (result.status == QCborStreamReader::Ok) {
+        byteArray += result.data;
+        result = reader.readByteArray();
+    }
+    return byteArray;
+}
+
+// Reads the value directly into JSON, without building a QCborValue tree first.
+// Conversions follow QCborValue::toJsonValue().
+static QJsonValue readCbor(QCborStreamReader &reader)
+{
+    switch (reader.type()) {
+    case QCborStreamReader::UnsignedInteger:
+    case QCborStreamReader::NegativeInteger: {
+        const QJsonValue value(reader.toInteger());
+        reader.next();
+        return value;
+    }
+    case QCborStreamReader::ByteArray:
+        return QString::fromLatin1(readCborByteArray(reader).toBase64(
+                QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+    case QCborStreamReader::String:
+        return readCborString(reader);
+    case QCborStreamReader::Array: {
+        QJsonArray array;
+        if (!reader.enterContainer())
+            return {};
+        while (reader.lastError() == QCborError::NoError && reader.hasNext())
+            array.push_back(readCbor(reader));
+        if (reader.lastError() == QCborError::NoError)
+            reader.leaveContainer();
+        return array;
+    }
+    case QCborStreamReader::Map: {
+        QJsonObject object;
+        if (!reader.enterContainer())
+            return {};
+        while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+            const QString key = reader.isString() ? readCborString(reader)
+                                                  : readCbor(reader).toVariant().toString();
+            object.insert(key, readCbor(reader));
+        }
+        if (reader.lastError() == QCborError::NoError)
+            reader.leaveContainer();
+        return object;
+    }
+    case QCborStreamReader::Tag:
+        reader.next(); // Tags carry no meaning in this protocol, so only the value counts.
+        return readCbor(reader);
+    case QCborStreamReader::SimpleType: {
+        QJsonValue value;
+        if (reader.isBool())
+            value = reader.toBool();
+        else if (reader.isUndefined())
+            value = QJsonValue(QJsonValue::Undefined);
+        reader.next();
+        return value;
+    }
+    case QCborStreamReader::Float16: {
+        const QJsonValue value(double(reader.toFloat16()));
+        reader.next();
+        return value;
+    }
+    case QCborStreamReader::Float: {
+        const QJsonValue value(double(reader.toFloat()));
+        reader.next();
+        return value;
+    }
+    case QCborStreamReader::Double: {
+        const QJsonValue value(reader.toDouble());
+        reader.next();
+        return value;
+    }
+    case QCborStreamReader::Invalid:
+        break;
+    }
+    return {};
+}
+
+// The payload is buffered until the packet is complete, as no message can be handled
+// before that anyway. QCborStreamReader cannot resume inside a partially received
+// container, so decoding while the data arrives would mean re-parsing from the start.
 QJsonObject SessionPacket::retrievePacket()
 {
     QBS_ASSERT(isComplete(), return QJsonObject());
-    const auto packet = QJsonDocument::fromJson(QByteArray::fromBase64(m_payload)).object();
+    QJsonObject packet;
+    if (m_encoding == Encoding::Cbor) {
+        QCborStreamReader reader(m_payload);
+        if (reader.isMap()) {
+            const QJsonValue value = readCbor(reader);
+            if (reader.lastError() == QCborError::NoError)
+                packet = value.toObject();
+        }
+    } else {
+        packet = QJsonDocument::fromJson(QByteArray::fromBase64(m_payload)).object();
+    }
     m_payload.clear();
     m_expectedPayloadLength = -1;
     return packet;
 }
 
-QByteArray SessionPacket::createPacket(const QJsonObject &packet)
+// Writes the value directly, without building a QCborValue tree first.
+static void writeCbor(QCborStreamWriter &writer, const QJsonValue &value)
 {
-    const QByteArray jsonData = QJsonDocument(packet).toJson(QJsonDocument::Compact).toBase64();
-    return QByteArray(packetStart).append(QByteArray::number(jsonData.length())).append('\n')
-            .append(jsonData);
+    switch (value.type()) {
+    case QJsonValue::Null:
+        writer.appendNull();
+        break;
+    case QJsonValue::Bool:
+        writer.append(value.toBool());
+        break;
+    case QJsonValue::Double: {
+        // JSON does not distinguish integers from floating-point values, but CBOR does.
+        const double d = value.toDouble();
+        if (std::trunc(d) == d && std::abs(d) <= 9007199254740992.0)
+            writer.append(qint64(d));
+        else
+            writer.append(d);
+        break;
+    }
+    case QJsonValue::String:
+        writer.append(value.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        writer.startArray(array.size());
+        for (const QJsonValue &v : array)
+            writeCbor(writer, v);
+        writer.endArray();
+        break;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject object = value.toObject();
+        writer.startMap(object.size());
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            writer.append(it.key());
+            writeCbor(writer, it.value());
+        }
+        writer.endMap();
+        break;
+    }
+    case QJsonValue::Undefined:
+        writer.appendUndefined();
+        break;
+    }
+}
+
+QByteArray SessionPacket::createPacket(const QJsonObject &packet, Encoding encoding)
+{
+    QByteArray data;
+    if (encoding == Encoding::Cbor) {
+        QCborStreamWriter writer(&data);
+        writeCbor(writer, packet);
+    } else {
+        data = QJsonDocument(packet).toJson(QJsonDocument::Compact).toBase64();
+    }
+    const QByteArray &start = encoding == Encoding::Cbor ? cborPacketStart : packetStart;
+    return QByteArray(start).append(QByteArray::number(data.length())).append('\n')
+            .append(data);
 }
 
 QJsonObject SessionPacket::helloMessage()
 {
     return QJsonObject{
         {StringConstants::type(), QLatin1String("hello")},
-        {QLatin1String("api-level"), 2},
+        {QLatin1String("api-level"), 3},
         {QLatin1String("api-compat-level"), 2}
     };
 }
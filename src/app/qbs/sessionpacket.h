@@ -52,9 +52,13 @@ public:
     enum class Status { Incomplete, Complete, Invalid };
     Status parseInput(QByteArray &input);
 
+    // Base64-encoded JSON or plain CBOR.
+    enum class Encoding { Json, Cbor };
+    Encoding encoding() const { return m_encoding; }
+
     QJsonObject retrievePacket();
 
-    static QByteArray createPacket(const QJsonObject &packet);
+    static QByteArray createPacket(const QJsonObject &packet, Encoding encoding = Encoding::Json);
     static QJsonObject helloMessage();
 
 private:
@@ -62,6 +66,7 @@ private:
 
     QByteArray m_payload;
     int m_expectedPayloadLength = -1;
+    Encoding m_encoding = Encoding::Json;
 };
 
 } // namespace Internal
@@ -39,7 +39,6 @@
 
 #include "sessionpacketreader.h"
 
-#include "sessionpacket.h"
 #include "stdinreader.h"
 
 namespace qbs {
@@ -50,6 +49,7 @@ class SessionPacketReader::Private
 public:
     QByteArray incomingData;
     SessionPacket currentPacket;
+    SessionPacket::Encoding encoding = SessionPacket::Encoding::Json;
 };
 
 SessionPacketReader::SessionPacketReader(QObject *parent)
@@ -71,6 +71,7 @@ void SessionPacketReader::start()
                 emit errorOccurred(tr("Received invalid input."));
                 return;
             case SessionPacket::Status::Complete:
+                d->encoding = d->currentPacket.encoding();
                 emit packetReceived(d->currentPacket.retrievePacket());
                 break;
             case SessionPacket::Status::Incomplete:
@@ -81,5 +82,10 @@ void SessionPacketReader::start()
     stdinReader->start();
 }
 
+SessionPacket::Encoding SessionPacketReader::encoding() const
+{
+    return d->encoding;
+}
+
 } // namespace Internal
 } // namespace qbs
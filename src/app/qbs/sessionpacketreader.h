@@ -40,6 +40,8 @@
 #ifndef QBS_SESSIONPACKETREADER_H
 #define QBS_SESSIONPACKETREADER_H
 
+#include "sessionpacket.h"
+
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qobject.h>
 
@@ -57,6 +59,9 @@ public:
 
     void start();
 
+    // The encoding of the packet received last.
+    SessionPacket::Encoding encoding() const;
+
 signals:
     void packetReceived(const QJsonObject &packet);
     void errorOccurred(const QString &msg);
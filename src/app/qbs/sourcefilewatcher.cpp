@@ -0,0 +1,117 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "sourcefilewatcher.h"
+
+#include <QtCore/qfileinfo.h>
+
+namespace qbs {
+namespace Internal {
+
+SourceFileWatcher::SourceFileWatcher()
+{
+    QObject::connect(&m_watcher, &QFileSystemWatcher::fileChanged,
+                     [this](const QString &filePath) { handleFileChanged(filePath); });
+}
+
+void SourceFileWatcher::setFiles(const QStringList &filePaths)
+{
+    const QSet<QString> newFiles(filePaths.cbegin(), filePaths.cend());
+    QStringList obsoleteFiles;
+    for (const QString &filePath : qAsConst(m_watchedFiles)) {
+        if (!newFiles.contains(filePath))
+            obsoleteFiles << filePath;
+    }
+    for (const QString &filePath : qAsConst(obsoleteFiles)) {
+        m_watchedFiles.remove(filePath);
+        m_missingFiles.remove(filePath);
+        m_changedFiles.remove(filePath);
+    }
+    if (!obsoleteFiles.isEmpty())
+        m_watcher.removePaths(obsoleteFiles);
+    for (const QString &filePath : newFiles) {
+        if (!m_watchedFiles.contains(filePath)) {
+            m_watchedFiles << filePath;
+            watchFile(filePath);
+        }
+    }
+}
+
+QStringList SourceFileWatcher::takeChangedFiles()
+{
+    // Files that were removed and possibly re-created are not watched anymore, so they
+    // count as changed until they can be watched again.
+    const QSet<QString> missingFiles = m_missingFiles;
+    for (const QString &filePath : missingFiles) {
+        m_missingFiles.remove(filePath);
+        watchFile(filePath);
+        m_changedFiles << filePath;
+    }
+    const QStringList changedFiles(m_changedFiles.cbegin(), m_changedFiles.cend());
+    m_changedFiles.clear();
+    return changedFiles;
+}
+
+void SourceFileWatcher::addChangedFiles(const QStringList &filePaths)
+{
+    for (const QString &filePath : filePaths)
+        m_changedFiles << filePath;
+}
+
+void SourceFileWatcher::handleFileChanged(const QString &filePath)
+{
+    m_changedFiles << filePath;
+
+    // Editors that save by replacing the file make the watcher lose track of it.
+    watchFile(filePath);
+}
+
+void SourceFileWatcher::watchFile(const QString &filePath)
+{
+    if (!QFileInfo::exists(filePath)) {
+        m_missingFiles << filePath;
+        return;
+    }
+    // Adding a path that is already watched fails as well.
+    if (!m_watcher.addPath(filePath) && !m_watcher.files().contains(filePath))
+        m_complete = false;
+}
+
+} // namespace Internal
+} // namespace qbs
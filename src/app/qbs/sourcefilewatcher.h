@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_SOURCEFILEWATCHER_H
+#define QBS_SOURCEFILEWATCHER_H
+
+#include <QtCore/qfilesystemwatcher.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstringlist.h>
+
+namespace qbs {
+namespace Internal {
+
+// Keeps track of which source files of a project have changed since the last build,
+// so that a session does not need to check the timestamps of all of them.
+class SourceFileWatcher
+{
+public:
+    SourceFileWatcher();
+
+    void setFiles(const QStringList &filePaths);
+
+    // False if not all files could be watched, e.g. due to system limits. In that case,
+    // the list of changed files cannot be trusted.
+    bool isComplete() const { return m_complete; }
+
+    // The first build after the watcher was set up has to check all files.
+    bool initialCheckDone() const { return m_initialCheckDone; }
+    void setInitialCheckDone() { m_initialCheckDone = true; }
+
+    QStringList takeChangedFiles();
+    void addChangedFiles(const QStringList &filePaths);
+
+private:
+    void handleFileChanged(const QString &filePath);
+    void watchFile(const QString &filePath);
+
+    QFileSystemWatcher m_watcher;
+    QSet<QString> m_watchedFiles;
+    QSet<QString> m_changedFiles;
+    QSet<QString> m_missingFiles;
+    bool m_complete = true;
+    bool m_initialCheckDone = false;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_SOURCEFILEWATCHER_H
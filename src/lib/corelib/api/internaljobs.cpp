@@ -54,10 +54,12 @@
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
 #include <tools/error.h>
+#include <tools/filesystemcache.h>
 #include <tools/profiling.h>
 #include <tools/progressobserver.h>
 #include <tools/preferences.h>
 #include <tools/qbsassert.h>
+#include <tools/settings.h>
 
 #include <QtCore/qtimer.h>
 
@@ -158,7 +160,7 @@ void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project)
     try {
         doSanityChecks(project, logger());
         TimedActivityLogger storeTimer(m_logger, Tr::tr("Storing build graph"), timed());
-        project->store(logger());
+        project->store(logger(), timed());
     } catch (const ErrorInfo &error) {
         ErrorInfo fullError = this->error();
         const auto items = error.items();
@@ -286,6 +288,7 @@ void InternalSetupProjectJob::start()
 
 void InternalSetupProjectJob::execute()
 {
+    const FileSystemCache::Scope fileSystemCacheScope;
     RulesEvaluationContextPtr evalContext(new RulesEvaluationContext(logger()));
     evalContext->setObserver(observer());
 
@@ -312,6 +315,9 @@ void InternalSetupProjectJob::execute()
     }
     }
 
+    Settings settings(m_parameters.settingsDirectory());
+    m_newProject->compressBuildGraph
+            = Preferences(&settings, m_newProject->profile()).compressBuildGraph();
     if (!m_parameters.dryRun())
         storeBuildGraph(m_newProject);
 
@@ -384,6 +390,8 @@ void InternalBuildJob::build(const TopLevelProjectPtr &project,
     m_executor->moveToThread(executorThread);
     connect(m_executor, &Executor::reportCommandDescription,
             this, &BuildGraphTouchingJob::reportCommandDescription);
+    connect(m_executor, &Executor::reportProcessOutput,
+            this, &BuildGraphTouchingJob::reportProcessOutput);
     connect(m_executor, &Executor::reportProcessResult,
             this, &BuildGraphTouchingJob::reportProcessResult);
 
@@ -457,6 +465,10 @@ void InternalInstallJob::start()
     } catch (const ErrorInfo &error) {
         setError(error);
     }
+
+    // Persist the changes to the install manifest.
+    if (!m_options.dryRun())
+        storeBuildGraph(m_project);
     emit finished(this);
 }
 
@@ -156,6 +156,7 @@ public:
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const qbs::ProcessResult &result);
     void reportProcessResult(const qbs::ProcessResult &result);
 
 protected:
@@ -291,6 +291,14 @@ void SetupProjectJob::finish()
  * The \a message parameter is the localized message to print.
  */
 
+/*!
+ * \fn void BuildJob::reportProcessOutput(const qbs::ProcessResult &result)
+ * \brief Signals that an external command has produced output while still running.
+ * This signal is only emitted if \c BuildOptions::streamProcessOutput() is enabled.
+ * The \a result parameter contains the complete lines of output that have arrived since
+ * the last such signal. Its exit code and success status are not meaningful yet.
+ */
+
 /*!
  * \fn void BuildJob::reportProcessResult(const qbs::ProcessResult &result)
  * \brief Signals that an external command has finished.
@@ -305,6 +313,8 @@ BuildJob::BuildJob(const Logger &logger, QObject *parent)
     auto job = static_cast<InternalBuildJob *>(internalJob());
     connect(job, &BuildGraphTouchingJob::reportCommandDescription,
             this, &BuildJob::reportCommandDescription);
+    connect(job, &BuildGraphTouchingJob::reportProcessOutput,
+            this, &BuildJob::reportProcessOutput);
     connect(job, &BuildGraphTouchingJob::reportProcessResult,
             this, &BuildJob::reportProcessResult);
 }
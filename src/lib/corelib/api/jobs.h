@@ -130,6 +130,7 @@ class QBS_EXPORT BuildJob : public AbstractJob
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const qbs::ProcessResult &result);
     void reportProcessResult(const qbs::ProcessResult &result);
 
 private:
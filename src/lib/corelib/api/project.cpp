@@ -147,6 +147,7 @@ BuildJob *ProjectPrivate::buildProducts(const QVector<ResolvedProductPtr> &produ
     if (needsDepencencyResolving)
         addDependencies(productsToBuild);
 
+    queryEngine.reset();
     const auto job = new BuildJob(logger, jobOwner);
     job->build(internalProject, productsToBuild, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -156,6 +157,7 @@ BuildJob *ProjectPrivate::buildProducts(const QVector<ResolvedProductPtr> &produ
 CleanJob *ProjectPrivate::cleanProducts(const QVector<ResolvedProductPtr> &products,
         const CleanOptions &options, QObject *jobOwner)
 {
+    queryEngine.reset();
     const auto job = new CleanJob(logger, jobOwner);
     job->clean(internalProject, products, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -521,6 +523,7 @@ void ProjectPrivate::prepareChangeToProject()
 {
     if (internalProject->locked)
         throw ErrorInfo(Tr::tr("A job is currently in progress."));
+    queryEngine.reset();
     if (!m_projectData.isValid())
         retrieveProjectData(m_projectData, internalProject);
 }
@@ -619,6 +622,7 @@ ProjectTransformerData ProjectPrivate::transformerData()
             for (const Artifact * const input : allInputs)
                 tData.d->inputs << createArtifactData(input, product, targetArtifacts);
             tData.d->commands = ruleCommandListForTransformer(t);
+            tData.d->resourceUsage = t->resourceUsage;
             productTransformerData << tData;
         }
         projectTransformerData << qMakePair(productData, productTransformerData);
@@ -998,6 +1002,35 @@ ErrorInfo Project::dumpNodesTree(QIODevice &outDevice, const QList<ProductData>
     return {};
 }
 
+/*!
+ * \brief Answers a query about the build graph of the project.
+ * The possible queries and their arguments are:
+ *   \c reverse-dependencies \a file: The generated files that depend on \a file.
+ *   \c dependency-path \a from \a to: A shortest chain of dependencies from one file to the other.
+ *   \c out-of-date-reasons \a file: Why the next build would re-generate \a file, followed by
+ *       why it might do so.
+ *   \c property-users \a property: The outputs of the rules that accessed \a property.
+ * File paths must be absolute. The indexes needed to answer the queries are built on demand
+ * and re-used by later queries until the build graph changes.
+ * In case of an error, an empty list is returned and \a error is set, if it is not null.
+ */
+QStringList Project::queryBuildGraph(const QString &query, const QStringList &arguments,
+                                     ErrorInfo *error) const
+{
+    QBS_ASSERT(isValid(), return {});
+    try {
+        if (d->internalProject->locked)
+            throw ErrorInfo(Tr::tr("A job is currently in progress."));
+        if (!d->queryEngine)
+            d->queryEngine = std::make_unique<BuildGraphQueryEngine>(d->internalProject);
+        return d->queryEngine->query(query, arguments);
+    } catch (const ErrorInfo &e) {
+        if (error)
+            *error = e;
+        return {};
+    }
+}
+
 Project::BuildGraphInfo Project::getBuildGraphInfo(const QString &bgFilePath,
                                                    const QStringList &requestedProperties)
 {
@@ -141,6 +141,8 @@ public:
     ProjectTransformerData transformerData(ErrorInfo *error = nullptr) const;
 
     ErrorInfo dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products);
+    QStringList queryBuildGraph(const QString &query, const QStringList &arguments,
+                                ErrorInfo *error = nullptr) const;
 
 
     class BuildGraphInfo
@@ -43,12 +43,15 @@
 #include "rulecommand.h"
 #include "transformerdata.h"
 
+#include <buildgraph/buildgraphquery.h>
 #include <language/language.h>
 #include <logging/logger.h>
 
 #include <QtCore/qobject.h>
 #include <QtCore/qstringlist.h>
 
+#include <memory>
+
 namespace qbs {
 class BuildJob;
 class BuildOptions;
@@ -124,6 +127,7 @@ public:
 
     TopLevelProjectPtr internalProject;
     Logger logger;
+    std::unique_ptr<BuildGraphQueryEngine> queryEngine; // Reset whenever the build graph changes.
 
 private:
     void retrieveProjectData(ProjectData &projectData,
@@ -53,4 +53,11 @@ QList<ArtifactData> TransformerData::inputs() const { return d->inputs; }
 QList<ArtifactData> TransformerData::outputs() const { return d->outputs; }
 RuleCommandList TransformerData::commands() const { return d->commands; }
 
+// The following refer to the last time the commands were run. -1 means unknown.
+qint64 TransformerData::userTime() const { return d->resourceUsage.userTime; }
+qint64 TransformerData::systemTime() const { return d->resourceUsage.systemTime; }
+qint64 TransformerData::peakMemoryUsage() const { return d->resourceUsage.peakMemoryUsage; }
+qint64 TransformerData::bytesRead() const { return d->resourceUsage.bytesRead; }
+qint64 TransformerData::bytesWritten() const { return d->resourceUsage.bytesWritten; }
+
 } // namespace qbs
@@ -66,6 +66,12 @@ public:
     QList<ArtifactData> outputs() const;
     RuleCommandList commands() const;
 
+    qint64 userTime() const;
+    qint64 systemTime() const;
+    qint64 peakMemoryUsage() const;
+    qint64 bytesRead() const;
+    qint64 bytesWritten() const;
+
 private:
     QExplicitlySharedDataPointer<Internal::TransformerDataPrivate> d;
 };
@@ -42,6 +42,8 @@
 
 #include "transformerdata.h"
 
+#include <tools/processresourceusage.h>
+
 namespace qbs {
 namespace Internal {
 
@@ -51,6 +53,7 @@ public:
     QList<ArtifactData> inputs;
     QList<ArtifactData> outputs;
     RuleCommandList commands;
+    ProcessResourceUsage resourceUsage;
 };
 
 } // namespace Internal
@@ -55,6 +55,7 @@ Artifact::Artifact() :
     artifactType(ArtifactType::Unknown),
     inputsScanned(false),
     timestampRetrieved(false),
+    timestampKnown(false),
     alwaysUpdated(false),
     oldDataPossiblyPresent(true)
 {
@@ -147,9 +148,7 @@ void Artifact::load(PersistentPool &pool)
     BuildGraphNode::load(pool);
     children.load(pool);
 
-    // restore parents of the loaded children
-    for (auto it = children.constBegin(); it != children.constEnd(); ++it)
-        (*it)->parents.insert(this);
+    // The parents of the loaded children are restored in ResolvedProject::load().
 
     pool.load(childrenAddedByScanner);
     pool.load(fileDependencies);
@@ -111,6 +111,7 @@ public:
     ArtifactType artifactType;
     bool inputsScanned : 1;                 // Do not serialize. Will be refreshed for every build.
     bool timestampRetrieved : 1;            // Do not serialize. Will be refreshed for every build.
+    bool timestampKnown : 1;                // Do not serialize. Retrieved by this process.
     bool alwaysUpdated : 1;
     bool oldDataPossiblyPresent : 1;
 
@@ -62,17 +62,21 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/parallelfor.h>
 #include <tools/scripttools.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
+#include <tools/stlutils.h>
 #include <tools/stringconstants.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
 #include <QtScript/qscriptclass.h>
 
 #include <algorithm>
 #include <iterator>
+#include <unordered_set>
 #include <vector>
 
 namespace qbs {
@@ -458,6 +462,19 @@ bool findPath(BuildGraphNode *u, BuildGraphNode *v, QList<BuildGraphNode *> &pat
     return false;
 }
 
+static void checkChildFilePath(const BuildGraphNode *p, const Artifact *child,
+                               const Artifact *newChild)
+{
+    const bool filePathsMustBeDifferent = child->artifactType == Artifact::Generated
+            || child->product == newChild->product || child->artifactType != newChild->artifactType;
+    if (filePathsMustBeDifferent && child->filePath() == newChild->filePath()) {
+        throw ErrorInfo(QStringLiteral("%1 already has a child artifact %2 as "
+                                            "different object.").arg(p->toString(),
+                                                                     newChild->filePath()),
+                        CodeLocation(), true);
+    }
+}
+
 /*
  * Creates the build graph edge p -> c, which represents the dependency "c must be built before p".
  */
@@ -470,14 +487,7 @@ void connect(BuildGraphNode *p, BuildGraphNode *c)
         for (const Artifact *child : filterByType<Artifact>(p->children)) {
             if (child == ac)
                 return;
-            const bool filePathsMustBeDifferent = child->artifactType == Artifact::Generated
-                    || child->product == ac->product || child->artifactType != ac->artifactType;
-            if (filePathsMustBeDifferent && child->filePath() == ac->filePath()) {
-                throw ErrorInfo(QStringLiteral("%1 already has a child artifact %2 as "
-                                                    "different object.").arg(p->toString(),
-                                                                             ac->filePath()),
-                                CodeLocation(), true);
-            }
+            checkChildFilePath(p, child, ac);
         }
     }
     p->children.insert(c);
@@ -485,7 +495,76 @@ void connect(BuildGraphNode *p, BuildGraphNode *c)
     p->product->topLevelProject()->buildData->setDirty();
 }
 
-static bool existsPath_impl(BuildGraphNode *u, BuildGraphNode *v, NodeSet *seen)
+/*
+ * Like connect(p, c) for all the children, but the children of p are merged in one go rather
+ * than inserted one by one, which is quadratic if p has many children.
+ */
+void connect(BuildGraphNode *p, const std::vector<BuildGraphNode *> &children)
+{
+    QHash<QString, std::vector<const Artifact *>> artifactChildrenByFilePath;
+    for (const Artifact * const child : filterByType<Artifact>(p->children))
+        artifactChildrenByFilePath[child->filePath()].push_back(child);
+    std::vector<BuildGraphNode *> newChildren;
+    for (BuildGraphNode * const c : children) {
+        QBS_CHECK(p != c);
+        qCDebug(lcBuildGraph).noquote() << "connect" << p->toString() << "->" << c->toString();
+        if (c->type() == BuildGraphNode::ArtifactNodeType) {
+            auto const ac = static_cast<Artifact *>(c);
+            std::vector<const Artifact *> &candidates
+                    = artifactChildrenByFilePath[ac->filePath()];
+            if (contains(candidates, ac))
+                continue;
+            for (const Artifact * const child : candidates)
+                checkChildFilePath(p, child, ac);
+            candidates.push_back(ac);
+        } else if (p->children.contains(c) || contains(newChildren, c)) {
+            continue;
+        }
+        c->parents.insert(p);
+        newChildren.push_back(c);
+    }
+    if (newChildren.empty())
+        return;
+    p->children.insert(newChildren.cbegin(), newChildren.cend());
+    p->product->topLevelProject()->buildData->setDirty();
+}
+
+/*
+ * Like connect(p, c) for all the parents, but the parents of c are merged in one go rather
+ * than inserted one by one, which is quadratic if c has many parents.
+ */
+void connect(const std::vector<BuildGraphNode *> &parents, BuildGraphNode *c)
+{
+    std::vector<BuildGraphNode *> newParents;
+    for (BuildGraphNode * const p : parents) {
+        QBS_CHECK(p != c);
+        qCDebug(lcBuildGraph).noquote() << "connect" << p->toString() << "->" << c->toString();
+        if (c->type() == BuildGraphNode::ArtifactNodeType) {
+            auto const ac = static_cast<Artifact *>(c);
+            bool isChild = false;
+            for (const Artifact *child : filterByType<Artifact>(p->children)) {
+                if (child == ac) {
+                    isChild = true;
+                    break;
+                }
+                checkChildFilePath(p, child, ac);
+            }
+            if (isChild)
+                continue;
+        } else if (p->children.contains(c)) {
+            continue;
+        }
+        p->children.insert(c);
+        newParents.push_back(p);
+        p->product->topLevelProject()->buildData->setDirty();
+    }
+    c->parents.insert(newParents.cbegin(), newParents.cend());
+}
+
+// This typically visits only a few nodes, so a NodeMarks object, whose size depends on the
+// highest node id in the process, would be too expensive here.
+static bool existsPath_impl(BuildGraphNode *u, BuildGraphNode *v,
+                            std::unordered_set<const BuildGraphNode *> *seen)
 {
     if (u == v)
         return true;
@@ -503,7 +582,7 @@ static bool existsPath_impl(BuildGraphNode *u, BuildGraphNode *v, NodeSet *seen)
 
 static bool existsPath(BuildGraphNode *u, BuildGraphNode *v)
 {
-    NodeSet seen;
+    std::unordered_set<const BuildGraphNode *> seen;
     return existsPath_impl(u, v, &seen);
 }
 
@@ -727,11 +806,9 @@ void invalidateArtifactAsRuleInputIfNecessary(Artifact *artifact)
 }
 
 static void doSanityChecksForProduct(const ResolvedProductConstPtr &product,
-        const Set<ResolvedProductPtr> &allProducts, const Logger &logger)
+        const Set<ResolvedProductPtr> &allProducts)
 {
     qCDebug(lcBuildGraph) << "Sanity checking product" << product->uniqueName();
-    CycleDetector cycleDetector(logger);
-    cycleDetector.visitProduct(product);
     const ProductBuildData * const buildData = product->buildData.get();
     for (const auto &m : product->modules)
         QBS_CHECK(m->product == product.get());
@@ -829,17 +906,17 @@ static void doSanityChecksForProduct(const ResolvedProductConstPtr &product,
 }
 
 static void doSanityChecks(const ResolvedProjectPtr &project,
-                           const Set<ResolvedProductPtr> &allProducts, Set<QString> &productNames,
-                           const Logger &logger)
+                           std::vector<ResolvedProductPtr> &productsToCheck,
+                           Set<QString> &productNames, const Logger &logger)
 {
     logger.qbsDebug() << "Sanity checking project '" << project->name << "'";
     for (const ResolvedProjectPtr &subProject : qAsConst(project->subProjects))
-        doSanityChecks(subProject, allProducts, productNames, logger);
+        doSanityChecks(subProject, productsToCheck, productNames, logger);
 
     for (const auto &product : project->products) {
         QBS_CHECK(product->project == project);
         QBS_CHECK(product->topLevelProject() == project->topLevelProject());
-        doSanityChecksForProduct(product, allProducts, logger);
+        productsToCheck.push_back(product);
         QBS_CHECK(!productNames.contains(product->uniqueName()));
         productNames << product->uniqueName();
     }
@@ -850,8 +927,15 @@ void doSanityChecks(const ResolvedProjectPtr &project, const Logger &logger)
     if (qEnvironmentVariableIsEmpty("QBS_SANITY_CHECKS"))
         return;
     Set<QString> productNames;
+    std::vector<ResolvedProductPtr> productsToCheck;
+    doSanityChecks(project, productsToCheck, productNames, logger);
+
+    // The graph is only read from here on, so the products can be checked in parallel.
+    CycleDetector(logger).visitProducts(productsToCheck);
     const auto allProducts = rangeTo<Set<ResolvedProductPtr>>(project->allProducts());
-    doSanityChecks(project, allProducts, productNames, logger);
+    parallelFor(productsToCheck.size(), [&](size_t i) {
+        doSanityChecksForProduct(productsToCheck.at(i), allProducts);
+    });
 }
 
 } // namespace Internal
@@ -47,6 +47,8 @@
 
 #include <QtScript/qscriptvalue.h>
 
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 class BuildGraphNode;
@@ -81,6 +83,8 @@ void invalidateArtifactAsRuleInputIfNecessary(Artifact *artifact);
 
 bool findPath(BuildGraphNode *u, BuildGraphNode *v, QList<BuildGraphNode*> &path);
 void QBS_AUTOTEST_EXPORT connect(BuildGraphNode *p, BuildGraphNode *c);
+void QBS_AUTOTEST_EXPORT connect(BuildGraphNode *p, const std::vector<BuildGraphNode *> &children);
+void QBS_AUTOTEST_EXPORT connect(const std::vector<BuildGraphNode *> &parents, BuildGraphNode *c);
 bool safeConnect(Artifact *u, Artifact *v);
 void removeGeneratedArtifactFromDisk(Artifact *artifact, const Logger &logger);
 void removeGeneratedArtifactFromDisk(const QString &filePath, const Logger &logger);
@@ -8,6 +8,7 @@ SOURCES += \
     $$PWD/artifactvisitor.cpp \
     $$PWD/buildgraph.cpp \
     $$PWD/buildgraphloader.cpp \
+    $$PWD/buildgraphquery.cpp \
     $$PWD/buildgraphnode.cpp \
     $$PWD/cycledetector.cpp \
     $$PWD/dependencyparametersscriptvalue.cpp \
@@ -18,6 +19,7 @@ SOURCES += \
     $$PWD/executorjob.cpp \
     $$PWD/filedependency.cpp \
     $$PWD/inputartifactscanner.cpp \
+    $$PWD/installmanifest.cpp \
     $$PWD/jscommandexecutor.cpp \
     $$PWD/nodeset.cpp \
     $$PWD/nodetreedumper.cpp \
@@ -47,6 +49,7 @@ HEADERS += \
     $$PWD/artifactvisitor.h \
     $$PWD/buildgraph.h \
     $$PWD/buildgraphloader.h \
+    $$PWD/buildgraphquery.h \
     $$PWD/buildgraphnode.h \
     $$PWD/buildgraphvisitor.h \
     $$PWD/cycledetector.h \
@@ -59,6 +62,7 @@ HEADERS += \
     $$PWD/filedependency.h \
     $$PWD/forward_decls.h \
     $$PWD/inputartifactscanner.h \
+    $$PWD/installmanifest.h \
     $$PWD/jscommandexecutor.h \
     $$PWD/nodeset.h \
     $$PWD/nodetreedumper.h \
@@ -58,6 +58,7 @@
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
 #include <tools/fileinfo.h>
+#include <tools/filesystemcache.h>
 #include <tools/jsliterals.h>
 #include <tools/persistence.h>
 #include <tools/profile.h>
@@ -200,6 +201,19 @@ void BuildGraphLoader::loadBuildGraphFromDisk()
     m_evalContext->initializeObserver(Tr::tr("Restoring build graph from disk"), 1);
 
     project->load(pool);
+    if (m_parameters.logElapsedTime()) {
+        const PersistentPool::ChunkStatistics &statistics = pool.chunkStatistics();
+        if (statistics.compressed) {
+            m_logger.qbsLog(LoggerInfo, true) << "\t"
+                    << Tr::tr("Decompressing %1 bytes of build graph data to %2 bytes took %3.")
+                       .arg(statistics.storedSize).arg(statistics.dataSize)
+                       .arg(elapsedTimeString(statistics.compressionTime));
+        } else {
+            m_logger.qbsLog(LoggerInfo, true) << "\t"
+                    << Tr::tr("Loaded %1 bytes of uncompressed build graph data.")
+                       .arg(statistics.dataSize);
+        }
+    }
     project->buildData->evaluationContext = m_evalContext;
     project->setBuildConfiguration(pool.headData().projectConfig);
     project->buildDirectory = buildDir;
@@ -527,7 +541,7 @@ bool BuildGraphLoader::hasFileExistsResultChanged(const TopLevelProjectConstPtr
 {
     for (QHash<QString, bool>::ConstIterator it = restoredProject->fileExistsResults.constBegin();
          it != restoredProject->fileExistsResults.constEnd(); ++it) {
-        if (FileInfo(it.key()).exists() != it.value()) {
+        if (FileSystemCache::instance().exists(it.key()) != it.value()) {
             qCDebug(lcBuildGraph) << "Existence check for file" << it.key()
                                   << "changed, must re-resolve project.";
             return true;
@@ -541,8 +555,8 @@ bool BuildGraphLoader::hasDirectoryEntriesResultChanged(const TopLevelProjectCon
 {
     for (auto it = restoredProject->directoryEntriesResults.constBegin();
          it != restoredProject->directoryEntriesResults.constEnd(); ++it) {
-        if (QDir(it.key().first).entryList(static_cast<QDir::Filters>(it.key().second), QDir::Name)
-                != it.value()) {
+        if (FileSystemCache::instance().directoryEntries(
+                    it.key().first, static_cast<QDir::Filters>(it.key().second)) != it.value()) {
             qCDebug(lcBuildGraph) << "Entry list for directory" << it.key().first
                                   << static_cast<QDir::Filters>(it.key().second)
                                   << "changed, must re-resolve project.";
@@ -558,7 +572,7 @@ bool BuildGraphLoader::hasFileLastModifiedResultChanged(const TopLevelProjectCon
     for (QHash<QString, FileTime>::ConstIterator it
          = restoredProject->fileLastModifiedResults.constBegin();
          it != restoredProject->fileLastModifiedResults.constEnd(); ++it) {
-        if (FileInfo(it.key()).lastModified() != it.value()) {
+        if (FileSystemCache::instance().lastModified(it.key()) != it.value()) {
             qCDebug(lcBuildGraph) << "Timestamp for file" << it.key()
                                   << "changed, must re-resolve project.";
             return true;
@@ -575,7 +589,7 @@ bool BuildGraphLoader::hasProductFileChanged(const std::vector<ResolvedProductPt
     bool hasChanged = false;
     for (const ResolvedProductPtr &product : restoredProducts) {
         const QString filePath = product->location.filePath();
-        const FileInfo pfi(filePath);
+        const FileInfo pfi = FileSystemCache::instance().fileInfo(filePath);
         remainingBuildSystemFiles.remove(filePath);
         if (!pfi.exists()) {
             qCDebug(lcBuildGraph) << "A product was removed, must re-resolve project";
@@ -586,7 +600,7 @@ bool BuildGraphLoader::hasProductFileChanged(const std::vector<ResolvedProductPt
         } else if (!contains(changedProducts, product)) {
             bool foundMissingSourceFile = false;
             for (const QString &file : qAsConst(product->missingSourceFiles)) {
-                if (FileInfo(file).exists()) {
+                if (FileSystemCache::instance().exists(file)) {
                     qCDebug(lcBuildGraph) << "Formerly missing file" << file << "in product"
                                           << product->name << "exists now, must re-resolve project";
                     foundMissingSourceFile = true;
@@ -608,7 +622,8 @@ bool BuildGraphLoader::hasProductFileChanged(const std::vector<ResolvedProductPt
                             group->wildcards->dirTimeStamps.cbegin(),
                             group->wildcards->dirTimeStamps.cend(),
                             [](const std::pair<QString, FileTime> &pair) {
-                                return FileInfo(pair.first).lastModified() > pair.second;
+                                return FileSystemCache::instance().lastModified(pair.first)
+                                        > pair.second;
                 });
                 if (!reExpansionRequired)
                     continue;
@@ -634,7 +649,7 @@ bool BuildGraphLoader::hasBuildSystemFileChanged(const Set<QString> &buildSystem
                                                  const TopLevelProject *restoredProject)
 {
     for (const QString &file : buildSystemFiles) {
-        const FileInfo fi(file);
+        const FileInfo fi = FileSystemCache::instance().fileInfo(file);
         if (!fi.exists()) {
             qCDebug(lcBuildGraph) << "Project file" << file
                                   << "no longer exists, must re-resolve project.";
@@ -47,15 +47,52 @@
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
 
+#include <mutex>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
-BuildGraphNode::BuildGraphNode() : buildState(Untouched)
+namespace {
+class NodeIdPool
+{
+public:
+    static NodeIdPool &instance()
+    {
+        static NodeIdPool pool;
+        return pool;
+    }
+
+    unsigned int acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_freeIds.empty())
+            return m_nextId++;
+        const unsigned int id = m_freeIds.back();
+        m_freeIds.pop_back();
+        return id;
+    }
+
+    void release(unsigned int id)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_freeIds.push_back(id);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<unsigned int> m_freeIds;
+    unsigned int m_nextId = 0;
+};
+} // namespace
+
+BuildGraphNode::BuildGraphNode() : buildState(Untouched), m_id(NodeIdPool::instance().acquire())
 {
 }
 
 BuildGraphNode::~BuildGraphNode()
 {
+    NodeIdPool::instance().release(m_id);
     for (BuildGraphNode *p : qAsConst(parents))
         p->children.remove(this);
     for (BuildGraphNode *c : qAsConst(children))
@@ -45,6 +45,9 @@
 #include <tools/persistence.h>
 #include <tools/weakpointer.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -55,6 +58,12 @@ class BuildGraphNode
     friend NodeSet;
 public:
     virtual ~BuildGraphNode();
+    BuildGraphNode(const BuildGraphNode &) = delete;
+    BuildGraphNode &operator=(const BuildGraphNode &) = delete;
+
+    // A small number that is unique among all nodes alive in the process.
+    // The ids of deleted nodes get re-used, so they stay dense. Do not serialize.
+    unsigned int id() const { return m_id; }
 
     NodeSet parents;
     NodeSet children;
@@ -96,6 +105,42 @@ protected:
     {
         pool.serializationOp<opType>(children);
     }
+
+private:
+    const unsigned int m_id;
+};
+
+// Keeps track of the nodes seen in graph traversals. This is a bit vector indexed by node id,
+// which is a lot cheaper to query and update than a NodeSet.
+class NodeMarks
+{
+public:
+    bool contains(const BuildGraphNode *node) const
+    {
+        return node->id() < m_marks.size() && m_marks[node->id()];
+    }
+
+    // Returns false if the node was already marked.
+    bool insert(const BuildGraphNode *node)
+    {
+        if (node->id() >= m_marks.size())
+            m_marks.resize(std::max<size_t>(node->id() + 1, 2 * m_marks.size()));
+        if (m_marks[node->id()])
+            return false;
+        m_marks[node->id()] = true;
+        return true;
+    }
+
+    void remove(const BuildGraphNode *node)
+    {
+        if (node->id() < m_marks.size())
+            m_marks[node->id()] = false;
+    }
+
+    void clear() { m_marks.clear(); }
+
+private:
+    std::vector<bool> m_marks;
 };
 
 } // namespace Internal
@@ -0,0 +1,388 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "buildgraphquery.h"
+
+#include "artifact.h"
+#include "filedependency.h"
+#include "productbuilddata.h"
+#include "projectbuilddata.h"
+#include "transformer.h"
+#include "transformerchangetracking.h"
+
+#include <language/language.h>
+#include <language/property.h>
+#include <logging/translator.h>
+#include <tools/error.h>
+#include <tools/fileinfo.h>
+#include <tools/set.h>
+#include <tools/stlutils.h>
+#include <tools/stringconstants.h>
+
+#include <QtCore/qdir.h>
+
+#include <queue>
+#include <unordered_set>
+
+namespace qbs {
+namespace Internal {
+
+BuildGraphQueryEngine::BuildGraphQueryEngine(TopLevelProjectConstPtr project)
+    : m_project(std::move(project))
+{
+    m_projectsByName.insert(std::make_pair(m_project->name, m_project.get()));
+    for (const ResolvedProjectPtr &p : m_project->allSubProjects())
+        m_projectsByName.insert(std::make_pair(p->name, p.get()));
+    for (const ResolvedProductPtr &p : m_project->allProducts())
+        m_productsByName.insert(std::make_pair(p->uniqueName(), p.get()));
+}
+
+BuildGraphQueryEngine::~BuildGraphQueryEngine() = default;
+
+QStringList BuildGraphQueryEngine::query(const QString &queryName, const QStringList &arguments)
+{
+    if (!m_project->buildData)
+        throw ErrorInfo(Tr::tr("The project has no build graph."));
+    const auto checkArgumentCount = [&queryName, &arguments](int expectedCount) {
+        if (arguments.size() != expectedCount) {
+            throw ErrorInfo(Tr::tr("The query '%1' takes %2 argument(s), but %3 were given.")
+                            .arg(queryName).arg(expectedCount).arg(arguments.size()));
+        }
+    };
+    if (queryName == QLatin1String("reverse-dependencies")) {
+        checkArgumentCount(1);
+        return reverseDependencies(arguments.front());
+    }
+    if (queryName == QLatin1String("dependency-path")) {
+        checkArgumentCount(2);
+        return dependencyPath(arguments.front(), arguments.at(1));
+    }
+    if (queryName == QLatin1String("out-of-date-reasons")) {
+        checkArgumentCount(1);
+        return outOfDateReasons(arguments.front());
+    }
+    if (queryName == QLatin1String("property-users")) {
+        checkArgumentCount(1);
+        return propertyUsers(arguments.front());
+    }
+    throw ErrorInfo(Tr::tr("Unknown build graph query '%1'. The possible queries are "
+                           "'reverse-dependencies', 'dependency-path', 'out-of-date-reasons' "
+                           "and 'property-users'.").arg(queryName));
+}
+
+QStringList BuildGraphQueryEngine::reverseDependencies(const QString &filePath)
+{
+    std::unordered_set<const Artifact *> seen;
+    std::vector<const Artifact *> toVisit;
+    QStringList result;
+    const auto addDependent = [&](const Artifact *artifact) {
+        if (seen.insert(artifact).second) {
+            if (artifact->artifactType == Artifact::Generated)
+                result << artifact->filePath();
+            toVisit.push_back(artifact);
+        }
+    };
+    for (const FileResourceBase * const file : lookupFiles(filePath)) {
+        if (file->fileType() == FileResourceBase::FileTypeArtifact) {
+            const auto artifact = static_cast<const Artifact *>(file);
+            seen.insert(artifact);
+            toVisit.push_back(artifact);
+        } else {
+            for (const Artifact * const dependent
+                 : dependentsOf(static_cast<const FileDependency *>(file))) {
+                addDependent(dependent);
+            }
+        }
+    }
+    while (!toVisit.empty()) {
+        const Artifact * const artifact = toVisit.back();
+        toVisit.pop_back();
+        for (const Artifact * const parent : artifact->parentArtifacts())
+            addDependent(parent);
+    }
+    result.sort();
+    result.removeDuplicates();
+    return result;
+}
+
+QStringList BuildGraphQueryEngine::dependencyPath(const QString &fromFilePath,
+                                                  const QString &toFilePath)
+{
+    const std::vector<FileResourceBase *> &targets = lookupFiles(toFilePath);
+    const auto isTarget = [&targets](const FileResourceBase *file) {
+        return contains(targets, file);
+    };
+
+    // A breadth-first search finds a shortest path.
+    std::unordered_map<const FileResourceBase *, const FileResourceBase *> predecessors;
+    const auto pathTo = [&predecessors](const FileResourceBase *file) {
+        QStringList path;
+        for (; file; file = predecessors.at(file))
+            path.prepend(file->filePath());
+        return path;
+    };
+    std::queue<const Artifact *> queue;
+    for (const FileResourceBase * const file : lookupFiles(fromFilePath)) {
+        if (file->fileType() != FileResourceBase::FileTypeArtifact)
+            continue;
+        predecessors.emplace(file, nullptr);
+        queue.push(static_cast<const Artifact *>(file));
+    }
+    while (!queue.empty()) {
+        const Artifact * const artifact = queue.front();
+        queue.pop();
+        if (isTarget(artifact))
+            return pathTo(artifact);
+        for (const Artifact * const child : artifact->childArtifacts()) {
+            if (predecessors.emplace(child, artifact).second)
+                queue.push(child);
+        }
+        for (const FileDependency * const dependency : artifact->fileDependencies) {
+            if (predecessors.emplace(dependency, artifact).second && isTarget(dependency))
+                return pathTo(dependency);
+        }
+    }
+    return {};
+}
+
+QStringList BuildGraphQueryEngine::outOfDateReasons(const QString &filePath)
+{
+    m_artifactStaleness.clear();
+    m_currentTimestamps.clear();
+    m_project->buildData->changeTrackingCache.clear();
+    QStringList reasons;
+    QStringList possibleReasons;
+    bool isGenerated = false;
+    for (const FileResourceBase * const file : lookupFiles(filePath)) {
+        if (file->fileType() != FileResourceBase::FileTypeArtifact)
+            continue;
+        const auto artifact = static_cast<const Artifact *>(file);
+        if (artifact->artifactType != Artifact::Generated)
+            continue;
+        isGenerated = true;
+        collectOutOfDateReasons(artifact, reasons, possibleReasons);
+    }
+    m_project->buildData->changeTrackingCache.clear();
+    if (!isGenerated)
+        throw ErrorInfo(Tr::tr("The file '%1' is not generated by the project.").arg(filePath));
+    reasons.removeDuplicates();
+    possibleReasons.removeDuplicates();
+    return reasons << possibleReasons;
+}
+
+static QString propertyKey(const Property &property)
+{
+    switch (property.kind) {
+    case Property::PropertyInModule:
+        return property.moduleName + QLatin1Char('.') + property.propertyName;
+    case Property::PropertyInProduct:
+        return StringConstants::productVar() + QLatin1Char('.') + property.propertyName;
+    case Property::PropertyInProject:
+        return StringConstants::projectVar() + QLatin1Char('.') + property.propertyName;
+    default:
+        return {};
+    }
+}
+
+QStringList BuildGraphQueryEngine::propertyUsers(const QString &propertyName)
+{
+    if (!m_propertyUsersIndexed) {
+        Set<const Transformer *> seenTransformers;
+        for (const ResolvedProductPtr &product : m_project->allProducts()) {
+            if (!product->buildData)
+                continue;
+            for (const Artifact * const artifact
+                 : filterByType<Artifact>(product->buildData->allNodes())) {
+                const Transformer * const transformer = artifact->transformer.get();
+                if (!transformer || !seenTransformers.insert(transformer).second)
+                    continue;
+                Set<QString> keys;
+                const auto addKeys = [&keys](const PropertySet &properties) {
+                    for (const Property &property : properties) {
+                        const QString key = propertyKey(property);
+                        if (!key.isEmpty())
+                            keys.insert(key);
+                    }
+                };
+                addKeys(transformer->propertiesRequestedInPrepareScript);
+                addKeys(transformer->propertiesRequestedInCommands);
+                for (const PropertySet &properties
+                     : transformer->propertiesRequestedFromArtifactInPrepareScript) {
+                    addKeys(properties);
+                }
+                for (const PropertySet &properties
+                     : transformer->propertiesRequestedFromArtifactInCommands) {
+                    addKeys(properties);
+                }
+                for (const QString &key : keys)
+                    m_propertyUsersIndex[key].push_back(transformer);
+            }
+        }
+        m_propertyUsersIndexed = true;
+    }
+
+    QStringList result;
+    for (const Transformer * const transformer : m_propertyUsersIndex.value(propertyName)) {
+        QStringList outputs;
+        for (const Artifact * const output : transformer->outputs)
+            outputs << output->filePath();
+        outputs.sort();
+        result << outputs.join(QLatin1String(", "));
+    }
+    result.sort();
+    return result;
+}
+
+const std::vector<FileResourceBase *> &BuildGraphQueryEngine::lookupFiles(
+        const QString &filePath) const
+{
+    const std::vector<FileResourceBase *> &files
+            = m_project->buildData->lookupFiles(QDir::cleanPath(filePath));
+    if (files.empty())
+        throw ErrorInfo(Tr::tr("The file '%1' is not part of the build graph.").arg(filePath));
+    return files;
+}
+
+const std::vector<Artifact *> &BuildGraphQueryEngine::dependentsOf(
+        const FileDependency *dependency)
+{
+    if (!m_dependentsIndexed) {
+        for (const ResolvedProductPtr &product : m_project->allProducts()) {
+            if (!product->buildData)
+                continue;
+            for (Artifact * const artifact
+                 : filterByType<Artifact>(product->buildData->allNodes())) {
+                for (const FileDependency * const fileDependency : artifact->fileDependencies)
+                    m_dependentsIndex[fileDependency].push_back(artifact);
+            }
+        }
+        m_dependentsIndexed = true;
+    }
+    static const std::vector<Artifact *> noDependents;
+    const auto it = m_dependentsIndex.find(dependency);
+    return it != m_dependentsIndex.end() ? it->second : noDependents;
+}
+
+// Mirrors Executor::mustExecuteTransformer() and Executor::isUpToDate(), taking into account
+// that out-of-date inputs will be re-generated first. The change tracking checks are the
+// ones the build does, except that the commands a re-run prepare script would create
+// cannot be compared without running it.
+void BuildGraphQueryEngine::collectOutOfDateReasons(const Artifact *artifact,
+                                                    QStringList &reasons,
+                                                    QStringList &possibleReasons)
+{
+    if (const Transformer * const transformer = artifact->transformer.get()) {
+        const ResolvedProduct * const product = transformer->product().get();
+        if (transformer->alwaysRun)
+            reasons << Tr::tr("The rule generating '%1' is always run.").arg(artifact->filePath());
+        if (transformer->markedForRerun) {
+            reasons << Tr::tr("An always updated input of '%1' has been re-generated.")
+                       .arg(artifact->filePath());
+        }
+        if (commandsWouldRerun(transformer, product, m_productsByName, m_projectsByName)) {
+            reasons << Tr::tr("Values used by the commands generating '%1' have changed.")
+                       .arg(artifact->filePath());
+        } else if (prepareScriptWouldRerun(transformer, product, m_productsByName,
+                                           m_projectsByName)) {
+            possibleReasons << Tr::tr("'%1' may need re-generation: Values used by the prepare "
+                                      "script of its rule have changed, which may change its "
+                                      "commands.").arg(artifact->filePath());
+        }
+    }
+    if (!artifact->timestamp().isValid()) {
+        reasons << Tr::tr("'%1' has not been generated yet.").arg(artifact->filePath());
+        return;
+    }
+
+    for (const Artifact * const child : artifact->childArtifacts()) {
+        const Staleness childStaleness = child->artifactType == Artifact::Generated
+                ? staleness(child) : Staleness::UpToDate;
+        if (childStaleness == Staleness::OutOfDate) {
+            reasons << Tr::tr("The input '%1' is out of date.").arg(child->filePath());
+            continue;
+        }
+        if (childStaleness == Staleness::PossiblyOutOfDate) {
+            possibleReasons << Tr::tr("'%1' may need re-generation: Its input '%2' may be "
+                                      "re-generated.").arg(artifact->filePath(),
+                                                          child->filePath());
+        }
+        const FileTime childTimestamp = child->artifactType == Artifact::Generated
+                ? child->timestamp() : currentTimestamp(child);
+        if (!childTimestamp.isValid())
+            reasons << Tr::tr("The input '%1' does not exist.").arg(child->filePath());
+        else if (artifact->timestamp() < childTimestamp)
+            reasons << Tr::tr("The input '%1' has changed.").arg(child->filePath());
+    }
+
+    for (const FileDependency * const dependency : artifact->fileDependencies) {
+        const FileTime dependencyTimestamp = currentTimestamp(dependency);
+        if (!dependencyTimestamp.isValid()) {
+            reasons << Tr::tr("The dependency '%1' does not exist anymore.")
+                       .arg(dependency->filePath());
+        } else if (artifact->timestamp() < dependencyTimestamp) {
+            reasons << Tr::tr("The dependency '%1' has changed.").arg(dependency->filePath());
+        }
+    }
+}
+
+BuildGraphQueryEngine::Staleness BuildGraphQueryEngine::staleness(const Artifact *artifact)
+{
+    const auto it = m_artifactStaleness.find(artifact);
+    if (it != m_artifactStaleness.end())
+        return it->second;
+    QStringList reasons;
+    QStringList possibleReasons;
+    collectOutOfDateReasons(artifact, reasons, possibleReasons);
+    const Staleness result = !reasons.isEmpty() ? Staleness::OutOfDate
+            : !possibleReasons.isEmpty() ? Staleness::PossiblyOutOfDate : Staleness::UpToDate;
+    m_artifactStaleness.emplace(artifact, result);
+    return result;
+}
+
+FileTime BuildGraphQueryEngine::currentTimestamp(const FileResourceBase *file)
+{
+    auto it = m_currentTimestamps.find(file->filePath());
+    if (it == m_currentTimestamps.end()) {
+        it = m_currentTimestamps.insert(file->filePath(),
+                                        FileInfo(file->filePath()).lastModified());
+    }
+    return it.value();
+}
+
+} // namespace Internal
+} // namespace qbs
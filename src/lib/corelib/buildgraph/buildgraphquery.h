@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_BUILDGRAPHQUERY_H
+#define QBS_BUILDGRAPHQUERY_H
+
+#include "forward_decls.h"
+
+#include <language/forward_decls.h>
+#include <tools/filetime.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class Artifact;
+class FileDependency;
+class FileResourceBase;
+class Transformer;
+
+// Answers questions about the build graph of a project without visiting all of it.
+// The indexes that some queries need are built on first use, so an instance should be
+// kept around for as long as the build graph does not change.
+class QBS_AUTOTEST_EXPORT BuildGraphQueryEngine
+{
+public:
+    BuildGraphQueryEngine(TopLevelProjectConstPtr project);
+    ~BuildGraphQueryEngine();
+
+    // Runs the query with the given name, which is one of the functions below.
+    QStringList query(const QString &queryName, const QStringList &arguments);
+
+    // The generated files that directly or indirectly depend on the given file.
+    // Source files that are found on the way are not listed.
+    QStringList reverseDependencies(const QString &filePath);
+
+    // A shortest chain of dependencies leading from one file to the other, including both.
+    // Empty if the first file does not depend on the second one.
+    QStringList dependencyPath(const QString &fromFilePath, const QString &toFilePath);
+
+    // Why the next build would re-generate the given file, followed by why it might do so.
+    // The latter entries say "may" and are reported if a rule's prepare script needs to run
+    // again, as only then does the build know whether the script creates different commands.
+    // Empty if the file is known to be up to date.
+    QStringList outOfDateReasons(const QString &filePath);
+
+    // The outputs of the transformers whose scripts accessed the given property, one entry per
+    // transformer. The property is given as "<module>.<name>", "product.<name>" or
+    // "project.<name>".
+    QStringList propertyUsers(const QString &propertyName);
+
+private:
+    const std::vector<FileResourceBase *> &lookupFiles(const QString &filePath) const;
+    const std::vector<Artifact *> &dependentsOf(const FileDependency *dependency);
+    enum class Staleness { UpToDate, PossiblyOutOfDate, OutOfDate };
+
+    void collectOutOfDateReasons(const Artifact *artifact, QStringList &reasons,
+                                 QStringList &possibleReasons);
+    Staleness staleness(const Artifact *artifact);
+    FileTime currentTimestamp(const FileResourceBase *file);
+
+    const TopLevelProjectConstPtr m_project;
+
+    std::unordered_map<const FileDependency *, std::vector<Artifact *>> m_dependentsIndex;
+    bool m_dependentsIndexed = false;
+    QHash<QString, std::vector<const Transformer *>> m_propertyUsersIndex;
+    bool m_propertyUsersIndexed = false;
+    std::unordered_map<QString, const ResolvedProduct *> m_productsByName;
+    std::unordered_map<QString, const ResolvedProject *> m_projectsByName;
+
+    // Only valid during one query, as the files can change in between.
+    std::unordered_map<const Artifact *, Staleness> m_artifactStaleness;
+    QHash<QString, FileTime> m_currentTimestamps;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_BUILDGRAPHQUERY_H
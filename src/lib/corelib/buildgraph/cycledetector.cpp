@@ -39,26 +39,130 @@
 #include "cycledetector.h"
 
 #include "artifact.h"
-#include "buildgraph.h"
 #include "projectbuilddata.h"
 #include "rulenode.h"
 
 #include <language/language.h>
 #include <logging/translator.h>
 #include <tools/error.h>
+#include <tools/parallelfor.h>
 #include <tools/qttools.h>
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
 CycleDetector::CycleDetector(Logger logger)
-    : m_parent(nullptr), m_logger(std::move(logger))
+    : m_logger(std::move(logger))
 {
 }
 
+// Tarjan's algorithm. The edges are given as adjacency lists of vertex indexes.
+class StronglyConnectedComponents
+{
+public:
+    StronglyConnectedComponents(const std::vector<std::vector<int>> &edges)
+        : m_edges(edges), m_vertexData(edges.size())
+    {
+        for (int v = 0; v < int(m_edges.size()); ++v) {
+            if (m_vertexData.at(v).index == -1)
+                visit(v);
+        }
+    }
+
+    const std::vector<std::vector<int>> &components() const { return m_components; }
+
+private:
+    struct VertexData
+    {
+        int index = -1;
+        int lowLink = -1;
+        bool onStack = false;
+    };
+
+    void visit(int v)
+    {
+        VertexData &data = m_vertexData.at(v);
+        data.index = data.lowLink = m_nextIndex++;
+        m_stack.push_back(v);
+        data.onStack = true;
+        for (const int w : m_edges.at(v)) {
+            if (m_vertexData.at(w).index == -1) {
+                visit(w);
+                data.lowLink = std::min(data.lowLink, m_vertexData.at(w).lowLink);
+            } else if (m_vertexData.at(w).onStack) {
+                data.lowLink = std::min(data.lowLink, m_vertexData.at(w).index);
+            }
+        }
+        if (data.lowLink != data.index)
+            return;
+        std::vector<int> component;
+        int w;
+        do {
+            w = m_stack.back();
+            m_stack.pop_back();
+            m_vertexData.at(w).onStack = false;
+            component.push_back(w);
+        } while (w != v);
+        m_components.push_back(std::move(component));
+    }
+
+    const std::vector<std::vector<int>> &m_edges;
+    std::vector<VertexData> m_vertexData;
+    std::vector<int> m_stack;
+    std::vector<std::vector<int>> m_components;
+    int m_nextIndex = 0;
+};
+
 void CycleDetector::visitProject(const TopLevelProjectConstPtr &project)
 {
-    project->accept(this);
+    visitProducts(project->allProducts());
+}
+
+void CycleDetector::visitProducts(const std::vector<ResolvedProductPtr> &products)
+{
+    std::unordered_map<const ResolvedProduct *, int> productIndexes;
+    for (int i = 0; i < int(products.size()); ++i)
+        productIndexes.emplace(products.at(i).get(), i);
+
+    std::vector<std::vector<int>> productEdges(products.size());
+    parallelFor(products.size(), [&](size_t i) {
+        const ResolvedProduct * const product = products.at(i).get();
+        if (!product->buildData)
+            return;
+        std::vector<int> &edges = productEdges.at(i);
+        for (const BuildGraphNode * const node : qAsConst(product->buildData->allNodes())) {
+            for (const BuildGraphNode * const child : qAsConst(node->children)) {
+                const ResolvedProduct * const childProduct = child->product.get();
+                if (childProduct == product)
+                    continue;
+                const auto it = productIndexes.find(childProduct);
+                if (it != productIndexes.cend())
+                    edges.push_back(it->second);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    });
+
+    const StronglyConnectedComponents scc(productEdges);
+    const std::vector<std::vector<int>> &components = scc.components();
+    parallelFor(components.size(), [&](size_t i) {
+        Set<const ResolvedProduct *> productsInComponent;
+        for (const int productIndex : components.at(i))
+            productsInComponent.insert(products.at(productIndex).get());
+        CycleDetector detector(m_logger);
+        detector.m_productsToCheck = &productsInComponent;
+        for (const ResolvedProduct * const product : productsInComponent) {
+            if (!product->buildData)
+                continue;
+            for (BuildGraphNode * const node : qAsConst(product->buildData->allNodes()))
+                node->accept(&detector);
+        }
+    });
 }
 
 void CycleDetector::visitProduct(const ResolvedProductConstPtr &product)
@@ -76,35 +180,48 @@ bool CycleDetector::visit(RuleNode *ruleNode)
     return visitNode(ruleNode);
 }
 
+// The traversal is iterative, because it runs in worker threads, whose stacks can be too small
+// for a recursion as deep as the longest path in the build graph.
 bool CycleDetector::visitNode(BuildGraphNode *node)
 {
-    if (Q_UNLIKELY(m_nodesInCurrentPath.contains(node))) {
-        ErrorInfo error(Tr::tr("Cycle in build graph detected."));
-        const auto nodes = cycle(node);
-        for (const BuildGraphNode * const n : nodes)
+    struct PathEntry
+    {
+        BuildGraphNode *node;
+        NodeSet::const_iterator nextChild;
+    };
+    std::vector<PathEntry> path;
+    const auto enterNode = [this, &path](BuildGraphNode *n) {
+        if (Q_UNLIKELY(m_nodesInCurrentPath.contains(n))) {
+            ErrorInfo error(Tr::tr("Cycle in build graph detected."));
+            const auto cycleStart = std::find_if(path.cbegin(), path.cend(),
+                                                 [n](const PathEntry &e) { return e.node == n; });
+            for (auto it = cycleStart; it != path.cend(); ++it)
+                error.append(it->node->toString());
             error.append(n->toString());
-        throw error;
-    }
+            throw error;
+        }
+        if (m_allNodes.contains(n))
+            return;
+        m_nodesInCurrentPath.insert(n);
+        path.push_back({n, n->children.cbegin()});
+    };
 
-    if (m_allNodes.contains(node))
-        return false;
-
-    m_nodesInCurrentPath += node;
-    m_parent = node;
-    for (BuildGraphNode * const child : qAsConst(node->children))
-        child->accept(this);
-    m_nodesInCurrentPath -= node;
-    m_allNodes += node;
+    enterNode(node);
+    while (!path.empty()) {
+        PathEntry &current = path.back();
+        if (current.nextChild == current.node->children.cend()) {
+            m_nodesInCurrentPath.remove(current.node);
+            m_allNodes.insert(current.node);
+            path.pop_back();
+            continue;
+        }
+        BuildGraphNode * const child = *current.nextChild++;
+        if (m_productsToCheck && !m_productsToCheck->contains(child->product.get()))
+            continue;
+        enterNode(child);
+    }
     return false;
 }
 
-QList<BuildGraphNode *> CycleDetector::cycle(BuildGraphNode *doubleEntry)
-{
-    QList<BuildGraphNode *> path;
-    findPath(doubleEntry, m_parent, path);
-    path.push_back(doubleEntry);
-    return path;
-}
-
 } // namespace Internal
 } // namespace qbs
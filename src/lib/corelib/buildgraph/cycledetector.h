@@ -39,10 +39,13 @@
 #ifndef QBS_CYCLEDETECTOR_H
 #define QBS_CYCLEDETECTOR_H
 
+#include "buildgraphnode.h"
 #include "buildgraphvisitor.h"
-#include "nodeset.h"
 #include <language/forward_decls.h>
 #include <logging/logger.h>
+#include <tools/set.h>
+
+#include <vector>
 
 namespace qbs {
 namespace Internal {
@@ -57,17 +60,20 @@ public:
     void visitProject(const TopLevelProjectConstPtr &project);
     void visitProduct(const ResolvedProductConstPtr &product);
 
+    // A cycle involving several products can only exist within a strongly connected component
+    // of the graph formed by the edges between the products' nodes. These components
+    // are determined first, and then each of them is checked in parallel.
+    void visitProducts(const std::vector<ResolvedProductPtr> &products);
+
 private:
     bool visit(Artifact *artifact) override;
     bool visit(RuleNode *ruleNode) override;
 
     bool visitNode(BuildGraphNode *node);
 
-    QList<BuildGraphNode *> cycle(BuildGraphNode *doubleEntry);
-
-    NodeSet m_allNodes;
-    NodeSet m_nodesInCurrentPath;
-    BuildGraphNode *m_parent;
+    NodeMarks m_allNodes;
+    NodeMarks m_nodesInCurrentPath;
+    const Set<const ResolvedProduct *> *m_productsToCheck = nullptr;
     Logger m_logger;
 };
 
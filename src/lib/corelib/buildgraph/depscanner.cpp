@@ -240,7 +240,7 @@ QStringList UserDependencyScanner::evaluate(const Artifact *artifact,
     m_engine->setGlobalObject(m_global);
     QScriptValue &function = script.scriptFunction;
     if (!function.isValid() || function.engine() != m_engine) {
-        function = m_engine->evaluate(script.sourceCode());
+        function = m_engine->evaluateFunction(script.sourceCode(), script.location());
         if (Q_UNLIKELY(!function.isFunction()))
             throw ErrorInfo(Tr::tr("Invalid scan script."), script.location());
     }
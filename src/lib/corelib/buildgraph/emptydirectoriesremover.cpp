@@ -50,7 +50,13 @@ namespace Internal {
 
 EmptyDirectoriesRemover::EmptyDirectoriesRemover(const TopLevelProject *project,
                                                  Logger logger)
-    : m_project(project), m_logger(std::move(logger))
+    : EmptyDirectoriesRemover(project->buildDirectory, std::move(logger))
+{
+}
+
+// Only directories below the base directory are considered for removal.
+EmptyDirectoriesRemover::EmptyDirectoriesRemover(QString baseDirectory, Logger logger)
+    : m_baseDirectory(std::move(baseDirectory)), m_logger(std::move(logger))
 {
 }
 
@@ -93,8 +99,8 @@ void EmptyDirectoriesRemover::removeDirIfEmpty()
     const QString dirPath = m_dirsToRemove.takeFirst();
     m_handledDirs.insert(dirPath);
     QFileInfo fi(dirPath);
-    if (fi.isSymLink() || !fi.exists() || !dirPath.startsWith(m_project->buildDirectory)
-            || fi.filePath() == m_project->buildDirectory) {
+    if (fi.isSymLink() || !fi.exists() || !dirPath.startsWith(m_baseDirectory)
+            || fi.filePath() == m_baseDirectory) {
         return;
     }
     QDir dir(dirPath);
@@ -54,6 +54,7 @@ class EmptyDirectoriesRemover
 {
 public:
     EmptyDirectoriesRemover(const TopLevelProject *project, Logger logger);
+    EmptyDirectoriesRemover(QString baseDirectory, Logger logger);
     void removeEmptyParentDirectories(const QStringList &artifactFilePaths);
     void removeEmptyParentDirectories(const ArtifactSet &artifacts);
 
@@ -61,7 +62,7 @@ private:
     void insertSorted(const QString &dirPath);
     void removeDirIfEmpty();
 
-    const TopLevelProject * const m_project;
+    const QString m_baseDirectory;
     Logger m_logger;
     QStringList m_dirsToRemove;
     Set<QString> m_handledDirs;
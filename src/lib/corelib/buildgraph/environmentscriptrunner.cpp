@@ -180,10 +180,8 @@ void EnvironmentScriptRunner::setupEnvironment()
         }
         setupScriptEngineForFile(engine(), setupScript.fileContext(), m_evalContext->scope(),
                                  ObserveMode::Disabled);
-        // TODO: Cache evaluate result
-        QScriptValue fun = engine()->evaluate(setupScript.sourceCode(),
-                                              setupScript.location().filePath(),
-                                              setupScript.location().line());
+        QScriptValue fun = engine()->evaluateFunction(setupScript.sourceCode(),
+                                                      setupScript.location());
         QBS_CHECK(fun.isFunction());
         const QScriptValueList svArgs = ScriptEngine::argumentList(scriptFunctionArgs,
                                                                    m_evalContext->scope());
@@ -61,6 +61,7 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/filesystemcache.h>
 #include <tools/preferences.h>
 #include <tools/profiling.h>
 #include <tools/progressobserver.h>
@@ -111,7 +112,7 @@ Executor::~Executor()
 FileTime Executor::recursiveFileTime(const QString &filePath) const
 {
     FileTime newest;
-    FileInfo fileInfo(filePath);
+    const FileInfo fileInfo = FileSystemCache::instance().fileInfo(filePath);
     if (!fileInfo.exists()) {
         const QString nativeFilePath = QDir::toNativeSeparators(filePath);
         m_logger.qbsWarning() << Tr::tr("File '%1' not found.").arg(nativeFilePath);
@@ -120,8 +121,8 @@ FileTime Executor::recursiveFileTime(const QString &filePath) const
     newest = std::max(fileInfo.lastModified(), fileInfo.lastStatusChange());
     if (!fileInfo.isDir())
         return newest;
-    const QStringList dirContents = QDir(filePath)
-            .entryList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    const QStringList dirContents = FileSystemCache::instance().directoryEntries(
+                filePath, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
     for (const QString &curFileName : dirContents) {
         const FileTime ft = recursiveFileTime(filePath + QLatin1Char('/') + curFileName);
         if (ft > newest)
@@ -134,18 +135,43 @@ void Executor::retrieveSourceFileTimestamp(Artifact *artifact) const
 {
     QBS_CHECK(artifact->artifactType == Artifact::SourceFile);
 
-    if (m_buildOptions.changedFiles().empty())
+    if (m_buildOptions.changedFilesComplete()) {
+        // The changed files were marked as unknown in forgetChangedSourceFileTimestamps().
+        if (!artifact->timestampKnown || !artifact->timestamp().isValid()) {
+            artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
+            artifact->timestampKnown = true;
+        }
+    } else if (m_buildOptions.changedFiles().empty()) {
         artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
-    else if (m_buildOptions.changedFiles().contains(artifact->filePath()))
+        artifact->timestampKnown = true;
+    } else if (m_buildOptions.changedFiles().contains(artifact->filePath())) {
         artifact->setTimestamp(FileTime::currentTime());
-    else if (!artifact->timestamp().isValid())
+        artifact->timestampKnown = true;
+    } else if (!artifact->timestamp().isValid()) {
         artifact->setTimestamp(recursiveFileTime(artifact->filePath()));
+        artifact->timestampKnown = true;
+    }
 
     artifact->timestampRetrieved = true;
     if (!artifact->timestamp().isValid())
         throw ErrorInfo(Tr::tr("Source file '%1' has disappeared.").arg(artifact->filePath()));
 }
 
+// Source files in other products than the ones to build are affected as well, so that their
+// timestamps get retrieved once these products are built.
+void Executor::forgetChangedSourceFileTimestamps()
+{
+    for (const QString &filePath : m_buildOptions.changedFiles()) {
+        for (FileResourceBase * const file : m_project->buildData->lookupFiles(filePath)) {
+            if (file->fileType() != FileResourceBase::FileTypeArtifact)
+                continue;
+            auto const artifact = static_cast<Artifact *>(file);
+            if (artifact->artifactType == Artifact::SourceFile)
+                artifact->timestampKnown = false;
+        }
+    }
+}
+
 void Executor::build()
 {
     try {
@@ -230,8 +256,12 @@ void Executor::doBuild()
     m_productsOfFilesToConsider.clear();
     m_artifactsRemovedFromDisk.clear();
     m_jobCountPerPool.clear();
+    m_expectedMemoryUsage = 0;
+    m_project->buildData->changeTrackingCache.clear();
 
     setupJobLimits();
+    if (m_buildOptions.changedFilesComplete())
+        forgetChangedSourceFileTimestamps();
 
     // TODO: The "filesToConsider" thing is badly designed; we should know exactly which artifact
     //       it is. Remove this from the BuildOptions class and introduce Project::buildSomeFiles()
@@ -279,13 +309,18 @@ void Executor::doBuild()
         m_productInstaller->removeInstallRoot();
 
     addExecutorJobs();
-    syncFileDependencies();
-    prepareAllNodes();
-    prepareProducts();
-    setupRootNodes();
-    prepareReachableNodes();
-    setupProgressObserver();
-    initLeaves();
+    {
+        // Source files and file dependencies are not written to by the build, so their
+        // metadata can be shared between products until the first command runs.
+        const FileSystemCache::Scope fileSystemCacheScope;
+        syncFileDependencies();
+        prepareAllNodes();
+        prepareProducts();
+        setupRootNodes();
+        prepareReachableNodes();
+        setupProgressObserver();
+        initLeaves();
+    }
     if (!scheduleJobs()) {
         qCDebug(lcExec) << "Nothing to do at all, finishing.";
         QTimer::singleShot(0, this, &Executor::finish); // Don't call back on the caller.
@@ -307,14 +342,14 @@ void Executor::initLeaves()
 
 void Executor::updateLeaves(const NodeSet &nodes)
 {
-    NodeSet seenNodes;
+    NodeMarks seenNodes;
     for (BuildGraphNode * const node : nodes)
         updateLeaves(node, seenNodes);
 }
 
-void Executor::updateLeaves(BuildGraphNode *node, NodeSet &seenNodes)
+void Executor::updateLeaves(BuildGraphNode *node, NodeMarks &seenNodes)
 {
-    if (!seenNodes.insert(node).second)
+    if (!seenNodes.insert(node))
         return;
 
     // Artifacts that appear in the build graph after
@@ -364,6 +399,10 @@ bool Executor::scheduleJobs()
                 qCDebug(lcExec).noquote() << "node delayed due to occupied job pool:"
                                           << nodeToBuild->toString();
                 delayedLeaves.push_back(nodeToBuild);
+            } else if (schedulingBlockedByMemoryBudget(nodeToBuild)) {
+                qCDebug(lcExec).noquote() << "node delayed due to memory budget:"
+                                          << nodeToBuild->toString();
+                delayedLeaves.push_back(nodeToBuild);
             } else {
                 nodeToBuild->accept(this);
             }
@@ -423,6 +462,26 @@ bool Executor::schedulingBlockedByJobLimit(const BuildGraphNode *node)
     return false;
 }
 
+static qint64 expectedMemoryUsage(const Transformer *transformer)
+{
+    return std::max<qint64>(transformer->resourceUsage.peakMemoryUsage, 0);
+}
+
+// The expected memory usage is what the transformer's commands used in the previous run.
+// There is no such data for transformers that have never run; these are not restricted.
+bool Executor::schedulingBlockedByMemoryBudget(const BuildGraphNode *node)
+{
+    const qint64 budget = qint64(m_buildOptions.memoryBudget()) * 1024 * 1024;
+    if (budget <= 0 || m_processingJobs.empty())
+        return false;
+    if (node->type() != BuildGraphNode::ArtifactNodeType)
+        return false;
+    const auto artifact = static_cast<const Artifact *>(node);
+    if (artifact->artifactType == Artifact::SourceFile)
+        return false;
+    return m_expectedMemoryUsage + expectedMemoryUsage(artifact->transformer.get()) > budget;
+}
+
 bool Executor::isUpToDate(Artifact *artifact) const
 {
     QBS_CHECK(artifact->artifactType == Artifact::Generated);
@@ -564,6 +623,8 @@ void Executor::finishJob(ExecutorJob *job, bool success)
     m_processingJobs.erase(it);
     m_availableJobs.push_back(job);
     updateJobCounts(transformer.get(), -1);
+    if (job->resourceUsage().isValid())
+        transformer->resourceUsage = job->resourceUsage();
     if (success) {
         m_project->buildData->setDirty();
         for (Artifact * const artifact : qAsConst(transformer->outputs)) {
@@ -714,6 +775,7 @@ void Executor::updateJobCounts(const Transformer *transformer, int diff)
 {
     for (const QString &jobPool : transformer->jobPools())
         m_jobCountPerPool[jobPool] += diff;
+    m_expectedMemoryUsage += diff * expectedMemoryUsage(transformer);
 }
 
 void Executor::cancelJobs()
@@ -774,9 +836,11 @@ void Executor::addExecutorJobs()
         job->setObjectName(QStringLiteral("J%1").arg(i));
         job->setDryRun(m_buildOptions.dryRun());
         job->setEchoMode(m_buildOptions.echoMode());
+        job->setStreamProcessOutput(m_buildOptions.streamProcessOutput());
         m_availableJobs.push_back(job);
         connect(job, &ExecutorJob::reportCommandDescription,
                 this, &Executor::reportCommandDescription);
+        connect(job, &ExecutorJob::reportProcessOutput, this, &Executor::reportProcessOutput);
         connect(job, &ExecutorJob::reportProcessResult, this, &Executor::reportProcessResult);
         connect(job, &ExecutorJob::finished,
                 this, &Executor::onJobFinished, Qt::QueuedConnection);
@@ -1048,6 +1112,24 @@ void Executor::possiblyInstallArtifact(const Artifact *artifact)
     }
 }
 
+// Only a complete and successful build has seen all installable artifacts, so only then
+// do we know which of the previously installed files are stale.
+void Executor::possiblyRemoveStaleInstalledFiles()
+{
+    if (!m_productInstaller || !m_buildOptions.install() || m_buildOptions.executeRulesOnly()
+            || !m_activeFileTags.empty() || !m_buildOptions.filesToConsider().empty()
+            || m_explicitlyCanceled || m_error.hasError()) {
+        return;
+    }
+    AccumulatingTimer installTimer(m_buildOptions.logElapsedTime()
+                                   ? &m_elapsedTimeInstalling : nullptr);
+    try {
+        m_productInstaller->removeStaleFiles();
+    } catch (const ErrorInfo &error) {
+        m_error = error;
+    }
+}
+
 void Executor::onJobFinished(const qbs::ErrorInfo &err)
 {
     try {
@@ -1137,6 +1219,7 @@ void Executor::finish()
     QBS_ASSERT(!m_evalContext || !m_evalContext->engine()->isActive(), /* ignore */);
 
     checkForUnbuiltProducts();
+    possiblyRemoveStaleInstalledFiles();
     if (m_explicitlyCanceled) {
         QString message = Tr::tr(m_buildOptions.executeRulesOnly()
                                  ? "Rule execution canceled" : "Build canceled");
@@ -1150,6 +1233,7 @@ void Executor::finish()
 
     EmptyDirectoriesRemover(m_project.get(), m_logger)
             .removeEmptyParentDirectories(m_artifactsRemovedFromDisk);
+    m_project->buildData->changeTrackingCache.clear();
 
     if (m_buildOptions.logElapsedTime()) {
         m_logger.qbsLog(LoggerInfo, true) << "\t" << Tr::tr("Rule execution took %1.")
@@ -1216,7 +1300,7 @@ void Executor::syncFileDependencies()
     Set<FileDependency *> &globalFileDepList = m_project->buildData->fileDependencies;
     for (auto it = globalFileDepList.begin(); it != globalFileDepList.end(); ) {
         FileDependency * const dep = *it;
-        FileInfo fi(dep->filePath());
+        const FileInfo fi = FileSystemCache::instance().fileInfo(dep->filePath());
         if (fi.exists()) {
             dep->setTimestamp(fi.lastModified());
             ++it;
@@ -89,6 +89,7 @@ public:
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const qbs::ProcessResult &result);
     void reportProcessResult(const qbs::ProcessResult &result);
 
     void finished();
@@ -123,7 +124,7 @@ private:
     void setupRootNodes();
     void initLeaves();
     void updateLeaves(const NodeSet &nodes);
-    void updateLeaves(BuildGraphNode *node, NodeSet &seenNodes);
+    void updateLeaves(BuildGraphNode *node, NodeMarks &seenNodes);
     bool scheduleJobs();
     void buildArtifact(Artifact *artifact);
     void executeRuleNode(RuleNode *ruleNode);
@@ -142,12 +143,14 @@ private:
     void runTransformer(const TransformerPtr &transformer);
     void finishTransformer(const TransformerPtr &transformer);
     void possiblyInstallArtifact(const Artifact *artifact);
+    void possiblyRemoveStaleInstalledFiles();
     void checkForUnbuiltProducts();
     bool checkNodeProduct(BuildGraphNode *node);
 
     bool mustExecuteTransformer(const TransformerPtr &transformer) const;
     bool isUpToDate(Artifact *artifact) const;
     void retrieveSourceFileTimestamp(Artifact *artifact) const;
+    void forgetChangedSourceFileTimestamps();
     FileTime recursiveFileTime(const QString &filePath) const;
     QString configString() const;
     bool transformerHasMatchingOutputTags(const TransformerConstPtr &transformer) const;
@@ -157,6 +160,7 @@ private:
     void setupJobLimits();
     void updateJobCounts(const Transformer *transformer, int diff);
     bool schedulingBlockedByJobLimit(const BuildGraphNode *node);
+    bool schedulingBlockedByMemoryBudget(const BuildGraphNode *node);
 
     using JobMap = QHash<ExecutorJob *, TransformerPtr>;
     JobMap m_processingJobs;
@@ -175,6 +179,7 @@ private:
     std::unordered_map<QString, const ResolvedProduct *> m_productsByName;
     std::unordered_map<QString, const ResolvedProject *> m_projectsByName;
     std::unordered_map<QString, int> m_jobCountPerPool;
+    qint64 m_expectedMemoryUsage = 0;
     std::unordered_map<const ResolvedProduct *, JobLimits> m_jobLimitsPerProduct;
     std::unordered_map<const Rule *, int> m_pendingTransformersPerRule;
     NodeSet m_roots;
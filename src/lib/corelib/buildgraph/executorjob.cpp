@@ -60,6 +60,8 @@ ExecutorJob::ExecutorJob(const Logger &logger, QObject *parent)
 {
     connect(m_processCommandExecutor, &AbstractCommandExecutor::reportCommandDescription,
             this, &ExecutorJob::reportCommandDescription);
+    connect(m_processCommandExecutor, &ProcessCommandExecutor::reportProcessOutput,
+            this, &ExecutorJob::reportProcessOutput);
     connect(m_processCommandExecutor, &ProcessCommandExecutor::reportProcessResult,
             this, &ExecutorJob::reportProcessResult);
     connect(m_processCommandExecutor, &AbstractCommandExecutor::finished,
@@ -91,6 +93,11 @@ void ExecutorJob::setEchoMode(CommandEchoMode echoMode)
     m_jsCommandExecutor->setEchoMode(echoMode);
 }
 
+void ExecutorJob::setStreamProcessOutput(bool stream)
+{
+    m_processCommandExecutor->setStreamOutput(stream);
+}
+
 void ExecutorJob::run(Transformer *t)
 {
     QBS_ASSERT(m_currentCommandIdx == -1, return);
@@ -112,6 +119,7 @@ void ExecutorJob::run(Transformer *t)
                 (*t->outputs.cbegin())->product->buildEnvironment);
     m_transformer = t;
     m_jobPools = t->jobPools();
+    m_resourceUsage = ProcessResourceUsage();
     runNextCommand();
 }
 
@@ -150,6 +158,8 @@ void ExecutorJob::runNextCommand()
 void ExecutorJob::onCommandFinished(const ErrorInfo &err)
 {
     QBS_ASSERT(m_transformer, return);
+    if (m_currentCommandExecutor == m_processCommandExecutor)
+        m_resourceUsage.accumulate(m_processCommandExecutor->resourceUsage());
     if (m_error.hasError()) { // Canceled?
         setFinished();
     } else if (err.hasError()) {
@@ -43,6 +43,7 @@
 #include <language/forward_decls.h>
 #include <tools/commandechomode.h>
 #include <tools/error.h>
+#include <tools/processresourceusage.h>
 #include <tools/set.h>
 
 #include <QtCore/qobject.h>
@@ -71,13 +72,16 @@ public:
     void setMainThreadScriptEngine(ScriptEngine *engine);
     void setDryRun(bool enabled);
     void setEchoMode(CommandEchoMode echoMode);
+    void setStreamProcessOutput(bool stream);
     void run(Transformer *t);
     void cancel();
     const Transformer *transformer() const { return m_transformer; }
     Set<QString> jobPools() const { return m_jobPools; }
+    ProcessResourceUsage resourceUsage() const { return m_resourceUsage; }
 
 signals:
     void reportCommandDescription(const QString &highlight, const QString &message);
+    void reportProcessOutput(const qbs::ProcessResult &result);
     void reportProcessResult(const qbs::ProcessResult &result);
     void finished(const qbs::ErrorInfo &error = ErrorInfo()); // !hasError() <=> command successful
 
@@ -94,6 +98,7 @@ private:
     Transformer *m_transformer = nullptr;
     Set<QString> m_jobPools;
     int m_currentCommandIdx = 0;
+    ProcessResourceUsage m_resourceUsage;
     ErrorInfo m_error;
 };
 
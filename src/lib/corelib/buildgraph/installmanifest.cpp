@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "installmanifest.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qfile.h>
+
+namespace qbs {
+namespace Internal {
+
+/*!
+ * \class InstallManifest
+ * \brief The \c InstallManifest class is the persistent record of the files installed
+ *        for a project.
+ * Every entry maps a target file path to the artifact it was copied from, together with the
+ * timestamps of source and target at the time of copying and a digest of the copied content.
+ */
+
+/*!
+ * Returns a digest of the content of the file at \a filePath, or an empty byte array if the
+ * file cannot be read. The file is hashed in chunks, so arbitrarily large files can be digested
+ * without reading them into memory.
+ */
+QByteArray InstallManifest::fileDigest(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return {};
+    return hash.result();
+}
+
+const InstallManifest::Entry *InstallManifest::entry(const QString &targetFilePath) const
+{
+    const auto it = m_entries.constFind(targetFilePath);
+    return it != m_entries.constEnd() ? &it.value() : nullptr;
+}
+
+void InstallManifest::insert(const Entry &entry)
+{
+    m_entries.insert(entry.targetFilePath, entry);
+}
+
+bool InstallManifest::remove(const QString &targetFilePath)
+{
+    return m_entries.remove(targetFilePath) > 0;
+}
+
+/*!
+ * Returns the entries for files that are located in \a installRoot.
+ */
+std::vector<InstallManifest::Entry> InstallManifest::entries(const QString &installRoot) const
+{
+    const QString prefix = installRoot.endsWith(QLatin1Char('/'))
+            ? installRoot : installRoot + QLatin1Char('/');
+    std::vector<Entry> result;
+    for (const Entry &e : m_entries) {
+        if (e.targetFilePath.startsWith(prefix))
+            result.push_back(e);
+    }
+    return result;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_INSTALLMANIFEST_H
+#define QBS_INSTALLMANIFEST_H
+
+#include <tools/filetime.h>
+#include <tools/persistence.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// Records which files were installed into which location, so that subsequent install operations
+// only need to copy what has changed and can remove what is no longer installed.
+class QBS_AUTOTEST_EXPORT InstallManifest
+{
+public:
+    class Entry
+    {
+    public:
+        template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
+        {
+            pool.serializationOp<opType>(productName, sourceFilePath, targetFilePath,
+                                         sourceTimestamp, targetTimestamp, digest);
+        }
+
+        QString productName; // ResolvedProduct::uniqueName()
+        QString sourceFilePath;
+        QString targetFilePath;
+        FileTime sourceTimestamp;
+        FileTime targetTimestamp;
+        QByteArray digest; // Empty for directories and symlinks.
+    };
+
+    static QByteArray fileDigest(const QString &filePath);
+
+    const Entry *entry(const QString &targetFilePath) const;
+    void insert(const Entry &entry);
+    bool remove(const QString &targetFilePath);
+    std::vector<Entry> entries(const QString &installRoot) const;
+    bool isEmpty() const { return m_entries.isEmpty(); }
+
+    template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
+    {
+        pool.serializationOp<opType>(m_entries);
+    }
+
+private:
+    QHash<QString, Entry> m_entries; // Key is the target file path.
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_INSTALLMANIFEST_H
@@ -45,9 +45,11 @@
 #include "rulecommands.h"
 #include "transformer.h"
 
+#include <jsextensions/jsextensions.h>
 #include <language/language.h>
 #include <language/preparescriptobserver.h>
 #include <language/resolvedfilecontext.h>
+#include <language/scriptbackend.h>
 #include <language/scriptengine.h>
 #include <logging/logger.h>
 #include <tools/codelocation.h>
@@ -60,6 +62,9 @@
 #include <QtCore/qthread.h>
 #include <QtCore/qtimer.h>
 
+#include <memory>
+#include <unordered_map>
+
 namespace qbs {
 namespace Internal {
 
@@ -76,7 +81,6 @@ class JsCommandExecutorThreadObject : public QObject
 public:
     JsCommandExecutorThreadObject(Logger logger)
         : m_logger(std::move(logger))
-        , m_scriptEngine(nullptr)
     {
     }
 
@@ -89,8 +93,8 @@ public:
     {
         m_result.success = !reason.hasError();
         m_result.errorMessage = reason.toString();
-        if (m_scriptEngine)
-            m_scriptEngine->abortEvaluation();
+        if (m_scriptBackend)
+            m_scriptBackend->abortEvaluation();
         m_cancelled = true;
     }
 
@@ -121,37 +125,36 @@ private:
     {
         m_result.success = true;
         m_result.errorMessage.clear();
-        ScriptEngine * const scriptEngine = provideScriptEngine();
-        QScriptValue scope = scriptEngine->newObject();
-        scope.setPrototype(scriptEngine->globalObject());
-        m_scriptEngine->clearRequestedProperties();
-        setupScriptEngineForFile(scriptEngine,
-                                 transformer->rule->prepareScript.fileContext(), scope,
-                                 ObserveMode::Enabled);
-
-        QScriptValue importScopeForSourceCode;
+        ScriptBackend * const backend = provideScriptBackend();
+        ScriptEngine * const scriptEngine = backend->engine();
+        const ScriptValue globalObject = backend->globalObject();
+        ScriptValue scope = backend->newObject();
+        scriptEngine->clearRequestedProperties();
+        scope.setPrototype(fileScope(transformer->rule->prepareScript.fileContext()));
+
+        ScriptValue importScopeForSourceCode;
         if (!cmd->scopeName().isEmpty())
             importScopeForSourceCode = scope.property(cmd->scopeName());
 
         setupScriptEngineForProduct(scriptEngine, transformer->product().get(),
-                                    transformer->rule->module.get(), scope, true);
-        transformer->setupInputs(scope);
-        transformer->setupOutputs(scope);
-        transformer->setupExplicitlyDependsOn(scope);
+                                    transformer->rule->module.get(), scope.toQtScript(), true);
+        transformer->setupInputs(scope.toQtScript());
+        transformer->setupOutputs(scope.toQtScript());
+        transformer->setupExplicitlyDependsOn(scope.toQtScript());
 
         for (QVariantMap::const_iterator it = cmd->properties().constBegin();
                 it != cmd->properties().constEnd(); ++it) {
-            scope.setProperty(it.key(), scriptEngine->toScriptValue(it.value()));
+            scope.setProperty(it.key(), backend->toScriptValue(it.value()));
         }
 
-        scriptEngine->setGlobalObject(scope);
+        backend->setGlobalObject(scope);
         if (importScopeForSourceCode.isObject())
-            scriptEngine->currentContext()->pushScope(importScopeForSourceCode);
-        scriptEngine->evaluate(cmd->sourceCode());
+            backend->pushScope(importScopeForSourceCode);
+        backend->evaluate(program(cmd->sourceCode()));
         scriptEngine->releaseResourcesOfScriptObjects();
         if (importScopeForSourceCode.isObject())
-            scriptEngine->currentContext()->popScope();
-        scriptEngine->setGlobalObject(scope.prototype());
+            backend->popScope();
+        backend->setGlobalObject(globalObject);
         transformer->propertiesRequestedInCommands
                 += scriptEngine->propertiesRequestedInScript();
         unite(transformer->propertiesRequestedFromArtifactInCommands,
@@ -168,9 +171,9 @@ private:
                         std::make_pair(p->uniqueName(), p->exportedModule));
         }
         scriptEngine->clearRequestedProperties();
-        if (scriptEngine->hasUncaughtException()) {
+        if (backend->hasUncaughtException()) {
             // ### We don't know the line number of the command's sourceCode property assignment.
-            setError(scriptEngine->uncaughtException().toString(), cmd->codeLocation());
+            setError(backend->uncaughtException().toString(), cmd->codeLocation());
         }
     }
 
@@ -181,15 +184,41 @@ private:
         m_result.errorLocation = codeLocation;
     }
 
-    ScriptEngine *provideScriptEngine()
+    ScriptBackend *provideScriptBackend()
+    {
+        if (!m_scriptBackend)
+            m_scriptBackend = ScriptBackend::create(m_logger, EvalContext::JsCommand);
+        return m_scriptBackend.get();
+    }
+
+    // The imports and JS extensions of a rule's file are the same for all of its commands,
+    // so they are set up only once per engine and shared via the prototype chain.
+    ScriptValue fileScope(const ResolvedFileContextConstPtr &fileContext)
+    {
+        ScriptValue &scope = m_fileScopes[fileContext];
+        if (!scope.isValid()) {
+            scope = m_scriptBackend->newObject();
+            scope.setPrototype(m_scriptBackend->globalObject());
+            m_scriptBackend->import(fileContext, scope, ObserveMode::Enabled);
+            JsExtensions::setupExtensions(fileContext->jsExtensions(), scope.toQtScript());
+        }
+        return scope;
+    }
+
+    // Commands created by the same rule share their source code, which therefore needs to be
+    // compiled only once.
+    const ScriptProgram &program(const QString &sourceCode)
     {
-        if (!m_scriptEngine)
-            m_scriptEngine = ScriptEngine::create(m_logger, EvalContext::JsCommand, this);
-        return m_scriptEngine;
+        ScriptProgram &program = m_programs[sourceCode];
+        if (program.isNull())
+            program = m_scriptBackend->compile(sourceCode, CodeLocation());
+        return program;
     }
 
     Logger m_logger;
-    ScriptEngine *m_scriptEngine;
+    std::unique_ptr<ScriptBackend> m_scriptBackend;
+    std::unordered_map<ResolvedFileContextConstPtr, ScriptValue> m_fileScopes;
+    QHash<QString, ScriptProgram> m_programs;
     JavaScriptCommandResult m_result;
     bool m_running = false;
     bool m_cancelled = false;
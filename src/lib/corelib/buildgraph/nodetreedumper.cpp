@@ -114,7 +114,7 @@ bool NodeTreeDumper::doVisit(BuildGraphNode *node, const QString &nodeRepr)
     m_outDevice.write(indentation());
     m_outDevice.write(nodeRepr.toLocal8Bit());
     indent();
-    const bool wasVisited = !m_visited.insert(node).second;
+    const bool wasVisited = !m_visited.insert(node);
     return !wasVisited && node->product == m_currentProduct;
 }
 
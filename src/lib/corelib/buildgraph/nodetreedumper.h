@@ -73,7 +73,7 @@ private:
 
     QIODevice &m_outDevice;
     ResolvedProductPtr m_currentProduct;
-    NodeSet m_visited;
+    NodeMarks m_visited;
     int m_indentation = 0;
 };
 
@@ -67,6 +67,8 @@
 
 #include <QtScript/qscriptvalue.h>
 
+#include <algorithm>
+
 namespace qbs {
 namespace Internal {
 
@@ -77,6 +79,10 @@ ProcessCommandExecutor::ProcessCommandExecutor(const Logger &logger, QObject *pa
             this, &ProcessCommandExecutor::onProcessError);
     connect(&m_process, static_cast<void (QbsProcess::*)(int)>(&QbsProcess::finished),
             this, &ProcessCommandExecutor::onProcessFinished);
+    connect(&m_process, &QbsProcess::readyReadStandardOutput,
+            this, [this] { onProcessOutput(true); });
+    connect(&m_process, &QbsProcess::readyReadStandardError,
+            this, [this] { onProcessOutput(false); });
 }
 
 static QProcessEnvironment mergeEnvironments(const QProcessEnvironment &baseEnv,
@@ -191,6 +197,19 @@ bool ProcessCommandExecutor::doStart()
         }
     }
 
+    // Filter functions and redirections need to see the complete output, so such channels
+    // are always buffered.
+    for (const bool stdOut : {true, false}) {
+        OutputChannel &channel = outputChannel(stdOut);
+        channel.buffer.clear();
+        channel.pendingLine.clear();
+        channel.streamed = m_streamOutput
+                && (stdOut ? cmd->stdoutFilterFunction().isEmpty()
+                             && cmd->stdoutFilePath().isEmpty()
+                           : cmd->stderrFilterFunction().isEmpty()
+                             && cmd->stderrFilePath().isEmpty());
+    }
+
     qCDebug(lcExec) << "Running external process; full command line is:" << m_shellInvocation;
     const QProcessEnvironment &additionalVariables = cmd->environment();
     qCDebug(lcExec) << "Additional environment:" << additionalVariables.toStringList();
@@ -202,6 +221,7 @@ bool ProcessCommandExecutor::doStart()
 void ProcessCommandExecutor::cancel(const qbs::ErrorInfo &reason)
 {
     // We don't want this command to be reported as failing, since we explicitly terminated it.
+    disconnect(this, &ProcessCommandExecutor::reportProcessOutput, nullptr, nullptr);
     disconnect(this, &ProcessCommandExecutor::reportProcessResult, nullptr, nullptr);
 
     m_cancelReason = reason;
@@ -259,46 +279,145 @@ static QProcess::ProcessError saveToFile(const QString &filePath, const QByteArr
     return f.error() == QFileDevice::NoError ? QProcess::UnknownError : QProcess::WriteError;
 }
 
+static QStringList outputLines(const QByteArray &content)
+{
+    QString contentString = QString::fromLocal8Bit(content);
+    if (!contentString.isEmpty() && contentString.endsWith(QLatin1Char('\n')))
+        contentString.chop(1);
+    return contentString.split(QLatin1Char('\n'), QBS_SKIP_EMPTY_PARTS);
+}
+
+// Output that does not contain any line breaks, such as progress indicators using carriage
+// returns, is reported in pieces of this size, so that the pending data stays bounded.
+static const int maxPendingLineSize = 64 * 1024;
+
+// Does not split multi-byte UTF-8 sequences, if possible.
+static int partialLineLength(const QByteArray &pendingLine)
+{
+    int length = std::min(pendingLine.size(), maxPendingLineSize);
+    if (length == pendingLine.size())
+        return length;
+    int boundary = length;
+    while (boundary > length - 4 && boundary > 0
+           && (uchar(pendingLine.at(boundary)) & 0xc0) == 0x80) {
+        --boundary;
+    }
+    return boundary > 0 ? boundary : length;
+}
+
+// Moves the complete lines from the pending data into the target list. If atEnd is true,
+// the remaining data is moved as well. Lines are split into pieces only for streamed output,
+// which must not wait for a line break indefinitely; everything else gets whole lines.
+static void takeLines(QByteArray &pendingLine, QStringList &target, bool atEnd,
+                      bool splitLongLines)
+{
+    const int lastNewline = pendingLine.lastIndexOf('\n');
+    if (lastNewline != -1) {
+        target << outputLines(pendingLine.left(lastNewline + 1));
+        pendingLine.remove(0, lastNewline + 1);
+    }
+    while (splitLongLines && pendingLine.size() >= maxPendingLineSize) {
+        const int length = partialLineLength(pendingLine);
+        target << QString::fromLocal8Bit(pendingLine.constData(), length);
+        pendingLine.remove(0, length);
+    }
+    if (atEnd && !pendingLine.isEmpty()) {
+        target << outputLines(pendingLine);
+        pendingLine.clear();
+    }
+}
+
+void ProcessCommandExecutor::onProcessOutput(bool stdOut)
+{
+    const QByteArray data = stdOut ? m_process.readAllStandardOutput()
+                                   : m_process.readAllStandardError();
+    OutputChannel &channel = outputChannel(stdOut);
+    if (!channel.streamed) {
+        channel.buffer.append(data);
+        return;
+    }
+
+    // Only complete lines are reported; the rest waits for more data or the end of the process.
+    channel.pendingLine.append(data);
+    QStringList lines;
+    takeLines(channel.pendingLine, lines, false, true);
+    if (lines.empty())
+        return;
+    ProcessResult result;
+    initProcessResult(result);
+    result.d->success = true;
+    (stdOut ? result.d->stdOut : result.d->stdErr) = lines;
+    emit reportProcessOutput(result);
+}
+
 void ProcessCommandExecutor::getProcessOutput(bool stdOut, ProcessResult &result)
 {
-    QByteArray content;
-    QString filterFunction;
-    QString redirectPath;
-    QStringList *target;
-    if (stdOut) {
-        content = m_process.readAllStandardOutput();
-        filterFunction = processCommand()->stdoutFilterFunction();
-        redirectPath = processCommand()->stdoutFilePath();
-        target = &result.d->stdOut;
-    } else {
-        content = m_process.readAllStandardError();
-        filterFunction = processCommand()->stderrFilterFunction();
-        redirectPath = processCommand()->stderrFilePath();
-        target = &result.d->stdErr;
+    OutputChannel &channel = outputChannel(stdOut);
+    channel.buffer.append(stdOut ? m_process.readAllStandardOutput()
+                                 : m_process.readAllStandardError());
+    QStringList &target = stdOut ? result.d->stdOut : result.d->stdErr;
+    const auto readLines = [&channel, &target] {
+        channel.buffer.readChunks([&channel, &target](const QByteArray &chunk) {
+            channel.pendingLine.append(chunk);
+            takeLines(channel.pendingLine, target, false, channel.streamed);
+        });
+        takeLines(channel.pendingLine, target, true, channel.streamed);
+        channel.buffer.clear();
+    };
+    if (channel.streamed) {
+        readLines();
+        return;
     }
+
+    const QString filterFunction = stdOut ? processCommand()->stdoutFilterFunction()
+                                          : processCommand()->stderrFilterFunction();
+    const QString redirectPath = stdOut ? processCommand()->stdoutFilePath()
+                                        : processCommand()->stderrFilePath();
+    if (!redirectPath.isEmpty() && filterFunction.isEmpty()) {
+        // Unfiltered output goes to the file as-is, without a detour through memory.
+        if (!channel.buffer.saveToFile(redirectPath)
+                && result.error() == QProcess::UnknownError) {
+            result.d->error = QProcess::WriteError;
+        }
+        channel.buffer.clear();
+        return;
+    }
+
+    if (filterFunction.isEmpty()) {
+        readLines();
+        return;
+    }
+
+    // The filter function needs to see the complete output.
+    const QByteArray content = channel.buffer.readAll();
+    channel.buffer.clear();
     QString contentString = filterProcessOutput(content, filterFunction);
     if (!redirectPath.isEmpty()) {
-        const QByteArray dataToWrite = filterFunction.isEmpty() ? content
-                                                                : contentString.toLocal8Bit();
-        const QProcess::ProcessError error = saveToFile(redirectPath, dataToWrite);
+        const QProcess::ProcessError error = saveToFile(redirectPath, contentString.toLocal8Bit());
         if (result.error() == QProcess::UnknownError && error != QProcess::UnknownError)
             result.d->error = error;
     } else {
         if (!contentString.isEmpty() && contentString.endsWith(QLatin1Char('\n')))
             contentString.chop(1);
-        *target = contentString.split(QLatin1Char('\n'), QBS_SKIP_EMPTY_PARTS);
+        target = contentString.split(QLatin1Char('\n'), QBS_SKIP_EMPTY_PARTS);
     }
 }
 
-void ProcessCommandExecutor::sendProcessOutput()
+void ProcessCommandExecutor::initProcessResult(ProcessResult &result) const
 {
-    ProcessResult result;
     result.d->executableFilePath = m_program;
     result.d->arguments = m_arguments;
     result.d->workingDirectory = m_process.workingDirectory();
     if (result.workingDirectory().isEmpty())
         result.d->workingDirectory = QDir::currentPath();
+}
+
+void ProcessCommandExecutor::sendProcessOutput()
+{
+    ProcessResult result;
+    initProcessResult(result);
     result.d->exitCode = m_process.exitCode();
+    result.d->resourceUsage = m_process.resourceUsage();
     result.d->error = m_process.error();
     QString errorString = m_process.errorString();
 
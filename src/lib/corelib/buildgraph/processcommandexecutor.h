@@ -43,6 +43,7 @@
 
 #include "abstractcommandexecutor.h"
 
+#include <tools/processoutputbuffer.h>
 #include <tools/qbsprocess.h>
 
 #include <QtCore/qstring.h>
@@ -62,13 +63,24 @@ public:
     void setProcessEnvironment(const QProcessEnvironment &processEnvironment) {
         m_buildEnvironment = processEnvironment;
     }
+    void setStreamOutput(bool stream) { m_streamOutput = stream; }
+    ProcessResourceUsage resourceUsage() const { return m_process.resourceUsage(); }
 
 signals:
+    void reportProcessOutput(const qbs::ProcessResult &result);
     void reportProcessResult(const qbs::ProcessResult &result);
 
 private:
+    struct OutputChannel
+    {
+        ProcessOutputBuffer buffer;
+        QByteArray pendingLine;
+        bool streamed = false;
+    };
+
     void onProcessError();
     void onProcessFinished();
+    void onProcessOutput(bool stdOut);
 
     void doSetup() override;
     void doReportCommandDescription(const QString &productName) override;
@@ -78,6 +90,8 @@ private:
     void startProcessCommand();
     QString filterProcessOutput(const QByteArray &output, const QString &filterFunctionSource);
     void getProcessOutput(bool stdOut, ProcessResult &result);
+    void initProcessResult(ProcessResult &result) const;
+    OutputChannel &outputChannel(bool stdOut) { return stdOut ? m_stdOut : m_stdErr; }
 
     void sendProcessOutput();
     void removeResponseFile();
@@ -93,6 +107,9 @@ private:
     QProcessEnvironment m_commandEnvironment;
     QString m_responseFileName;
     qbs::ErrorInfo m_cancelReason;
+    OutputChannel m_stdOut;
+    OutputChannel m_stdErr;
+    bool m_streamOutput = false;
 };
 
 } // namespace Internal
@@ -39,7 +39,9 @@
 #include "productinstaller.h"
 
 #include "artifact.h"
+#include "emptydirectoriesremover.h"
 #include "productbuilddata.h"
+#include "projectbuilddata.h"
 
 #include <language/language.h>
 #include <language/propertymapinternal.h>
@@ -47,10 +49,12 @@
 #include <tools/qbsassert.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/filetime.h>
 #include <tools/hostosinfo.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
+#include <tools/set.h>
 #include <tools/stringconstants.h>
 
 #include <QtCore/qdir.h>
@@ -92,6 +96,11 @@ void ProductInstaller::install()
 {
     m_targetFilePathsMap.clear();
 
+    if (m_options.uninstall()) {
+        uninstall();
+        return;
+    }
+
     if (m_options.removeExistingInstallation())
         removeInstallRoot();
 
@@ -109,6 +118,7 @@ void ProductInstaller::install()
         copyFile(a);
         m_observer->incrementProgressValue();
     }
+    removeStaleFiles();
 }
 
 QString ProductInstaller::targetFilePath(const TopLevelProject *project,
@@ -181,6 +191,13 @@ void ProductInstaller::removeInstallRoot()
     m_logger.qbsDebug() << QStringLiteral("Removing install root '%1'.")
             .arg(nativeInstallRoot);
 
+    InstallManifest &manifest = installManifest();
+    const std::vector<InstallManifest::Entry> entries = manifest.entries(m_options.installRoot());
+    for (const InstallManifest::Entry &entry : entries)
+        manifest.remove(entry.targetFilePath);
+    if (!entries.empty())
+        m_project->buildData->setDirty();
+
     QString errorMessage;
     if (!removeDirectoryWithContents(m_options.installRoot(), &errorMessage)) {
         const QString fullErrorMessage = Tr::tr("Cannot remove install root '%1': %2")
@@ -205,6 +222,7 @@ void ProductInstaller::copyFile(const Artifact *artifact)
     if (m_options.dryRun()) {
         m_logger.qbsDebug() << Tr::tr("Would copy file '%1' into target directory '%2'.")
                                .arg(nativeFilePath, nativeTargetDir);
+        m_targetFilePathsMap.insert(targetFilePath, artifact->filePath());
         return;
     }
     m_logger.qbsDebug() << QStringLiteral("Copying file '%1' into target directory '%2'.")
@@ -238,9 +256,129 @@ void ProductInstaller::copyFile(const Artifact *artifact)
     }
     m_targetFilePathsMap.insert(targetFilePath, artifact->filePath());
 
+    const FileTime sourceTimestamp = FileInfo(artifact->filePath()).lastModified();
+    if (isInstalledFileUpToDate(artifact, targetFilePath, sourceTimestamp)) {
+        m_logger.qbsDebug() << QStringLiteral("Installed file '%1' is up to date.")
+                               .arg(QDir::toNativeSeparators(targetFilePath));
+        return;
+    }
+
     QString errorMessage;
-    if (!copyFileRecursion(artifact->filePath(), targetFilePath, true, false, &errorMessage))
+    if (!copyFileRecursion(artifact->filePath(), targetFilePath, true, false, &errorMessage)) {
         handleError(Tr::tr("Installation error: %1").arg(errorMessage));
+        return;
+    }
+    recordInstalledFile(artifact, targetFilePath, sourceTimestamp);
+}
+
+/*!
+ * Removes exactly the files that the install manifest records for the products,
+ * as well as directories that became empty as a result.
+ */
+void ProductInstaller::uninstall()
+{
+    const std::vector<InstallManifest::Entry> entries = installedFilesOfProducts();
+    m_observer->initialize(Tr::tr("Uninstalling"), int(entries.size()));
+    removeInstalledFiles(entries);
+}
+
+// Files that the manifest says were installed by one of our products, but which were not
+// installed this time, belong to artifacts that have disappeared or are no longer installable.
+void ProductInstaller::removeStaleFiles()
+{
+    std::vector<InstallManifest::Entry> staleEntries;
+    for (InstallManifest::Entry &entry : installedFilesOfProducts()) {
+        if (!m_targetFilePathsMap.contains(entry.targetFilePath))
+            staleEntries.push_back(std::move(entry));
+    }
+    removeInstalledFiles(staleEntries);
+}
+
+void ProductInstaller::removeInstalledFiles(const std::vector<InstallManifest::Entry> &entries)
+{
+    QStringList removedFiles;
+    for (const InstallManifest::Entry &entry : entries) {
+        const QString nativeFilePath = QDir::toNativeSeparators(entry.targetFilePath);
+        if (m_options.dryRun()) {
+            m_logger.qbsInfo() << Tr::tr("Would remove installed file '%1'.").arg(nativeFilePath);
+            continue;
+        }
+        m_logger.qbsDebug() << QStringLiteral("Removing installed file '%1'.").arg(nativeFilePath);
+        QString errorMessage;
+        const QFileInfo fi(entry.targetFilePath);
+        if ((fi.exists() || fi.isSymLink()) && !removeFileRecursion(fi, &errorMessage)) {
+            handleError(Tr::tr("Cannot remove installed file '%1': %2")
+                        .arg(nativeFilePath, errorMessage));
+            continue;
+        }
+        installManifest().remove(entry.targetFilePath);
+        m_project->buildData->setDirty();
+        removedFiles << entry.targetFilePath;
+        if (m_options.uninstall())
+            m_observer->incrementProgressValue();
+    }
+    EmptyDirectoriesRemover(m_options.installRoot(), m_logger)
+            .removeEmptyParentDirectories(removedFiles);
+}
+
+bool ProductInstaller::isInstalledFileUpToDate(const Artifact *artifact,
+                                               const QString &targetFilePath,
+                                               const FileTime &sourceTimestamp)
+{
+    const InstallManifest::Entry * const entry = installManifest().entry(targetFilePath);
+    if (!entry || entry->digest.isEmpty() || entry->sourceFilePath != artifact->filePath())
+        return false;
+    const FileInfo targetFileInfo(targetFilePath);
+    if (!targetFileInfo.exists() || targetFileInfo.lastModified() != entry->targetTimestamp)
+        return false;
+    if (entry->sourceTimestamp == sourceTimestamp)
+        return true;
+
+    // The source was touched, but its content might still be the same, e.g. after a rebuild
+    // that produced identical output.
+    if (InstallManifest::fileDigest(artifact->filePath()) != entry->digest)
+        return false;
+    InstallManifest::Entry updatedEntry = *entry;
+    updatedEntry.sourceTimestamp = sourceTimestamp;
+    installManifest().insert(updatedEntry);
+    m_project->buildData->setDirty();
+    return true;
+}
+
+void ProductInstaller::recordInstalledFile(const Artifact *artifact,
+                                           const QString &targetFilePath,
+                                           const FileTime &sourceTimestamp)
+{
+    InstallManifest::Entry entry;
+    entry.productName = artifact->product->uniqueName();
+    entry.sourceFilePath = artifact->filePath();
+    entry.targetFilePath = targetFilePath;
+    entry.sourceTimestamp = sourceTimestamp;
+    entry.targetTimestamp = FileInfo(targetFilePath).lastModified();
+    const QFileInfo fi(targetFilePath);
+    if (fi.isFile() && !fi.isSymLink())
+        entry.digest = InstallManifest::fileDigest(artifact->filePath());
+    installManifest().insert(entry);
+    m_project->buildData->setDirty();
+}
+
+std::vector<InstallManifest::Entry> ProductInstaller::installedFilesOfProducts() const
+{
+    Set<QString> productNames;
+    for (const ResolvedProductPtr &product : m_products)
+        productNames.insert(product->uniqueName());
+    std::vector<InstallManifest::Entry> entries;
+    for (InstallManifest::Entry &entry : installManifest().entries(m_options.installRoot())) {
+        if (productNames.contains(entry.productName))
+            entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+InstallManifest &ProductInstaller::installManifest() const
+{
+    QBS_CHECK(m_project->buildData);
+    return m_project->buildData->installManifest;
 }
 
 void ProductInstaller::handleError(const QString &message)
@@ -40,6 +40,7 @@
 #define QBS_PRODUCT_INSTALLER_H
 
 #include "forward_decls.h"
+#include "installmanifest.h"
 
 #include <language/forward_decls.h>
 #include <logging/logger.h>
@@ -67,11 +68,20 @@ public:
 
     void removeInstallRoot();
     void copyFile(const Artifact *artifact);
+    void uninstall();
+    void removeStaleFiles();
 
 private:
+    bool isInstalledFileUpToDate(const Artifact *artifact, const QString &targetFilePath,
+                                 const FileTime &sourceTimestamp);
+    void recordInstalledFile(const Artifact *artifact, const QString &targetFilePath,
+                             const FileTime &sourceTimestamp);
+    void removeInstalledFiles(const std::vector<InstallManifest::Entry> &entries);
+    std::vector<InstallManifest::Entry> installedFilesOfProducts() const;
+    InstallManifest &installManifest() const;
     void handleError(const QString &message);
 
-    const TopLevelProjectConstPtr m_project;
+    const TopLevelProjectPtr m_project;
     const QVector<ResolvedProductPtr> m_products;
     InstallOptions m_options;
     ProgressObserver * const m_observer;
@@ -40,7 +40,9 @@
 #define QBS_PROJECTBUILDDATA_H
 
 #include "forward_decls.h"
+#include "installmanifest.h"
 #include "rawscanresults.h"
+#include "transformerchangetracking.h"
 #include <language/forward_decls.h>
 #include <logging/logger.h>
 #include <tools/persistence.h>
@@ -88,9 +90,11 @@ public:
 
     Set<FileDependency *> fileDependencies;
     RawScanResults rawScanResults;
+    InstallManifest installManifest;
 
     // do not serialize:
     RulesEvaluationContextPtr evaluationContext;
+    ChangeTrackingCache changeTrackingCache;
 
     void load(PersistentPool &pool);
     void store(PersistentPool &pool);
@@ -98,7 +102,7 @@ public:
 private:
     template<PersistentPool::OpType opType> void serializationOp(PersistentPool &pool)
     {
-        pool.serializationOp<opType>(fileDependencies, rawScanResults);
+        pool.serializationOp<opType>(fileDependencies, rawScanResults, installManifest);
     }
 
     using ArtifactKey = std::pair<QString /*fileName*/, QString /*dirName*/>;
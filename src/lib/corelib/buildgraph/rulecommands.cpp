@@ -357,12 +357,14 @@ void ProcessCommand::load(PersistentPool &pool)
 {
     AbstractCommand::load(pool);
     serializationOp<PersistentPool::Load>(pool);
+    m_arguments = pool.loadStringListDelta(m_program);
 }
 
 void ProcessCommand::store(PersistentPool &pool)
 {
     AbstractCommand::store(pool);
     serializationOp<PersistentPool::Store>(pool);
+    pool.storeStringListDelta(m_program, m_arguments);
 }
 
 static QString currentImportScopeName(QScriptContext *context)
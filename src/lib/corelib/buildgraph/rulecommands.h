@@ -157,7 +157,7 @@ private:
 
     template<PersistentPool::OpType opType> void serializationOp(PersistentPool &pool)
     {
-        pool.serializationOp<opType>(m_program, m_arguments, m_environment, m_workingDir,
+        pool.serializationOp<opType>(m_program, m_environment, m_workingDir,
                                      m_stdoutFilterFunction, m_stderrFilterFunction,
                                      m_responseFileUsagePrefix, m_responseFileSeparator,
                                      m_maxExitCode, m_responseFileThreshold,
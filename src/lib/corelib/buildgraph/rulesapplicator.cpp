@@ -65,6 +65,7 @@
 #include <tools/scripttools.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
+#include <tools/stlutils.h>
 #include <tools/stringconstants.h>
 
 #include <QtCore/qcryptographichash.h>
@@ -236,23 +237,24 @@ void RulesApplicator::doApply(const ArtifactSet &inputArtifacts, QScriptValue &p
     // The inputs become children of the rule node. Generated artifacts in the same product
     // already are children, because output artifacts become children of the producing
     // rule node's parent rule node.
+    std::vector<BuildGraphNode *> inputsToConnect;
     for (Artifact * const input : inputArtifacts) {
         if (input->artifactType == Artifact::SourceFile || input->product != m_ruleNode->product
                 || input->producer()->rule()->collectedOutputFileTags().intersects(
                     m_ruleNode->rule()->excludedInputs)) {
-            connect(m_ruleNode, input);
+            inputsToConnect.push_back(input);
         } else {
             QBS_CHECK(m_ruleNode->children.contains(input));
         }
     }
+    connect(m_ruleNode, inputsToConnect);
 
     if (outputArtifacts.empty())
         return;
 
-    for (Artifact * const outputArtifact : qAsConst(outputArtifacts)) {
-        for (Artifact * const dependency : qAsConst(m_transformer->explicitlyDependsOn))
-            connect(outputArtifact, dependency);
-    }
+    const auto outputNodes = rangeTo<std::vector<BuildGraphNode *>>(outputArtifacts);
+    for (Artifact * const dependency : qAsConst(m_transformer->explicitlyDependsOn))
+        connect(outputNodes, dependency);
 
     if (inputArtifacts != m_transformer->inputs)
         m_transformer->setupInputs(prepareScriptContext);
@@ -495,10 +497,7 @@ RulesApplicator::OutputArtifactInfo RulesApplicator::createOutputArtifact(const
             connect(parentRule, outputArtifact);
     }
 
-    for (Artifact * const inputArtifact : inputArtifacts) {
-        QBS_CHECK(outputArtifact != inputArtifact);
-        connect(outputArtifact, inputArtifact);
-    }
+    connect(outputArtifact, rangeTo<std::vector<BuildGraphNode *>>(inputArtifacts));
 
     outputArtifact->transformer = m_transformer;
     m_transformer->outputs.insert(outputArtifact);
@@ -645,10 +644,8 @@ Artifact *RulesApplicator::createOutputArtifactFromScriptValue(const QScriptValu
     const FileTags explicitlyDependsOn = FileTags::fromStringList(
                 obj.property(StringConstants::explicitlyDependsOnProperty())
                 .toVariant().toStringList());
-    for (const FileTag &tag : explicitlyDependsOn) {
-        for (Artifact * const dependency : m_product->lookupArtifactsByFileTag(tag))
-            connect(outputInfo.artifact, dependency);
-    }
+    connect(outputInfo.artifact, rangeTo<std::vector<BuildGraphNode *>>(
+                m_product->lookupArtifactsByFileTags(explicitlyDependsOn)));
     ArtifactBindingsExtractor().apply(outputInfo.artifact, obj);
     if (!outputInfo.newlyCreated && (outputInfo.artifact->fileTags() != outputInfo.oldFileTags
             || outputInfo.artifact->properties->value() != outputInfo.oldProperties)) {
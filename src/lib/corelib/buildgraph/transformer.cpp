@@ -251,9 +251,7 @@ void Transformer::createCommands(ScriptEngine *engine, const PrivateScriptFuncti
                                  const QScriptValueList &args)
 {
     if (!script.scriptFunction.isValid() || script.scriptFunction.engine() != engine) {
-        script.scriptFunction = engine->evaluate(script.sourceCode(),
-                                                  script.location().filePath(),
-                                                  script.location().line());
+        script.scriptFunction = engine->evaluateFunction(script.sourceCode(), script.location());
         if (Q_UNLIKELY(!script.scriptFunction.isFunction()))
             throw ErrorInfo(Tr::tr("Invalid prepare script."), script.location());
     }
@@ -310,6 +308,7 @@ void Transformer::rescueChangeTrackingData(const TransformerConstPtr &other)
     artifactsMapRequestedInCommands = other->artifactsMapRequestedInCommands;
     lastCommandExecutionTime = other->lastCommandExecutionTime;
     lastPrepareScriptExecutionTime = other->lastPrepareScriptExecutionTime;
+    resourceUsage = other->resourceUsage;
     prepareScriptNeedsChangeTracking = other->prepareScriptNeedsChangeTracking;
     commandsNeedChangeTracking = other->commandsNeedChangeTracking;
     markedForRerun = other->markedForRerun;
@@ -51,6 +51,7 @@
 #include <language/scriptengine.h>
 #include <tools/filetime.h>
 #include <tools/persistence.h>
+#include <tools/processresourceusage.h>
 
 #include <QtCore/qhash.h>
 
@@ -84,6 +85,7 @@ public:
     RequestedArtifacts artifactsMapRequestedInCommands;
     FileTime lastPrepareScriptExecutionTime;
     FileTime lastCommandExecutionTime;
+    ProcessResourceUsage resourceUsage; // Of the process commands in the last execution.
     std::unordered_map<QString, ExportedModule> exportedModulesAccessedInPrepareScript;
     std::unordered_map<QString, ExportedModule> exportedModulesAccessedInCommands;
     bool alwaysRun;
@@ -116,6 +118,9 @@ public:
                                      commands, artifactsMapRequestedInPrepareScript,
                                      artifactsMapRequestedInCommands,
                                      lastPrepareScriptExecutionTime, lastCommandExecutionTime,
+                                     resourceUsage.userTime, resourceUsage.systemTime,
+                                     resourceUsage.peakMemoryUsage, resourceUsage.bytesRead,
+                                     resourceUsage.bytesWritten,
                                      exportedModulesAccessedInPrepareScript,
                                      exportedModulesAccessedInCommands,
                                      alwaysRun, prepareScriptNeedsChangeTracking,
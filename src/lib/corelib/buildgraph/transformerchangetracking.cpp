@@ -55,7 +55,8 @@ public:
         : m_transformer(transformer),
           m_product(product),
           m_productsByName(productsByName),
-          m_projectsByName(projectsByName)
+          m_projectsByName(projectsByName),
+          m_cache(product->topLevelProject()->buildData->changeTrackingCache)
     {
     }
 
@@ -64,8 +65,11 @@ public:
 
 private:
     QVariantMap propertyMapByKind(const Property &property) const;
-    bool checkForPropertyChange(const Property &restoredProperty,
-                                const QVariantMap &newProperties) const;
+    const void *propertySourceByKind(const Property &property) const;
+    template<typename MapGetter> bool checkForPropertyChange(const Property &restoredProperty,
+                                                             const void *source,
+                                                             const MapGetter &newProperties) const;
+    static QVariant propertyValue(const Property &property, const QVariantMap &properties);
     bool checkForImportFileChange(const std::vector<QString> &importedFiles,
                                   const FileTime &referenceTime,
                                   const char *context) const;
@@ -81,8 +85,39 @@ private:
     const std::unordered_map<QString, const ResolvedProject *> &m_projectsByName;
     mutable const ResolvedProduct * m_lastProduct = nullptr;
     mutable const Artifact *m_lastArtifact = nullptr;
+    ChangeTrackingCache &m_cache;
 };
 
+void ChangeTrackingCache::clear()
+{
+    m_propertyValues.clear();
+    m_importedFileTimestamps.clear();
+}
+
+const QVariant *ChangeTrackingCache::propertyValue(const void *source,
+                                                   const Property &property) const
+{
+    const auto it = m_propertyValues.constFind(propertyKey(source, property));
+    return it != m_propertyValues.constEnd() ? &it.value() : nullptr;
+}
+
+void ChangeTrackingCache::insertPropertyValue(const void *source, const Property &property,
+                                              const QVariant &value)
+{
+    m_propertyValues.insert(propertyKey(source, property), value);
+}
+
+FileTime ChangeTrackingCache::importedFileTimestamp(const QString &filePath)
+{
+    auto it = m_importedFileTimestamps.find(filePath);
+    if (it == m_importedFileTimestamps.end()) {
+        const FileInfo fi(filePath);
+        it = m_importedFileTimestamps.insert(filePath, fi.exists() ? fi.lastModified()
+                                                                   : FileTime());
+    }
+    return it.value();
+}
+
 template<typename T> static QVariantMap getParameterValue(
         const QHash<T, QVariantMap> &parameters,
         const QString &depName)
@@ -131,32 +166,68 @@ QVariantMap TrafoChangeTracker::propertyMapByKind(const Property &property) cons
     return {};
 }
 
-bool TrafoChangeTracker::checkForPropertyChange(const Property &restoredProperty,
-                                                const QVariantMap &newProperties) const
+// The returned pointer identifies the map that propertyMapByKind() would return.
+const void *TrafoChangeTracker::propertySourceByKind(const Property &property) const
 {
-    QVariant v;
-    switch (restoredProperty.kind) {
+    switch (property.kind) {
+    case Property::PropertyInModule: {
+        const ResolvedProduct * const p = getProduct(property.productName);
+        return p ? p->moduleProperties.get() : nullptr;
+    }
     case Property::PropertyInProduct:
-    case Property::PropertyInProject:
-        v = newProperties.value(restoredProperty.propertyName);
+    case Property::PropertyInParameters:
+        return getProduct(property.productName);
+    case Property::PropertyInProject: {
+        if (property.productName == m_product->project->name)
+            return m_product->project.get();
+        const auto it = m_projectsByName.find(property.productName);
+        return it != m_projectsByName.cend() ? it->second : nullptr;
+    }
+    case Property::PropertyInArtifact:
         break;
+    }
+    QBS_CHECK(false);
+    return nullptr;
+}
+
+QVariant TrafoChangeTracker::propertyValue(const Property &property,
+                                           const QVariantMap &properties)
+{
+    switch (property.kind) {
+    case Property::PropertyInProduct:
+    case Property::PropertyInProject:
+        return properties.value(property.propertyName);
     case Property::PropertyInModule:
-        v = moduleProperty(newProperties, restoredProperty.moduleName,
-                           restoredProperty.propertyName);
-        break;
+        return moduleProperty(properties, property.moduleName, property.propertyName);
     case Property::PropertyInParameters: {
-        const int sepIndex = restoredProperty.moduleName.indexOf(QLatin1Char(':'));
-        QualifiedId moduleName
-                = QualifiedId::fromString(restoredProperty.moduleName.mid(sepIndex + 1));
-        QVariantMap map = newProperties;
+        const int sepIndex = property.moduleName.indexOf(QLatin1Char(':'));
+        QualifiedId moduleName = QualifiedId::fromString(property.moduleName.mid(sepIndex + 1));
+        QVariantMap map = properties;
         while (!moduleName.empty())
             map = map.value(moduleName.takeFirst()).toMap();
-        v = map.value(restoredProperty.propertyName);
-        break;
+        return map.value(property.propertyName);
     }
     case Property::PropertyInArtifact:
         QBS_CHECK(false);
     }
+    return {};
+}
+
+template<typename MapGetter>
+bool TrafoChangeTracker::checkForPropertyChange(const Property &restoredProperty,
+                                                const void *source,
+                                                const MapGetter &newProperties) const
+{
+    QVariant v;
+    if (!source) {
+        v = propertyValue(restoredProperty, newProperties());
+    } else if (const QVariant * const cachedValue = m_cache.propertyValue(source,
+                                                                         restoredProperty)) {
+        v = *cachedValue;
+    } else {
+        v = propertyValue(restoredProperty, newProperties());
+        m_cache.insertPropertyValue(source, restoredProperty, v);
+    }
     if (restoredProperty.value != v) {
         qCDebug(lcBuildGraph).noquote().nospace()
                 << "Value for property '" << restoredProperty.moduleName << "."
@@ -173,16 +244,16 @@ bool TrafoChangeTracker::checkForImportFileChange(const std::vector<QString> &im
                                                   const char *context) const
 {
     for (const QString &importedFile : importedFiles) {
-        const FileInfo fi(importedFile);
-        if (!fi.exists()) {
+        const FileTime timestamp = m_cache.importedFileTimestamp(importedFile);
+        if (!timestamp.isValid()) {
             qCDebug(lcBuildGraph) << context << "imported file" << importedFile
                                   << "is gone, need to re-run";
             return true;
         }
-        if (fi.lastModified() > referenceTime) {
+        if (timestamp > referenceTime) {
             qCDebug(lcBuildGraph) << context << "imported file" << importedFile
                                   << "has been updated, need to re-run"
-                                  << fi.lastModified() << referenceTime;
+                                  << timestamp << referenceTime;
             return true;
         }
     }
@@ -259,8 +330,10 @@ const ResolvedProduct *TrafoChangeTracker::getProduct(const QString &name) const
 bool TrafoChangeTracker::prepareScriptNeedsRerun() const
 {
     for (const Property &property : qAsConst(m_transformer->propertiesRequestedInPrepareScript)) {
-        if (checkForPropertyChange(property, propertyMapByKind(property)))
+        if (checkForPropertyChange(property, propertySourceByKind(property),
+                                   [this, &property] { return propertyMapByKind(property); })) {
             return true;
+        }
     }
 
     if (checkForImportFileChange(m_transformer->importedFilesUsedInPrepareScript,
@@ -279,8 +352,11 @@ bool TrafoChangeTracker::prepareScriptNeedsRerun() const
                     return true;
                 continue;
             }
-            if (checkForPropertyChange(property, artifact->properties->value()))
+            // Artifact properties can change during the build, so their values are not cached.
+            if (checkForPropertyChange(property, nullptr,
+                                       [artifact] { return artifact->properties->value(); })) {
                 return true;
+            }
         }
     }
 
@@ -299,8 +375,10 @@ bool TrafoChangeTracker::prepareScriptNeedsRerun() const
 bool TrafoChangeTracker::commandsNeedRerun() const
 {
     for (const Property &property : qAsConst(m_transformer->propertiesRequestedInCommands)) {
-        if (checkForPropertyChange(property, propertyMapByKind(property)))
+        if (checkForPropertyChange(property, propertySourceByKind(property),
+                                   [this, &property] { return propertyMapByKind(property); })) {
             return true;
+        }
     }
 
     QMap<QString, SourceArtifactConstPtr> artifactMap;
@@ -315,8 +393,11 @@ bool TrafoChangeTracker::commandsNeedRerun() const
                     return true;
                 continue;
             }
-            if (checkForPropertyChange(property, artifact->properties->value()))
+            // Artifact properties can change during the build, so their values are not cached.
+            if (checkForPropertyChange(property, nullptr,
+                                       [artifact] { return artifact->properties->value(); })) {
                 return true;
+            }
         }
     }
 
@@ -359,22 +440,39 @@ bool prepareScriptNeedsRerun(
         const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
         const std::unordered_map<QString, const ResolvedProject *> &projectsByName)
 {
-    if (!transformer->prepareScriptNeedsChangeTracking)
-        return false;
+    const bool needsRerun
+            = prepareScriptWouldRerun(transformer, product, productsByName, projectsByName);
     transformer->prepareScriptNeedsChangeTracking = false;
-    return TrafoChangeTracker(transformer, product, productsByName, projectsByName)
-            .prepareScriptNeedsRerun();
+    return needsRerun;
 }
 
 bool commandsNeedRerun(Transformer *transformer, const ResolvedProduct *product,
                        const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
                        const std::unordered_map<QString, const ResolvedProject *> &projectsByName)
 {
-    if (!transformer->commandsNeedChangeTracking)
-        return false;
+    const bool needsRerun
+            = commandsWouldRerun(transformer, product, productsByName, projectsByName);
     transformer->commandsNeedChangeTracking = false;
-    return TrafoChangeTracker(transformer, product, productsByName, projectsByName)
-            .commandsNeedRerun();
+    return needsRerun;
+}
+
+bool prepareScriptWouldRerun(
+        const Transformer *transformer, const ResolvedProduct *product,
+        const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
+        const std::unordered_map<QString, const ResolvedProject *> &projectsByName)
+{
+    return transformer->prepareScriptNeedsChangeTracking
+            && TrafoChangeTracker(transformer, product, productsByName, projectsByName)
+               .prepareScriptNeedsRerun();
+}
+
+bool commandsWouldRerun(const Transformer *transformer, const ResolvedProduct *product,
+                        const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
+                        const std::unordered_map<QString, const ResolvedProject *> &projectsByName)
+{
+    return transformer->commandsNeedChangeTracking
+            && TrafoChangeTracker(transformer, product, productsByName, projectsByName)
+               .commandsNeedRerun();
 }
 
 } // namespace Internal
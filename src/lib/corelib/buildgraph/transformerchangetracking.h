@@ -30,12 +30,62 @@
 
 #include "forward_decls.h"
 #include <language/forward_decls.h>
+#include <language/property.h>
+#include <tools/filetime.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
 
 #include <unordered_map>
 
 namespace qbs {
 namespace Internal {
 
+// Memoizes those parts of the change tracking checks that do not depend on the transformer,
+// namely the current values of properties and the time stamps of imported files.
+// Many transformers of the same rule request the same properties and import the same files,
+// so this saves a lot of work. The content is only valid for the duration of one build.
+class ChangeTrackingCache
+{
+public:
+    void clear();
+
+    // The source identifies the property map the value was taken from.
+    const QVariant *propertyValue(const void *source, const Property &property) const;
+    void insertPropertyValue(const void *source, const Property &property, const QVariant &value);
+
+    // Returns an invalid time stamp if the file does not exist.
+    FileTime importedFileTimestamp(const QString &filePath);
+
+private:
+    struct PropertyKey
+    {
+        const void *source;
+        Property::Kind kind;
+        QString moduleName;
+        QString propertyName;
+    };
+    friend bool operator==(const PropertyKey &k1, const PropertyKey &k2)
+    {
+        return k1.source == k2.source && k1.kind == k2.kind
+                && k1.propertyName == k2.propertyName && k1.moduleName == k2.moduleName;
+    }
+    friend uint qHash(const PropertyKey &key, uint seed)
+    {
+        return QT_PREPEND_NAMESPACE(qHash)(key.moduleName, seed)
+                ^ QT_PREPEND_NAMESPACE(qHash)(key.propertyName)
+                ^ QT_PREPEND_NAMESPACE(qHash)(key.source) ^ uint(key.kind);
+    }
+    static PropertyKey propertyKey(const void *source, const Property &property)
+    {
+        return {source, property.kind, property.moduleName, property.propertyName};
+    }
+
+    QHash<PropertyKey, QVariant> m_propertyValues;
+    QHash<QString, FileTime> m_importedFileTimestamps;
+};
+
 bool prepareScriptNeedsRerun(
         Transformer *transformer,
         const ResolvedProduct *product,
@@ -47,6 +97,19 @@ bool commandsNeedRerun(Transformer *transformer,
                        const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
                        const std::unordered_map<QString, const ResolvedProject *> &projectsByName);
 
+// Like the two functions above, but the transformer's change tracking flags are left alone,
+// so that the next build still does the check.
+bool prepareScriptWouldRerun(
+        const Transformer *transformer,
+        const ResolvedProduct *product,
+        const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
+        const std::unordered_map<QString, const ResolvedProject *> &projectsByName);
+
+bool commandsWouldRerun(const Transformer *transformer,
+                        const ResolvedProduct *product,
+                        const std::unordered_map<QString, const ResolvedProduct *> &productsByName,
+                        const std::unordered_map<QString, const ResolvedProject *> &projectsByName);
+
 } // namespace Internal
 } // namespace qbs
 
@@ -52,9 +52,98 @@
 #include <QtScript/qscriptengine.h>
 #include <QtScript/qscriptvalue.h>
 
+#include <algorithm>
+
 namespace qbs {
 namespace Internal {
 
+static const qint64 chunkSize = 64 * 1024;
+
+// Byte arrays are passed to scripts as variants holding a QByteArray, so that no
+// conversion of the individual bytes takes place. This is their prototype.
+class ByteArrayPrototype : public QObject, public QScriptable
+{
+    Q_OBJECT
+public:
+    Q_INVOKABLE int size() const { return bytes().size(); }
+    Q_INVOKABLE int at(int index) const;
+    Q_INVOKABLE QScriptValue mid(int pos, int length = -1) const;
+    Q_INVOKABLE int indexOf(const QScriptValue &pattern, int from = 0) const;
+    Q_INVOKABLE QVariantList toArray() const;
+    Q_INVOKABLE QString toHex() const { return QString::fromLatin1(bytes().toHex()); }
+
+private:
+    QByteArray bytes() const { return thisObject().toVariant().toByteArray(); }
+};
+
+static QScriptValue toScriptValue(QScriptEngine *engine, const QByteArray &bytes)
+{
+    return engine->newVariant(QVariant(bytes));
+}
+
+// Accepts byte arrays, arrays of numbers and, if allowStrings is true, strings,
+// which are converted to UTF-8.
+static bool fromScriptValue(const QScriptValue &value, QByteArray &bytes, bool allowStrings)
+{
+    if (value.isVariant()) {
+        const QVariant v = value.toVariant();
+        if (v.userType() != QMetaType::QByteArray)
+            return false;
+        bytes = v.toByteArray();
+        return true;
+    }
+    if (value.isArray()) {
+        const quint32 length = value.property(QStringLiteral("length")).toUInt32();
+        bytes.clear();
+        bytes.reserve(int(length));
+        for (quint32 i = 0; i < length; ++i)
+            bytes.append(char(value.property(i).toUInt32() & 0xFF));
+        return true;
+    }
+    if (allowStrings && value.isString()) {
+        bytes = value.toString().toUtf8();
+        return true;
+    }
+    return false;
+}
+
+int ByteArrayPrototype::at(int index) const
+{
+    const QByteArray b = bytes();
+    if (index < 0 || index >= b.size()) {
+        context()->throwError(QScriptContext::RangeError,
+                              Tr::tr("Index %1 out of range.").arg(index));
+        return 0;
+    }
+    return uchar(b.at(index));
+}
+
+QScriptValue ByteArrayPrototype::mid(int pos, int length) const
+{
+    return toScriptValue(engine(), bytes().mid(pos, length));
+}
+
+int ByteArrayPrototype::indexOf(const QScriptValue &pattern, int from) const
+{
+    QByteArray patternBytes;
+    if (!fromScriptValue(pattern, patternBytes, true)) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("indexOf() expects a byte array, an array or a string."));
+        return -1;
+    }
+    return bytes().indexOf(patternBytes, from);
+}
+
+QVariantList ByteArrayPrototype::toArray() const
+{
+    const QByteArray b = bytes();
+    QVariantList data;
+    data.reserve(b.size());
+    for (const char c : b)
+        data.append(uchar(c));
+    return data;
+}
+
 class BinaryFile : public QObject, public QScriptable, public ResourceAcquiringScriptObject
 {
     Q_OBJECT
@@ -76,12 +165,18 @@ public:
     Q_INVOKABLE qint64 pos() const;
     Q_INVOKABLE void seek(qint64 pos);
     Q_INVOKABLE QVariantList read(qint64 size);
-    Q_INVOKABLE void write(const QVariantList &data);
+    Q_INVOKABLE QScriptValue readBytes(qint64 size);
+    Q_INVOKABLE QScriptValue readAll();
+    Q_INVOKABLE void write(const QScriptValue &data);
+    Q_INVOKABLE qint64 find(const QScriptValue &pattern, qint64 from = -1);
+    Q_INVOKABLE void copyRange(const QScriptValue &destination, qint64 from, qint64 size);
 
 private:
     explicit BinaryFile(QScriptContext *context, const QString &filePath, OpenMode mode = ReadOnly);
 
     bool checkForClosed() const;
+    QByteArray readData(qint64 size);
+    bool writeData(const QByteArray &bytes);
 
     // ResourceAcquiringScriptObject implementation
     void releaseResources() override;
@@ -208,32 +303,112 @@ QVariantList BinaryFile::read(qint64 size)
 {
     if (checkForClosed())
         return {};
-    const QByteArray bytes = m_file->read(size);
-    if (Q_UNLIKELY(bytes.size() == 0 && m_file->error() != QFile::NoError)) {
-        context()->throwError(Tr::tr("Could not read from '%1': %2")
-                              .arg(m_file->fileName(), m_file->errorString()));
-    }
-
+    const QByteArray bytes = readData(size);
     QVariantList data;
     std::for_each(bytes.constBegin(), bytes.constEnd(), [&data](const char &c) {
         data.append(c); });
     return data;
 }
 
-void BinaryFile::write(const QVariantList &data)
+QScriptValue BinaryFile::readBytes(qint64 size)
 {
     if (checkForClosed())
-        return;
+        return {};
+    return toScriptValue(engine(), readData(size));
+}
+
+QScriptValue BinaryFile::readAll()
+{
+    if (checkForClosed())
+        return {};
+    return toScriptValue(engine(), readData(m_file->size() - m_file->pos()));
+}
 
+void BinaryFile::write(const QScriptValue &data)
+{
+    if (checkForClosed())
+        return;
     QByteArray bytes;
-    std::for_each(data.constBegin(), data.constEnd(), [&bytes](const QVariant &v) {
-        bytes.append(char(v.toUInt() & 0xFF)); });
+    if (!fromScriptValue(data, bytes, false)) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("write() expects a byte array or an array of numbers."));
+        return;
+    }
+    writeData(bytes);
+}
 
-    const qint64 size = m_file->write(bytes);
-    if (Q_UNLIKELY(size == -1)) {
-        context()->throwError(Tr::tr("Could not write to '%1': %2")
+// Searches from the given offset or the current position without changing the latter.
+// The file is mapped into memory if possible, so it does not have to be read.
+qint64 BinaryFile::find(const QScriptValue &pattern, qint64 from)
+{
+    if (checkForClosed())
+        return -1;
+    QByteArray patternBytes;
+    if (!fromScriptValue(pattern, patternBytes, true) || patternBytes.isEmpty()) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("find() expects a non-empty byte array, array or string."));
+        return -1;
+    }
+    if (from < 0)
+        from = m_file->pos();
+    const qint64 fileSize = m_file->size();
+    if (from >= fileSize)
+        return -1;
+    if (uchar * const data = m_file->map(from, fileSize - from)) {
+        const char * const begin = reinterpret_cast<const char *>(data);
+        const char * const end = begin + (fileSize - from);
+        const char * const match = std::search(begin, end, patternBytes.cbegin(),
+                                               patternBytes.cend());
+        m_file->unmap(data);
+        return match == end ? -1 : from + (match - begin);
+    }
+
+    // Mapping is not possible, e.g. for files opened write-only. Read chunks that overlap
+    // by the length of the pattern, so that matches at chunk borders are found.
+    const qint64 oldPos = m_file->pos();
+    qint64 result = -1;
+    for (qint64 chunkStart = from; chunkStart < fileSize && result == -1;
+         chunkStart += chunkSize) {
+        if (!m_file->seek(chunkStart))
+            break;
+        const QByteArray chunk = m_file->read(chunkSize + patternBytes.size() - 1);
+        if (chunk.isEmpty())
+            break;
+        const int index = chunk.indexOf(patternBytes);
+        if (index != -1)
+            result = chunkStart + index;
+    }
+    m_file->seek(oldPos);
+    return result;
+}
+
+// Copies the given range of this file to the current position of the destination file,
+// in chunks and without involving the script engine. The position of this file is not changed.
+void BinaryFile::copyRange(const QScriptValue &destination, qint64 from, qint64 size)
+{
+    if (checkForClosed())
+        return;
+    const auto destinationFile = qobject_cast<BinaryFile *>(destination.toQObject());
+    if (!destinationFile) {
+        context()->throwError(QScriptContext::TypeError,
+                              Tr::tr("copyRange() expects a BinaryFile as the destination."));
+        return;
+    }
+    if (destinationFile->checkForClosed())
+        return;
+    const qint64 oldPos = m_file->pos();
+    if (Q_UNLIKELY(!m_file->seek(from))) {
+        context()->throwError(Tr::tr("Could not seek '%1': %2")
                               .arg(m_file->fileName(), m_file->errorString()));
+        return;
+    }
+    while (size > 0) {
+        const QByteArray chunk = readData(std::min(size, chunkSize));
+        if (chunk.isEmpty() || !destinationFile->writeData(chunk))
+            break;
+        size -= chunk.size();
     }
+    m_file->seek(oldPos);
 }
 
 bool BinaryFile::checkForClosed() const
@@ -245,6 +420,27 @@ bool BinaryFile::checkForClosed() const
     return true;
 }
 
+QByteArray BinaryFile::readData(qint64 size)
+{
+    const QByteArray bytes = m_file->read(size);
+    if (Q_UNLIKELY(bytes.size() == 0 && m_file->error() != QFile::NoError)) {
+        context()->throwError(Tr::tr("Could not read from '%1': %2")
+                              .arg(m_file->fileName(), m_file->errorString()));
+    }
+    return bytes;
+}
+
+bool BinaryFile::writeData(const QByteArray &bytes)
+{
+    const qint64 size = m_file->write(bytes);
+    if (Q_UNLIKELY(size == -1)) {
+        context()->throwError(Tr::tr("Could not write to '%1': %2")
+                              .arg(m_file->fileName(), m_file->errorString()));
+        return false;
+    }
+    return true;
+}
+
 void BinaryFile::releaseResources()
 {
     close();
@@ -261,6 +457,11 @@ void initializeJsExtensionBinaryFile(QScriptValue extensionObject)
     const QScriptValue obj = engine->newQMetaObject(&BinaryFile::staticMetaObject,
                                                     engine->newFunction(&BinaryFile::ctor));
     extensionObject.setProperty(QStringLiteral("BinaryFile"), obj);
+    if (!engine->defaultPrototype(qMetaTypeId<QByteArray>()).isValid()) {
+        engine->setDefaultPrototype(qMetaTypeId<QByteArray>(),
+                                    engine->newQObject(new ByteArrayPrototype,
+                                                       QScriptEngine::ScriptOwnership));
+    }
 }
 
 Q_DECLARE_METATYPE(qbs::Internal::BinaryFile *)
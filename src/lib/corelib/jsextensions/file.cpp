@@ -40,6 +40,7 @@
 #include <language/scriptengine.h>
 #include <logging/translator.h>
 #include <tools/fileinfo.h>
+#include <tools/filesystemcache.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
@@ -47,6 +48,9 @@
 #include <QtScript/qscriptable.h>
 #include <QtScript/qscriptengine.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -87,6 +91,8 @@ public:
     static QScriptValue js_ctor(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_copy(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_exists(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue js_existsMany(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue js_findFirst(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_directoryEntries(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_lastModified(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_makePath(QScriptContext *context, QScriptEngine *engine);
@@ -95,6 +101,38 @@ public:
     static QScriptValue js_canonicalFilePath(QScriptContext *context, QScriptEngine *engine);
 };
 
+// Property evaluation is not supposed to modify the file system, so its queries can be
+// answered from the shared cache. Probes, module providers, rules and commands might
+// create files at any time and therefore always query the file system directly.
+static bool useFileSystemCache(const ScriptEngine *engine)
+{
+    return engine->evalContext() == EvalContext::PropertyEvaluation;
+}
+
+static FileInfo fileInfo(const ScriptEngine *engine, const QString &filePath)
+{
+    return useFileSystemCache(engine) ? FileSystemCache::instance().fileInfo(filePath)
+                                      : FileInfo(filePath);
+}
+
+static void invalidateFileSystemCache(const QString &path)
+{
+    FileSystemCache::instance().invalidate(path);
+}
+
+// For operations that also create the missing parent directories of the path.
+static void invalidateFileSystemCacheForNewPath(const QString &path)
+{
+    QString topmostNewPath = QDir::cleanPath(QDir::current().absoluteFilePath(path));
+    while (true) {
+        const QString parentPath = FileInfo::path(topmostNewPath);
+        if (parentPath == topmostNewPath || FileInfo::exists(parentPath))
+            break;
+        topmostNewPath = parentPath;
+    }
+    invalidateFileSystemCache(topmostNewPath);
+}
+
 QScriptValue File::js_ctor(QScriptContext *context, QScriptEngine *engine)
 {
     Q_UNUSED(engine);
@@ -119,6 +157,7 @@ QScriptValue File::js_copy(QScriptContext *context, QScriptEngine *engine)
     const QString sourceFile = context->argument(0).toString();
     const QString targetFile = context->argument(1).toString();
     QString errorMessage;
+    invalidateFileSystemCacheForNewPath(targetFile);
     if (Q_UNLIKELY(!copyFileRecursion(sourceFile, targetFile, true, true, &errorMessage)))
         return context->throwError(errorMessage);
     return true;
@@ -132,12 +171,79 @@ QScriptValue File::js_exists(QScriptContext *context, QScriptEngine *engine)
                                    Tr::tr("exist expects 1 argument"));
     }
     const QString filePath = context->argument(0).toString();
-    const bool exists = FileInfo::exists(filePath);
     const auto se = static_cast<ScriptEngine *>(engine);
+    const bool exists = fileInfo(se, filePath).exists();
     se->addFileExistsResult(filePath, exists);
     return exists;
 }
 
+QScriptValue File::js_existsMany(QScriptContext *context, QScriptEngine *engine)
+{
+    if (Q_UNLIKELY(context->argumentCount() < 1 || !context->argument(0).isArray())) {
+        return context->throwError(QScriptContext::SyntaxError,
+                                   Tr::tr("existsMany expects an array of file paths"));
+    }
+    const QStringList filePaths = context->argument(0).toVariant().toStringList();
+    const auto se = static_cast<ScriptEngine *>(engine);
+    QScriptValue result = engine->newArray(filePaths.size());
+    for (int i = 0; i < filePaths.size(); ++i) {
+        const bool exists = fileInfo(se, filePaths.at(i)).exists();
+        se->addFileExistsResult(filePaths.at(i), exists);
+        result.setProperty(i, exists);
+    }
+    return result;
+}
+
+// Looks for the first existing file in the candidate list formed by combining all file names
+// with all directories, with the file names varying slowest. Directories that do not exist
+// are checked only once, and only that result is recorded for them.
+QScriptValue File::js_findFirst(QScriptContext *context, QScriptEngine *engine)
+{
+    if (Q_UNLIKELY(context->argumentCount() < 2 || !context->argument(0).isArray()
+                   || !context->argument(1).isArray())) {
+        return context->throwError(QScriptContext::SyntaxError,
+                                   Tr::tr("findFirst expects two arrays"));
+    }
+    const QStringList directories = context->argument(0).toVariant().toStringList();
+    const QStringList fileNames = context->argument(1).toVariant().toStringList();
+    const int from = context->argumentCount() > 2 ? context->argument(2).toInt32() : 0;
+    const auto se = static_cast<ScriptEngine *>(engine);
+
+    std::vector<int> directoryExists(directories.size(), -1);
+    QStringList candidatePaths;
+    int foundIndex = -1;
+    const int candidateCount = directories.size() * fileNames.size();
+    for (int index = std::max(from, 0); index < candidateCount; ++index) {
+        const int directoryIndex = index % directories.size();
+        const QString &directory = directories.at(directoryIndex);
+        const QString filePath = FileInfo::joinPaths(
+                    {directory, fileNames.at(index / directories.size())});
+        candidatePaths << filePath;
+        int &dirExists = directoryExists[directoryIndex];
+        if (dirExists == -1 && !directory.isEmpty()) {
+            dirExists = fileInfo(se, directory).exists();
+            if (!dirExists)
+                se->addFileExistsResult(directory, false);
+        }
+        if (dirExists == 0)
+            continue;
+        const bool exists = fileInfo(se, filePath).exists();
+        se->addFileExistsResult(filePath, exists);
+        if (exists) {
+            foundIndex = index;
+            break;
+        }
+    }
+
+    QScriptValue result = engine->newObject();
+    result.setProperty(QStringLiteral("index"), foundIndex);
+    if (foundIndex != -1)
+        result.setProperty(QStringLiteral("filePath"), candidatePaths.constLast());
+    result.setProperty(QStringLiteral("candidatePaths"),
+                       qScriptValueFromSequence(engine, candidatePaths));
+    return result;
+}
+
 QScriptValue File::js_directoryEntries(QScriptContext *context, QScriptEngine *engine)
 {
     Q_UNUSED(engine);
@@ -154,8 +260,9 @@ QScriptValue File::js_directoryEntries(QScriptContext *context, QScriptEngine *e
 
     const QString path = context->argument(0).toString();
     const auto filters = static_cast<QDir::Filters>(context->argument(1).toUInt32());
-    QDir dir(path);
-    const QStringList entries = dir.entryList(filters, QDir::Name);
+    const QStringList entries = useFileSystemCache(se)
+            ? FileSystemCache::instance().directoryEntries(path, filters)
+            : QDir(path).entryList(filters, QDir::Name);
     se->addDirectoryEntriesResult(path, filters, entries);
     return qScriptValueFromSequence(engine, entries);
 }
@@ -173,6 +280,7 @@ QScriptValue File::js_remove(QScriptContext *context, QScriptEngine *engine)
     se->checkContext(QStringLiteral("File.remove()"), dubiousContexts);
 
     QString fileName = context->argument(0).toString();
+    invalidateFileSystemCache(fileName);
 
     QString errorMessage;
     if (Q_UNLIKELY(!removeFileRecursion(QFileInfo(fileName), &errorMessage)))
@@ -188,8 +296,8 @@ QScriptValue File::js_lastModified(QScriptContext *context, QScriptEngine *engin
                                    Tr::tr("File.lastModified() expects an argument"));
     }
     const QString filePath = context->argument(0).toString();
-    const FileTime timestamp = FileInfo(filePath).lastModified();
     const auto se = static_cast<ScriptEngine *>(engine);
+    const FileTime timestamp = fileInfo(se, filePath).lastModified();
     se->addFileLastModifiedResult(filePath, timestamp);
     return timestamp.asDouble();
 }
@@ -206,7 +314,9 @@ QScriptValue File::js_makePath(QScriptContext *context, QScriptEngine *engine)
     const DubiousContextList dubiousContexts({ DubiousContext(EvalContext::PropertyEvaluation) });
     se->checkContext(QStringLiteral("File.makePath()"), dubiousContexts);
 
-    return QDir::root().mkpath(context->argument(0).toString());
+    const QString path = context->argument(0).toString();
+    invalidateFileSystemCacheForNewPath(path);
+    return QDir::root().mkpath(path);
 }
 
 QScriptValue File::js_move(QScriptContext *context, QScriptEngine *engine)
@@ -246,6 +356,8 @@ QScriptValue File::js_move(QScriptContext *context, QScriptEngine *engine)
                                                          "Destination file exists.")
                                    .arg(sourceFile, targetFile));
 
+    invalidateFileSystemCache(sourceFile);
+    invalidateFileSystemCache(targetFile);
     QFile f2(sourceFile);
     if (Q_UNLIKELY(!f2.rename(targetFile)))
         return context->throwError(QStringLiteral("Could not move '%1' to '%2': %3")
@@ -274,6 +386,8 @@ void initializeJsExtensionFile(QScriptValue extensionObject)
                                                   engine->newFunction(&File::js_ctor));
     fileObj.setProperty(QStringLiteral("copy"), engine->newFunction(File::js_copy));
     fileObj.setProperty(QStringLiteral("exists"), engine->newFunction(File::js_exists));
+    fileObj.setProperty(QStringLiteral("existsMany"), engine->newFunction(File::js_existsMany));
+    fileObj.setProperty(QStringLiteral("findFirst"), engine->newFunction(File::js_findFirst));
     fileObj.setProperty(QStringLiteral("directoryEntries"),
                         engine->newFunction(File::js_directoryEntries));
     fileObj.setProperty(QStringLiteral("lastModified"), engine->newFunction(File::js_lastModified));
@@ -53,16 +53,6 @@
 namespace qbs {
 namespace Internal {
 
-// removes duplicate separators from the path
-static QString uniqueSeparators(QString path)
-{
-    const auto it = std::unique(path.begin(), path.end(), [](QChar c1, QChar c2) {
-        return c1 == c2 && c1 == QLatin1Char('/');
-    });
-    path.resize(int(it - path.begin()));
-    return path;
-}
-
 class FileInfoExtension : public QObject, QScriptable
 {
     Q_OBJECT
@@ -272,13 +262,10 @@ QScriptValue FileInfoExtension::js_joinPaths(QScriptContext *context, QScriptEng
     QStringList paths;
     for (int i = 0; i < context->argumentCount(); ++i) {
         const QScriptValue value = context->argument(i);
-        if (!value.isUndefined() && !value.isNull()) {
-            const QString arg = value.toString();
-            if (!arg.isEmpty())
-                paths.push_back(arg);
-        }
+        if (!value.isUndefined() && !value.isNull())
+            paths.push_back(value.toString());
     }
-    return engine->toScriptValue(uniqueSeparators(paths.join(QLatin1Char('/'))));
+    return engine->toScriptValue(FileInfo::joinPaths(paths));
 }
 
 } // namespace Internal
@@ -82,10 +82,16 @@ struct fat_arch_64 {
 #include <QtCore/qendian.h>
 #include <QtCore/qfile.h>
 #include <QtCore/qlibrary.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthreadpool.h>
 
 #include <QtScript/qscriptable.h>
 #include <QtScript/qscriptengine.h>
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -105,6 +111,8 @@ public:
     static QScriptValue js_canonicalToolchain(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_cStringQuote(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_getHash(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue js_fileHash(QScriptContext *context, QScriptEngine *engine);
+    static QScriptValue js_fileHashes(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_getNativeSetting(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_kernelVersion(QScriptContext *context, QScriptEngine *engine);
     static QScriptValue js_nativeSettingGroups(QScriptContext *context, QScriptEngine *engine);
@@ -352,6 +360,134 @@ QScriptValue UtilitiesExtension::js_getHash(QScriptContext *context, QScriptEngi
     return engine->toScriptValue(QString::fromLatin1(hash));
 }
 
+static bool hashAlgorithmFromString(const QString &name, QCryptographicHash::Algorithm &algorithm)
+{
+    static const std::pair<QString, QCryptographicHash::Algorithm> algorithms[] = {
+        {QStringLiteral("md5"), QCryptographicHash::Md5},
+        {QStringLiteral("sha1"), QCryptographicHash::Sha1},
+        {QStringLiteral("sha224"), QCryptographicHash::Sha224},
+        {QStringLiteral("sha256"), QCryptographicHash::Sha256},
+        {QStringLiteral("sha384"), QCryptographicHash::Sha384},
+        {QStringLiteral("sha512"), QCryptographicHash::Sha512},
+        {QStringLiteral("sha3-256"), QCryptographicHash::Sha3_256},
+        {QStringLiteral("sha3-512"), QCryptographicHash::Sha3_512},
+    };
+    for (const auto &entry : algorithms) {
+        if (name.compare(entry.first, Qt::CaseInsensitive) == 0) {
+            algorithm = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hashAlgorithmFromArgument(QScriptContext *context, int index,
+                                      QCryptographicHash::Algorithm &algorithm)
+{
+    algorithm = QCryptographicHash::Sha256;
+    if (context->argumentCount() <= index || context->argument(index).isUndefined())
+        return true;
+    const QString name = context->argument(index).toString();
+    if (hashAlgorithmFromString(name, algorithm))
+        return true;
+    context->throwError(QScriptContext::TypeError,
+                        Tr::tr("Unsupported hash algorithm '%1'.").arg(name));
+    return false;
+}
+
+// The file is fed to the hash in chunks, so its contents never need to be in memory as a whole.
+static QByteArray hashFile(const QString &filePath, QCryptographicHash::Algorithm algorithm,
+                           QString *errorString)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *errorString = Tr::tr("Cannot open '%1' for reading: %2")
+                .arg(filePath, file.errorString());
+        return {};
+    }
+    QCryptographicHash hash(algorithm);
+    if (!hash.addData(&file)) {
+        *errorString = Tr::tr("Cannot read '%1': %2").arg(filePath, file.errorString());
+        return {};
+    }
+    return hash.result().toHex();
+}
+
+class FileHashTask : public QRunnable
+{
+public:
+    FileHashTask(QString filePath, QCryptographicHash::Algorithm algorithm)
+        : m_filePath(std::move(filePath)), m_algorithm(algorithm)
+    {
+        setAutoDelete(false);
+    }
+
+    void run() override { m_hash = hashFile(m_filePath, m_algorithm, &m_errorString); }
+
+    const QString &filePath() const { return m_filePath; }
+    const QByteArray &hash() const { return m_hash; }
+    const QString &errorString() const { return m_errorString; }
+
+private:
+    const QString m_filePath;
+    const QCryptographicHash::Algorithm m_algorithm;
+    QByteArray m_hash;
+    QString m_errorString;
+};
+
+QScriptValue UtilitiesExtension::js_fileHash(QScriptContext *context, QScriptEngine *engine)
+{
+    if (Q_UNLIKELY(context->argumentCount() < 1 || context->argumentCount() > 2)) {
+        return context->throwError(QScriptContext::SyntaxError,
+                                   QStringLiteral("fileHash expects 1 or 2 arguments"));
+    }
+    QCryptographicHash::Algorithm algorithm;
+    if (!hashAlgorithmFromArgument(context, 1, algorithm))
+        return engine->undefinedValue();
+    QString errorString;
+    const QByteArray hash = hashFile(context->argument(0).toString(), algorithm, &errorString);
+    if (Q_UNLIKELY(!errorString.isEmpty()))
+        return context->throwError(errorString);
+    return engine->toScriptValue(QString::fromLatin1(hash));
+}
+
+QScriptValue UtilitiesExtension::js_fileHashes(QScriptContext *context, QScriptEngine *engine)
+{
+    if (Q_UNLIKELY(context->argumentCount() < 1 || context->argumentCount() > 2)) {
+        return context->throwError(QScriptContext::SyntaxError,
+                                   QStringLiteral("fileHashes expects 1 or 2 arguments"));
+    }
+    if (Q_UNLIKELY(!context->argument(0).isArray())) {
+        return context->throwError(QScriptContext::TypeError,
+                                   QStringLiteral("fileHashes expects an array of file paths"));
+    }
+    QCryptographicHash::Algorithm algorithm;
+    if (!hashAlgorithmFromArgument(context, 1, algorithm))
+        return engine->undefinedValue();
+
+    const QStringList filePaths = context->argument(0).toVariant().toStringList();
+    std::vector<std::unique_ptr<FileHashTask>> tasks;
+    tasks.reserve(filePaths.size());
+    for (const QString &filePath : filePaths)
+        tasks.push_back(std::make_unique<FileHashTask>(filePath, algorithm));
+    if (tasks.size() == 1) {
+        tasks.front()->run();
+    } else {
+        QThreadPool threadPool;
+        for (const auto &task : tasks)
+            threadPool.start(task.get());
+        threadPool.waitForDone();
+    }
+
+    QScriptValue result = engine->newObject();
+    for (const auto &task : tasks) {
+        if (Q_UNLIKELY(!task->errorString().isEmpty()))
+            return context->throwError(task->errorString());
+        result.setProperty(task->filePath(), QString::fromLatin1(task->hash()));
+    }
+    return result;
+}
+
 QScriptValue UtilitiesExtension::js_getNativeSetting(QScriptContext *context, QScriptEngine *engine)
 {
     if (Q_UNLIKELY(context->argumentCount() < 1 || context->argumentCount() > 3)) {
@@ -919,6 +1055,10 @@ void initializeJsExtensionUtilities(QScriptValue extensionObject)
                                engine->newFunction(UtilitiesExtension::js_cStringQuote, 1));
     environmentObj.setProperty(QStringLiteral("getHash"),
                                engine->newFunction(UtilitiesExtension::js_getHash, 1));
+    environmentObj.setProperty(QStringLiteral("fileHash"),
+                               engine->newFunction(UtilitiesExtension::js_fileHash, 2));
+    environmentObj.setProperty(QStringLiteral("fileHashes"),
+                               engine->newFunction(UtilitiesExtension::js_fileHashes, 2));
     environmentObj.setProperty(QStringLiteral("getNativeSetting"),
                                engine->newFunction(UtilitiesExtension::js_getNativeSetting, 3));
     environmentObj.setProperty(QStringLiteral("kernelVersion"),
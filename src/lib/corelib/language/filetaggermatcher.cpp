@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "filetaggermatcher.h"
+
+#include "language.h"
+
+#include <tools/qbsassert.h>
+
+#include <QtCore/qstringlist.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+static bool isWildcardCharacter(QChar c)
+{
+    return c == QLatin1Char('*') || c == QLatin1Char('?') || c == QLatin1Char('[')
+            || c == QLatin1Char('\\');
+}
+
+static QString matcherKey(const std::vector<FileTaggerConstPtr> &fileTaggers)
+{
+    QString key;
+    for (const FileTaggerConstPtr &tagger : fileTaggers) {
+        key += QString::number(tagger->priority()) + QLatin1Char('\n');
+        for (const FileTag &tag : tagger->fileTags())
+            key += QString::number(tag.uniqueIdentifier()) + QLatin1Char(' ');
+        key += QLatin1Char('\n');
+        for (const QString &pattern : tagger->patterns())
+            key += pattern + QLatin1Char('\n');
+        key += QLatin1Char('\n');
+    }
+    return key;
+}
+
+std::shared_ptr<const FileTaggerMatcher> FileTaggerMatcher::get(
+        const std::vector<FileTaggerConstPtr> &fileTaggers)
+{
+    static std::mutex registryMutex;
+    static QHash<QString, std::weak_ptr<const FileTaggerMatcher>> registry;
+
+    const QString key = matcherKey(fileTaggers);
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (const auto matcher = registry.value(key).lock())
+        return matcher;
+    for (auto it = registry.begin(); it != registry.end();) {
+        if (it.value().expired())
+            it = registry.erase(it);
+        else
+            ++it;
+    }
+    const std::shared_ptr<const FileTaggerMatcher> matcher(new FileTaggerMatcher(fileTaggers));
+    registry.insert(key, matcher);
+    return matcher;
+}
+
+FileTaggerMatcher::FileTaggerMatcher(std::vector<FileTaggerConstPtr> fileTaggers)
+    : m_fileTaggers(std::move(fileTaggers))
+{
+    for (int i = 0; i < int(m_fileTaggers.size()); ++i) {
+        for (const QString &pattern : m_fileTaggers.at(i)->patterns())
+            addPattern(i, pattern);
+    }
+    std::sort(m_suffixLengths.begin(), m_suffixLengths.end());
+    m_suffixLengths.erase(std::unique(m_suffixLengths.begin(), m_suffixLengths.end()),
+                          m_suffixLengths.end());
+
+    if (!m_otherPatterns.empty()) {
+        QStringList alternatives;
+        for (const auto &p : m_otherPatterns)
+            alternatives << QStringLiteral("(?:%1)").arg(p.second.pattern());
+        m_combinedOtherPatterns.setPattern(alternatives.join(QLatin1Char('|')));
+        m_combinedOtherPatterns.optimize();
+    }
+}
+
+void FileTaggerMatcher::addPattern(int taggerIndex, const QString &pattern)
+{
+    QBS_CHECK(!pattern.isEmpty());
+    const int wildcardCount = int(std::count_if(pattern.cbegin(), pattern.cend(),
+                                                isWildcardCharacter));
+    if (wildcardCount == 0) {
+        m_literals[pattern].push_back(taggerIndex);
+    } else if (wildcardCount == 1 && pattern.startsWith(QLatin1Char('*'))) {
+        const QString suffix = pattern.mid(1);
+        m_suffixes[suffix].push_back(taggerIndex);
+        m_suffixLengths.push_back(suffix.size());
+    } else {
+        QRegularExpression regExp(QRegularExpression::wildcardToRegularExpression(pattern));
+        regExp.optimize();
+        m_otherPatterns.emplace_back(taggerIndex, std::move(regExp));
+    }
+}
+
+FileTags FileTaggerMatcher::fileTagsForFileName(const QString &fileName) const
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        const auto it = m_cache.constFind(fileName);
+        if (it != m_cache.constEnd())
+            return it.value();
+    }
+    const FileTags fileTags = computeFileTags(fileName);
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    m_cache.insert(fileName, fileTags);
+    return fileTags;
+}
+
+FileTags FileTaggerMatcher::computeFileTags(const QString &fileName) const
+{
+    std::vector<int> matchingTaggers;
+    const auto addMatches = [&matchingTaggers](const QHash<QString, std::vector<int>> &table,
+                                               const QString &key) {
+        const auto it = table.constFind(key);
+        if (it != table.constEnd())
+            matchingTaggers.insert(matchingTaggers.end(), it->cbegin(), it->cend());
+    };
+    addMatches(m_literals, fileName);
+    for (const int length : m_suffixLengths) {
+        if (length > fileName.size())
+            break;
+        addMatches(m_suffixes, fileName.right(length));
+    }
+    if (!m_otherPatterns.empty() && m_combinedOtherPatterns.match(fileName).hasMatch()) {
+        for (const auto &p : m_otherPatterns) {
+            if (p.second.match(fileName).hasMatch())
+                matchingTaggers.push_back(p.first);
+        }
+    }
+
+    FileTags result;
+    if (matchingTaggers.empty())
+        return result;
+
+    // Only the taggers with the highest priority among the matching ones apply.
+    // As the taggers are sorted by priority, these are the ones with the lowest indexes.
+    std::sort(matchingTaggers.begin(), matchingTaggers.end());
+    const int priority = m_fileTaggers.at(matchingTaggers.front())->priority();
+    for (const int index : matchingTaggers) {
+        const FileTaggerConstPtr &tagger = m_fileTaggers.at(index);
+        if (tagger->priority() != priority) {
+            QBS_ASSERT(priority > tagger->priority(), return result);
+            break;
+        }
+        result.unite(tagger->fileTags());
+    }
+    return result;
+}
+
+} // namespace Internal
+} // namespace qbs
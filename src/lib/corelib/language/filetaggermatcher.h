@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_FILETAGGERMATCHER_H
+#define QBS_FILETAGGERMATCHER_H
+
+#include "filetags.h"
+#include "forward_decls.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qregularexpression.h>
+#include <QtCore/qstring.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// Matches file names against all patterns of a list of file taggers at once.
+// Patterns of the form "*.ext" and literal file names are looked up in hash tables,
+// all other patterns are combined into a single regular expression that
+// serves as a pre-filter. The results are memoized per file name.
+// Instances are shared between all products that have the same file taggers.
+class FileTaggerMatcher
+{
+public:
+    // The taggers are expected to be sorted by priority, highest first.
+    static std::shared_ptr<const FileTaggerMatcher> get(
+            const std::vector<FileTaggerConstPtr> &fileTaggers);
+
+    FileTags fileTagsForFileName(const QString &fileName) const;
+
+private:
+    explicit FileTaggerMatcher(std::vector<FileTaggerConstPtr> fileTaggers);
+
+    void addPattern(int taggerIndex, const QString &pattern);
+    FileTags computeFileTags(const QString &fileName) const;
+
+    const std::vector<FileTaggerConstPtr> m_fileTaggers;
+    QHash<QString, std::vector<int>> m_literals;
+    QHash<QString, std::vector<int>> m_suffixes;
+    std::vector<int> m_suffixLengths;
+    std::vector<std::pair<int, QRegularExpression>> m_otherPatterns;
+    QRegularExpression m_combinedOtherPatterns;
+
+    mutable QHash<QString, FileTags> m_cache;
+    mutable std::mutex m_cacheMutex;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_FILETAGGERMATCHER_H
@@ -41,6 +41,7 @@
 
 #include "artifactproperties.h"
 #include "builtindeclarations.h"
+#include "filetaggermatcher.h"
 #include "propertymapinternal.h"
 #include "scriptengine.h"
 
@@ -49,6 +50,7 @@
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/projectbuilddata.h>
 #include <buildgraph/rulegraph.h> // TODO: Move to language?
+#include <buildgraph/rulenode.h>
 #include <buildgraph/transformer.h>
 #include <jsextensions/jsextensions.h>
 #include <logging/categories.h>
@@ -57,6 +59,8 @@
 #include <tools/hostosinfo.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/filesystemcache.h>
+#include <tools/profiling.h>
 #include <tools/scripttools.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
@@ -72,6 +76,8 @@
 #include <algorithm>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace qbs {
 namespace Internal {
@@ -92,25 +98,15 @@ template<typename T> bool equals(const T *v1, const T *v2)
  */
 
 FileTagger::FileTagger(const QStringList &patterns, FileTags fileTags, int priority)
-    : m_fileTags(std::move(fileTags)), m_priority(priority)
+    : m_patterns(patterns), m_fileTags(std::move(fileTags)), m_priority(priority)
 {
-    setPatterns(patterns);
-}
-
-void FileTagger::setPatterns(const QStringList &patterns)
-{
-    m_patterns.clear();
-    for (const QString &pattern : patterns) {
-        QBS_CHECK(!pattern.isEmpty());
-        m_patterns << QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern));
-    }
 }
 
 
 bool Probe::needsReconfigure(const FileTime &referenceTime) const
 {
     const auto criterion = [referenceTime](const QString &filePath) {
-        FileInfo fi(filePath);
+        const FileInfo fi = FileSystemCache::instance().fileInfo(filePath);
         return !fi.exists() || fi.lastModified() > referenceTime;
     };
     return std::any_of(m_importedFilesUsed.cbegin(), m_importedFilesUsed.cend(), criterion);
@@ -344,26 +340,21 @@ std::vector<SourceArtifactPtr> ResolvedProduct::allEnabledFiles() const
 
 FileTags ResolvedProduct::fileTagsForFileName(const QString &fileName) const
 {
-    FileTags result;
-    std::unique_ptr<int> priority;
-    for (const FileTaggerConstPtr &tagger : qAsConst(fileTaggers)) {
-        for (const QRegularExpression &pattern : tagger->patterns()) {
-            if (pattern.match(fileName).hasMatch()) {
-                if (priority) {
-                    if (*priority != tagger->priority()) {
-                        // The taggers are expected to be sorted by priority.
-                        QBS_ASSERT(*priority > tagger->priority(), return result);
-                        return result;
-                    }
-                } else {
-                    priority = std::make_unique<int>(tagger->priority());
-                }
-                result.unite(tagger->fileTags());
-                break;
-            }
-        }
+    std::shared_ptr<const FileTaggerMatcher> matcher;
+    {
+        std::lock_guard<std::mutex> lock(m_fileTaggerMatcherLock);
+        if (!m_fileTaggerMatcher)
+            m_fileTaggerMatcher = FileTaggerMatcher::get(fileTaggers);
+        matcher = m_fileTaggerMatcher;
     }
-    return result;
+    return matcher->fileTagsForFileName(fileName);
+}
+
+// Must be called whenever the list of file taggers changes after file tags have been looked up.
+void ResolvedProduct::resetFileTaggerMatcher()
+{
+    std::lock_guard<std::mutex> lock(m_fileTaggerMatcherLock);
+    m_fileTaggerMatcher.reset();
 }
 
 void ResolvedProduct::load(PersistentPool &pool)
@@ -557,18 +548,24 @@ std::vector<ResolvedProductPtr> ResolvedProject::allProducts() const
 void ResolvedProject::load(PersistentPool &pool)
 {
     serializationOp<PersistentPool::Load>(pool);
+
+    // Restore the parent links. They are collected first and then inserted in one go,
+    // as inserting them one by one is quadratic for nodes with many parents.
+    std::unordered_map<BuildGraphNode *, std::vector<BuildGraphNode *>> parentsPerNode;
     std::for_each(products.cbegin(), products.cend(),
-                  [](const ResolvedProductPtr &p) {
+                  [&parentsPerNode](const ResolvedProductPtr &p) {
         if (!p->buildData)
             return;
         for (BuildGraphNode * const node : qAsConst(p->buildData->allNodes())) {
             node->product = p;
-
-            // restore parent links
             for (BuildGraphNode * const child : qAsConst(node->children))
-                child->parents.insert(node);
+                parentsPerNode[child].push_back(node);
         }
     });
+    for (auto &nodeAndParents : parentsPerNode) {
+        nodeAndParents.first->parents.insert(nodeAndParents.second.cbegin(),
+                                             nodeAndParents.second.cend());
+    }
 }
 
 void ResolvedProject::store(PersistentPool &pool)
@@ -623,7 +620,7 @@ QString TopLevelProject::buildGraphFilePath() const
     return ProjectBuildData::deriveBuildGraphFilePath(buildDirectory, id());
 }
 
-void TopLevelProject::store(Logger logger)
+void TopLevelProject::store(Logger logger, bool logStatistics)
 {
     // TODO: Use progress observer here.
 
@@ -642,23 +639,237 @@ void TopLevelProject::store(Logger logger)
     PersistentPool::HeadData headData;
     headData.projectConfig = buildConfiguration();
     pool.setHeadData(headData);
+    pool.setCompressChunks(compressBuildGraph);
     pool.setupWriteStream(fileName);
     store(pool);
     pool.finalizeWriteStream();
+    if (logStatistics) {
+        const PersistentPool::ChunkStatistics &statistics = pool.chunkStatistics();
+        if (statistics.compressed) {
+            logger.qbsLog(LoggerInfo, true) << "\t"
+                    << Tr::tr("Compressing %1 bytes of build graph data to %2 bytes took %3.")
+                       .arg(statistics.dataSize).arg(statistics.storedSize)
+                       .arg(elapsedTimeString(statistics.compressionTime));
+        } else {
+            logger.qbsLog(LoggerInfo, true) << "\t"
+                    << Tr::tr("Stored %1 bytes of uncompressed build graph data.")
+                       .arg(statistics.dataSize);
+        }
+    }
     buildData->setClean();
 }
 
+// The project data refers to the products, so it is loaded after them in a chunk of its own.
 void TopLevelProject::load(PersistentPool &pool)
 {
-    ResolvedProject::load(pool);
-    serializationOp<PersistentPool::Load>(pool);
+    loadProducts(pool);
+    pool.loadChunks([this](PersistentPool &chunkPool, int) {
+        ResolvedProject::load(chunkPool);
+        serializationOp<PersistentPool::Load>(chunkPool);
+    });
     QBS_CHECK(buildData);
 }
 
 void TopLevelProject::store(PersistentPool &pool)
 {
-    ResolvedProject::store(pool);
-    serializationOp<PersistentPool::Store>(pool);
+    storeProducts(pool);
+    pool.storeChunks(1, [this](PersistentPool &chunkPool, int) {
+        ResolvedProject::store(chunkPool);
+        serializationOp<PersistentPool::Store>(chunkPool);
+    });
+}
+
+// The resolver shares some objects between products, e.g. the script functions of a module's
+// rules and their file contexts. They are stored once, in a chunk that is loaded before the
+// product chunks, rather than once per product.
+namespace {
+class SharedProductData
+{
+public:
+    SharedProductData(const TopLevelProject &project,
+                      const std::vector<ResolvedProductPtr> &products)
+    {
+        for (const ResolvedProductPtr &product : products) {
+            for (const ResolvedModulePtr &module : product->modules) {
+                add(module->setupBuildEnvironmentScript);
+                add(module->setupRunEnvironmentScript);
+            }
+            for (const RulePtr &rule : product->rules) {
+                add(rule->prepareScript);
+                add(rule->outputArtifactsScript);
+            }
+            for (const ResolvedScannerConstPtr &scanner : product->scanners) {
+                add(scanner->searchPathsScript);
+                add(scanner->scanScript);
+            }
+            for (const ProbeConstPtr &probe : product->probes)
+                add(probe, probes, m_seenProbes);
+        }
+        for (const ProbeConstPtr &probe : project.probes)
+            add(probe, probes, m_seenProbes);
+    }
+
+    std::vector<ResolvedFileContextConstPtr> fileContexts;
+    std::vector<ScriptFunctionConstPtr> scriptFunctions;
+    std::vector<ProbeConstPtr> probes;
+
+private:
+    void add(const PrivateScriptFunction &function)
+    {
+        const ScriptFunctionConstPtr &sharedData = function.sharedData();
+        if (!sharedData)
+            return;
+        add(sharedData, scriptFunctions, m_seenScriptFunctions);
+        if (sharedData->fileContext)
+            add(sharedData->fileContext, fileContexts, m_seenFileContexts);
+    }
+
+    template<typename T> static void add(const std::shared_ptr<const T> &object,
+                                         std::vector<std::shared_ptr<const T>> &objects,
+                                         Set<const T *> &seen)
+    {
+        if (seen.insert(object.get()).second)
+            objects.push_back(object);
+    }
+
+    Set<const ScriptFunction *> m_seenScriptFunctions;
+    Set<const ResolvedFileContext *> m_seenFileContexts;
+    Set<const Probe *> m_seenProbes;
+};
+} // namespace
+
+void TopLevelProject::loadSharedProductData(PersistentPool &pool)
+{
+    std::vector<ResolvedFileContextPtr> fileContexts(pool.load<int>());
+    for (ResolvedFileContextPtr &fileContext : fileContexts) {
+        fileContext = ResolvedFileContext::create();
+        pool.addGlobalObject(fileContext);
+    }
+    std::vector<ScriptFunctionPtr> scriptFunctions(pool.load<int>());
+    for (ScriptFunctionPtr &scriptFunction : scriptFunctions) {
+        scriptFunction = ScriptFunction::create();
+        pool.addGlobalObject(scriptFunction);
+    }
+    std::vector<ProbePtr> probes(pool.load<int>());
+    for (ProbePtr &probe : probes) {
+        probe = Probe::create();
+        pool.addGlobalObject(probe);
+    }
+    pool.loadChunks([&](PersistentPool &chunkPool, int) {
+        for (const ResolvedFileContextPtr &fileContext : fileContexts)
+            chunkPool.load(*fileContext);
+        for (const ScriptFunctionPtr &scriptFunction : scriptFunctions)
+            chunkPool.load(*scriptFunction);
+        for (const ProbePtr &probe : probes)
+            chunkPool.load(*probe);
+    });
+}
+
+void TopLevelProject::storeSharedProductData(PersistentPool &pool,
+                                             const std::vector<ResolvedProductPtr> &products)
+{
+    const SharedProductData data(*this, products);
+    pool.store(int(data.fileContexts.size()));
+    for (const ResolvedFileContextConstPtr &fileContext : data.fileContexts)
+        pool.addGlobalObject(fileContext);
+    pool.store(int(data.scriptFunctions.size()));
+    for (const ScriptFunctionConstPtr &scriptFunction : data.scriptFunctions)
+        pool.addGlobalObject(scriptFunction);
+    pool.store(int(data.probes.size()));
+    for (const ProbeConstPtr &probe : data.probes)
+        pool.addGlobalObject(probe);
+    pool.storeChunks(1, [&data](PersistentPool &chunkPool, int) {
+        for (const ResolvedFileContextConstPtr &fileContext : data.fileContexts)
+            chunkPool.store(*fileContext);
+        for (const ScriptFunctionConstPtr &scriptFunction : data.scriptFunctions)
+            chunkPool.store(*scriptFunction);
+        for (const ProbeConstPtr &probe : data.probes)
+            chunkPool.store(*probe);
+    });
+}
+
+// Every product is stored in a chunk of its own, so that the products can be loaded in parallel.
+// The file dependencies go into an additional chunk. The objects that can be referenced across
+// chunks are created before the chunks get loaded.
+// The parent links between the nodes are restored afterwards in ResolvedProject::load().
+void TopLevelProject::loadProducts(PersistentPool &pool)
+{
+    loadSharedProductData(pool);
+    std::vector<ResolvedProductPtr> products(pool.load<int>());
+    std::vector<std::vector<BuildGraphNode *>> nodesPerProduct(products.size());
+    for (std::size_t i = 0; i < products.size(); ++i) {
+        products[i] = ResolvedProduct::create();
+        pool.addGlobalObject(products.at(i));
+        for (const quint8 type : pool.load<std::vector<quint8>>()) {
+            switch (static_cast<BuildGraphNode::Type>(type)) {
+            case BuildGraphNode::ArtifactNodeType: {
+                const auto artifact = new Artifact;
+                pool.addGlobalObject(artifact);
+                nodesPerProduct[i].push_back(artifact);
+                break;
+            }
+            case BuildGraphNode::RuleNodeType: {
+                const auto ruleNode = new RuleNode;
+                pool.addGlobalObject(ruleNode);
+                nodesPerProduct[i].push_back(ruleNode);
+                break;
+            }
+            default:
+                QBS_CHECK(false);
+            }
+        }
+    }
+    std::vector<FileDependency *> fileDependencies(pool.load<int>());
+    for (FileDependency *&fileDependency : fileDependencies) {
+        fileDependency = new FileDependency;
+        pool.addGlobalObject(fileDependency);
+    }
+
+    pool.loadChunks([&](PersistentPool &chunkPool, int i) {
+        if (i == int(products.size())) {
+            for (FileDependency * const fileDependency : fileDependencies)
+                fileDependency->load(chunkPool);
+            return;
+        }
+        chunkPool.load(*products.at(i));
+        for (BuildGraphNode * const node : nodesPerProduct.at(i))
+            node->load(chunkPool);
+    });
+}
+
+void TopLevelProject::storeProducts(PersistentPool &pool)
+{
+    const std::vector<ResolvedProductPtr> products = allProducts();
+    storeSharedProductData(pool, products);
+    pool.store(int(products.size()));
+    for (const ResolvedProductPtr &product : products) {
+        pool.addGlobalObject(product);
+        std::vector<quint8> nodeTypes;
+        if (product->buildData) {
+            for (BuildGraphNode * const node : qAsConst(product->buildData->allNodes())) {
+                pool.addGlobalObject(node);
+                nodeTypes.push_back(static_cast<quint8>(node->type()));
+            }
+        }
+        pool.store(nodeTypes);
+    }
+    pool.store(int(buildData->fileDependencies.size()));
+    for (FileDependency * const fileDependency : qAsConst(buildData->fileDependencies))
+        pool.addGlobalObject(fileDependency);
+
+    pool.storeChunks(int(products.size()) + 1, [&](PersistentPool &chunkPool, int i) {
+        if (i == int(products.size())) {
+            for (FileDependency * const fileDependency : qAsConst(buildData->fileDependencies))
+                fileDependency->store(chunkPool);
+            return;
+        }
+        const ResolvedProductPtr &product = products.at(i);
+        chunkPool.store(*product);
+        if (!product->buildData)
+            return;
+        for (BuildGraphNode * const node : qAsConst(product->buildData->allNodes()))
+            node->store(chunkPool);
+    });
 }
 
 void TopLevelProject::cleanupModuleProviderOutput()
@@ -708,11 +919,72 @@ void TopLevelProject::cleanupModuleProviderOutput()
  * \brief The \c SourceArtifacts resulting from the expanded list of matching files.
  */
 
+// Matches file names against a single wildcard pattern. Like QDirIterator's name filters,
+// matching is case-insensitive. The common pattern forms are handled without
+// regular expressions.
+class WildcardMatcher
+{
+public:
+    explicit WildcardMatcher(const QString &pattern)
+    {
+        const int wildcardCount = int(std::count_if(pattern.cbegin(), pattern.cend(),
+                [](QChar c) { return c == QLatin1Char('*') || c == QLatin1Char('?')
+                                     || c == QLatin1Char('['); }));
+        if (wildcardCount == 0) {
+            m_kind = Literal;
+            m_text = pattern;
+        } else if (wildcardCount == 1 && pattern.startsWith(QLatin1Char('*'))) {
+            m_kind = pattern.size() == 1 ? Any : Suffix;
+            m_text = pattern.mid(1);
+        } else if (wildcardCount == 1 && pattern.endsWith(QLatin1Char('*'))) {
+            m_kind = Prefix;
+            m_text = pattern.left(pattern.size() - 1);
+        } else {
+            m_kind = RegularExpression;
+            m_regExp = QRegularExpression(QRegularExpression::wildcardToRegularExpression(pattern),
+                                          QRegularExpression::CaseInsensitiveOption);
+        }
+    }
+
+    bool matches(const QString &fileName) const
+    {
+        switch (m_kind) {
+        case Any:
+            return true;
+        case Literal:
+            return fileName.compare(m_text, Qt::CaseInsensitive) == 0;
+        case Suffix:
+            return fileName.endsWith(m_text, Qt::CaseInsensitive);
+        case Prefix:
+            return fileName.startsWith(m_text, Qt::CaseInsensitive);
+        case RegularExpression:
+            return m_regExp.match(fileName).hasMatch();
+        }
+        return false;
+    }
+
+private:
+    enum Kind { Any, Literal, Suffix, Prefix, RegularExpression };
+    Kind m_kind = Any;
+    QString m_text;
+    QRegularExpression m_regExp;
+};
+
 Set<QString> SourceWildCards::expandPatterns(const GroupConstPtr &group,
                                               const QString &baseDir, const QString &buildDir)
 {
+    dirTimeStamps.clear();
     Set<QString> files = expandPatterns(group, patterns, baseDir, buildDir);
     files -= expandPatterns(group, excludePatterns, baseDir, buildDir);
+
+    // A directory can be visited by more than one pattern, but needs to be checked only once
+    // when looking for changes.
+    std::sort(dirTimeStamps.begin(), dirTimeStamps.end());
+    dirTimeStamps.erase(std::unique(dirTimeStamps.begin(), dirTimeStamps.end(),
+                                    [](const std::pair<QString, FileTime> &p1,
+                                       const std::pair<QString, FileTime> &p2) {
+                            return p1.first == p2.first;
+                        }), dirTimeStamps.end());
     return files;
 }
 
@@ -755,7 +1027,7 @@ void SourceWildCards::expandPatterns(Set<QString> &result, const GroupConstPtr &
     if (baseDir.startsWith(buildDir))
         return;
 
-    dirTimeStamps.emplace_back(baseDir, FileInfo(baseDir).lastModified());
+    dirTimeStamps.emplace_back(baseDir, FileSystemCache::instance().lastModified(baseDir));
 
     QStringList changed_parts = parts;
     bool recursive = false;
@@ -788,21 +1060,35 @@ void SourceWildCards::expandPatterns(Set<QString> &result, const GroupConstPtr &
     if (filePattern != StringConstants::dotDot() && filePattern != StringConstants::dot())
         itFilters |= QDir::NoDotAndDotDot;
 
-    QDirIterator it(baseDir, QStringList(filePattern), itFilters, itFlags);
+    // The name filter is applied here rather than by the iterator, which would match each
+    // entry against a newly created regular expression. As a side effect, we get to see all
+    // the directories the iterator descends into, so that files appearing in any of them are
+    // detected later, not only in those that had matching entries before.
+    const WildcardMatcher matcher(filePattern);
+    QDirIterator it(baseDir, itFilters, itFlags);
     while (it.hasNext()) {
         const QString filePath = it.next();
-        const QString parentDir = it.fileInfo().dir().path();
+        const QFileInfo &fileInfo = it.fileInfo();
+        const QString parentDir = fileInfo.path();
         if (parentDir.startsWith(buildDir))
             continue; // See above.
-        if (!isDir && it.fileInfo().isDir() && !it.fileInfo().isSymLink())
+        const bool isRealDir = fileInfo.isDir() && !fileInfo.isSymLink();
+        if (recursive && isRealDir && !filePath.startsWith(buildDir)
+                && ((itFilters & QDir::Hidden) || !fileInfo.isHidden())) {
+            const QString fileName = it.fileName();
+            if (fileName != StringConstants::dot() && fileName != StringConstants::dotDot()) {
+                dirTimeStamps.emplace_back(filePath,
+                                           FileSystemCache::instance().lastModified(filePath));
+            }
+        }
+        if (!matcher.matches(it.fileName()))
+            continue;
+        if (!isDir && isRealDir)
             continue;
-        if (isDir) {
+        if (isDir)
             expandPatterns(result, group, changed_parts, filePath, buildDir);
-        } else {
-            if (parentDir != baseDir)
-                dirTimeStamps.emplace_back(parentDir, FileInfo(baseDir).lastModified());
+        else
             result += QDir::cleanPath(filePath);
-        }
     }
 }
 
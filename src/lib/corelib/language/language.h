@@ -79,6 +79,8 @@ class BuildGraphLocker;
 class BuildGraphLoader;
 class BuildGraphVisitor;
 
+class FileTaggerMatcher;
+
 class FileTagger
 {
 public:
@@ -88,7 +90,7 @@ public:
         return FileTaggerPtr(new FileTagger(patterns, fileTags, priority));
     }
 
-    const QList<QRegularExpression> &patterns() const { return m_patterns; }
+    const QStringList &patterns() const { return m_patterns; }
     const FileTags &fileTags() const { return m_fileTags; }
     int priority() const { return m_priority; }
 
@@ -101,9 +103,7 @@ private:
     FileTagger(const QStringList &patterns, FileTags fileTags, int priority);
     FileTagger() = default;
 
-    void setPatterns(const QStringList &patterns);
-
-    QList<QRegularExpression> m_patterns;
+    QStringList m_patterns;
     FileTags m_fileTags;
     int m_priority = 0;
 };
@@ -334,6 +334,7 @@ class PrivateScriptFunction
     friend bool operator==(const PrivateScriptFunction &a, const PrivateScriptFunction &b);
 public:
     void initialize(const ScriptFunctionPtr &sharedData) { m_sharedData = sharedData; }
+    const ScriptFunctionPtr &sharedData() const { return m_sharedData; }
     mutable QScriptValue scriptFunction; // not stored
 
     QString &sourceCode() const { return m_sharedData->sourceCode; }
@@ -588,6 +589,7 @@ public:
     std::vector<SourceArtifactPtr> allFiles() const;
     std::vector<SourceArtifactPtr> allEnabledFiles() const;
     FileTags fileTagsForFileName(const QString &fileName) const;
+    void resetFileTaggerMatcher();
 
     ArtifactSet lookupArtifactsByFileTag(const FileTag &tag) const;
     ArtifactSet lookupArtifactsByFileTags(const FileTags &tags) const;
@@ -633,6 +635,9 @@ private:
 
     QHash<QString, QString> m_executablePathCache;
     mutable std::mutex m_executablePathCacheLock;
+
+    mutable std::shared_ptr<const FileTaggerMatcher> m_fileTaggerMatcher;
+    mutable std::mutex m_fileTaggerMatcherLock;
 };
 
 class QBS_AUTOTEST_EXPORT ResolvedProject
@@ -686,6 +691,7 @@ public:
     static QString deriveBuildDirectory(const QString &buildRoot, const QString &id);
 
     QString buildDirectory; // Not saved
+    bool compressBuildGraph = false; // Not saved
     QProcessEnvironment environment;
     std::vector<ProbeConstPtr> probes;
     StoredModuleProviderInfo moduleProviderInfo;
@@ -713,7 +719,7 @@ public:
     QVariantMap overriddenValues;
 
     QString buildGraphFilePath() const;
-    void store(Logger logger);
+    void store(Logger logger, bool logStatistics = false);
 
 private:
     TopLevelProject();
@@ -728,6 +734,11 @@ private:
     }
     void load(PersistentPool &pool) override;
     void store(PersistentPool &pool) override;
+    void loadProducts(PersistentPool &pool);
+    void storeProducts(PersistentPool &pool);
+    void loadSharedProductData(PersistentPool &pool);
+    void storeSharedProductData(PersistentPool &pool,
+                                const std::vector<ResolvedProductPtr> &products);
 
     void cleanupModuleProviderOutput();
 
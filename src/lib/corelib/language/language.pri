@@ -12,6 +12,7 @@ HEADERS += \
     $$PWD/evaluatorscriptclass.h \
     $$PWD/filecontext.h \
     $$PWD/filecontextbase.h \
+    $$PWD/filetaggermatcher.h \
     $$PWD/filetags.h \
     $$PWD/forward_decls.h \
     $$PWD/identifiersearch.h \
@@ -37,6 +38,7 @@ HEADERS += \
     $$PWD/propertymapinternal.h \
     $$PWD/qualifiedid.h \
     $$PWD/resolvedfilecontext.h \
+    $$PWD/scriptbackend.h \
     $$PWD/scriptengine.h \
     $$PWD/scriptimporter.h \
     $$PWD/scriptpropertyobserver.h \
@@ -52,6 +54,7 @@ SOURCES += \
     $$PWD/evaluatorscriptclass.cpp \
     $$PWD/filecontext.cpp \
     $$PWD/filecontextbase.cpp \
+    $$PWD/filetaggermatcher.cpp \
     $$PWD/filetags.cpp \
     $$PWD/identifiersearch.cpp \
     $$PWD/item.cpp \
@@ -77,6 +80,14 @@ SOURCES += \
     $$PWD/scriptimporter.cpp \
     $$PWD/value.cpp
 
+isEmpty(QBS_SCRIPT_BACKEND): QBS_SCRIPT_BACKEND = qtscript
+equals(QBS_SCRIPT_BACKEND, qtscript) {
+    DEFINES += QBS_SCRIPT_BACKEND_QTSCRIPT
+    SOURCES += $$PWD/qtscriptbackend.cpp
+} else {
+    error("Unknown script backend '$$QBS_SCRIPT_BACKEND'.")
+}
+
 !qbs_no_dev_install {
     language_headers.files = $$PWD/forward_decls.h
     language_headers.path = $${QBS_INSTALL_PREFIX}/include/qbs/language
@@ -56,6 +56,7 @@
 #include <logging/translator.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
+#include <tools/filesystemcache.h>
 #include <tools/joblimits.h>
 #include <tools/jsliterals.h>
 #include <tools/profiling.h>
@@ -607,7 +608,7 @@ SourceArtifactPtr ProjectResolver::createSourceArtifact(const ResolvedProductPtr
 {
     const QString &baseDir = FileInfo::path(group->location.filePath());
     const QString absFilePath = QDir::cleanPath(FileInfo::resolvePath(baseDir, fileName));
-    if (!wildcard && !FileInfo(absFilePath).exists()) {
+    if (!wildcard && !FileSystemCache::instance().exists(absFilePath)) {
         if (errorInfo)
             errorInfo->append(Tr::tr("File '%1' does not exist.").arg(absFilePath), filesLocation);
         rproduct->missingSourceFiles << absFilePath;
@@ -1667,6 +1668,7 @@ void ProjectResolver::postProcess(const ResolvedProductPtr &product,
               [] (const FileTaggerConstPtr &a, const FileTaggerConstPtr &b) {
         return a->priority() > b->priority();
     });
+    product->resetFileTaggerMatcher();
     for (const RulePtr &rule : projectContext->rules) {
         RulePtr clonedRule = rule->clone();
         clonedRule->product = product.get();
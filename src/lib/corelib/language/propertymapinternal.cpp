@@ -83,6 +83,36 @@ void PropertyMapInternal::setValue(const QVariantMap &map)
     m_value = map;
 }
 
+// The per-module maps are stored separately, so that the ones that are shared between
+// the maps of a product and those of its groups are serialized only once and stay shared
+// after loading.
+void PropertyMapInternal::load(PersistentPool &pool)
+{
+    m_value.clear();
+    int count;
+    pool.load(count);
+    for (int i = 0; i < count; ++i) {
+        QString key;
+        bool isMap;
+        pool.load(key, isMap);
+        m_value.insert(key, isMap ? QVariant(pool.loadSharedVariantMap())
+                                  : pool.load<QVariant>());
+    }
+}
+
+void PropertyMapInternal::store(PersistentPool &pool)
+{
+    pool.store(int(m_value.size()));
+    for (auto it = m_value.cbegin(); it != m_value.cend(); ++it) {
+        const bool isMap = it.value().userType() == QMetaType::QVariantMap;
+        pool.store(it.key(), isMap);
+        if (isMap)
+            pool.storeSharedVariantMap(*static_cast<const QVariantMap *>(it.value().constData()));
+        else
+            pool.store(it.value());
+    }
+}
+
 QVariant moduleProperty(const QVariantMap &properties, const QString &moduleName,
                         const QString &key, bool *isPresent)
 {
@@ -92,7 +122,15 @@ QVariant moduleProperty(const QVariantMap &properties, const QString &moduleName
             *isPresent = false;
         return {};
     }
-    const QVariantMap &moduleMap = moduleIt.value().toMap();
+    const QVariant &moduleValue = moduleIt.value();
+    if (moduleValue.userType() != QMetaType::QVariantMap) {
+        if (isPresent)
+            *isPresent = false;
+        return {};
+    }
+
+    // Avoid creating a temporary copy of the module map; this function is called a lot.
+    const auto &moduleMap = *static_cast<const QVariantMap *>(moduleValue.constData());
     const auto propertyIt = moduleMap.find(key);
     if (propertyIt == moduleMap.end()) {
         if (isPresent)
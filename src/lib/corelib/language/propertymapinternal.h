@@ -61,10 +61,8 @@ public:
     QVariant property(const QStringList &name) const;
     void setValue(const QVariantMap &value);
 
-    template<PersistentPool::OpType opType> void completeSerializationOp(PersistentPool &pool)
-    {
-        pool.serializationOp<opType>(m_value);
-    }
+    void load(PersistentPool &pool);
+    void store(PersistentPool &pool);
 
 private:
     friend bool operator==(const PropertyMapInternal &lhs, const PropertyMapInternal &rhs);
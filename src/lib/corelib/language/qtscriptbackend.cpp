@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scriptbackend.h"
+
+#include "scriptengine.h"
+
+#include <tools/codelocation.h>
+
+#include <QtScript/qscriptclass.h>
+#include <QtScript/qscriptcontext.h>
+#include <QtScript/qscriptstring.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace qbs {
+namespace Internal {
+
+namespace {
+
+class QtScriptClassAdapter : public QScriptClass
+{
+public:
+    QtScriptClassAdapter(QScriptEngine *engine, ScriptClass *scriptClass)
+        : QScriptClass(engine), m_scriptClass(scriptClass) {}
+
+private:
+    QueryFlags queryProperty(const QScriptValue &object, const QScriptString &name,
+                             QueryFlags flags, uint *id) override
+    {
+        Q_UNUSED(id);
+        return m_scriptClass->hasProperty(ScriptValue(object), name.toString())
+                ? (flags & HandlesReadAccess) : QueryFlags();
+    }
+
+    QScriptValue property(const QScriptValue &object, const QScriptString &name,
+                          uint id) override
+    {
+        Q_UNUSED(id);
+        return m_scriptClass->property(ScriptValue(object), name.toString()).toQtScript();
+    }
+
+    ScriptClass * const m_scriptClass;
+};
+
+class QtScriptBackend : public ScriptBackend
+{
+public:
+    QtScriptBackend(Logger &logger, EvalContext evalContext)
+        : m_engine(ScriptEngine::create(logger, evalContext))
+    {
+    }
+
+    ScriptValue globalObject() const override { return ScriptValue(m_engine->globalObject()); }
+    void setGlobalObject(const ScriptValue &object) override
+    {
+        m_engine->setGlobalObject(object.toQtScript());
+    }
+    ScriptValue newObject() override { return ScriptValue(m_engine->newObject()); }
+    ScriptValue newObject(ScriptClass *scriptClass) override
+    {
+        std::unique_ptr<QtScriptClassAdapter> &adapter = m_classAdapters[scriptClass];
+        if (!adapter)
+            adapter = std::make_unique<QtScriptClassAdapter>(m_engine.get(), scriptClass);
+        return ScriptValue(m_engine->newObject(adapter.get()));
+    }
+    ScriptValue toScriptValue(const QVariant &value) override
+    {
+        return ScriptValue(m_engine->toScriptValue(value));
+    }
+
+    ScriptProgram compile(const QString &sourceCode, const CodeLocation &location) override
+    {
+        return ScriptProgram(QScriptProgram(sourceCode, location.filePath(),
+                                            std::max(location.line(), 1)));
+    }
+    ScriptValue evaluate(const ScriptProgram &program) override
+    {
+        return ScriptValue(m_engine->evaluate(program.toQtScript()));
+    }
+    void pushScope(const ScriptValue &scope) override
+    {
+        m_engine->currentContext()->pushScope(scope.toQtScript());
+    }
+    void popScope() override { m_engine->currentContext()->popScope(); }
+    bool hasUncaughtException() const override { return m_engine->hasUncaughtException(); }
+    ScriptValue uncaughtException() const override
+    {
+        return ScriptValue(m_engine->uncaughtException());
+    }
+    void abortEvaluation() override { m_engine->abortEvaluation(); }
+
+    void import(const FileContextBaseConstPtr &fileCtx, ScriptValue &targetObject,
+                ObserveMode observeMode) override
+    {
+        m_engine->import(fileCtx, targetObject.toQtScript(), observeMode);
+    }
+    void setObservedProperty(ScriptValue &object, const QString &name,
+                             const ScriptValue &value) override
+    {
+        m_engine->setObservedProperty(object.toQtScript(), name, value.toQtScript());
+    }
+    void unobserveProperties() override { m_engine->unobserveProperties(); }
+
+    ScriptEngine *engine() const override { return m_engine.get(); }
+
+private:
+    std::unordered_map<ScriptClass *, std::unique_ptr<QtScriptClassAdapter>> m_classAdapters;
+
+    // Declared after the class adapters, so that the engine and the objects using the
+    // adapters are destroyed first.
+    const std::unique_ptr<ScriptEngine> m_engine;
+};
+
+} // namespace
+
+std::unique_ptr<ScriptBackend> ScriptBackend::create(Logger &logger, EvalContext evalContext)
+{
+    return std::make_unique<QtScriptBackend>(logger, evalContext);
+}
+
+ScriptBackend::~ScriptBackend() = default;
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_SCRIPTBACKEND_H
+#define QBS_SCRIPTBACKEND_H
+
+#include "forward_decls.h"
+
+#include <tools/qbs_export.h>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+
+#if !defined(QBS_SCRIPT_BACKEND_QTSCRIPT)
+#error "No script backend selected. The build system must define QBS_SCRIPT_BACKEND_<NAME>."
+#endif
+
+#ifdef QBS_SCRIPT_BACKEND_QTSCRIPT
+#include <QtScript/qscriptprogram.h>
+#include <QtScript/qscriptvalue.h>
+#endif
+
+#include <memory>
+
+namespace qbs {
+class CodeLocation;
+
+namespace Internal {
+class Logger;
+class ScriptEngine;
+enum class EvalContext;
+enum class ObserveMode;
+
+/*
+ * The interface between qbs and the JavaScript engine that evaluates project files and
+ * rule scripts. The backend is selected at build time via the scriptBackend property of
+ * the qbsbuildconfig module (QBS_SCRIPT_BACKEND for CMake and qmake).
+ * ScriptValue and ScriptProgram are cheap handles whose representation depends on the backend.
+ * This is a partial abstraction: Only the JavaScript command executor uses it so far, and
+ * even there the product and artifact setup still works on the QtScript values directly.
+ */
+class ScriptValue
+{
+public:
+    ScriptValue() = default;
+
+    bool isValid() const { return m_value.isValid(); }
+    bool isObject() const { return m_value.isObject(); }
+    bool isError() const { return m_value.isError(); }
+    bool isFunction() const { return m_value.isFunction(); }
+
+    ScriptValue property(const QString &name) const { return ScriptValue(m_value.property(name)); }
+    void setProperty(const QString &name, const ScriptValue &value)
+    {
+        m_value.setProperty(name, value.m_value);
+    }
+    ScriptValue prototype() const { return ScriptValue(m_value.prototype()); }
+    void setPrototype(const ScriptValue &prototype) { m_value.setPrototype(prototype.m_value); }
+
+    QString toString() const { return m_value.toString(); }
+    QVariant toVariant() const { return m_value.toVariant(); }
+
+#ifdef QBS_SCRIPT_BACKEND_QTSCRIPT
+    explicit ScriptValue(QScriptValue value) : m_value(std::move(value)) {}
+    QScriptValue &toQtScript() { return m_value; }
+    const QScriptValue &toQtScript() const { return m_value; }
+
+private:
+    QScriptValue m_value;
+#endif
+};
+
+// Source code that was compiled once and can be evaluated many times.
+class ScriptProgram
+{
+public:
+    ScriptProgram() = default;
+
+    bool isNull() const { return m_program.isNull(); }
+
+#ifdef QBS_SCRIPT_BACKEND_QTSCRIPT
+    explicit ScriptProgram(QScriptProgram program) : m_program(std::move(program)) {}
+    const QScriptProgram &toQtScript() const { return m_program; }
+
+private:
+    QScriptProgram m_program;
+#endif
+};
+
+// Provides properties of objects created via ScriptBackend::newObject() on demand.
+class ScriptClass
+{
+public:
+    virtual ~ScriptClass() = default;
+
+    virtual bool hasProperty(const ScriptValue &object, const QString &name) = 0;
+    virtual ScriptValue property(const ScriptValue &object, const QString &name) = 0;
+};
+
+class QBS_AUTOTEST_EXPORT ScriptBackend
+{
+public:
+    static std::unique_ptr<ScriptBackend> create(Logger &logger, EvalContext evalContext);
+    virtual ~ScriptBackend();
+
+    // Values
+    virtual ScriptValue globalObject() const = 0;
+    virtual void setGlobalObject(const ScriptValue &object) = 0;
+    virtual ScriptValue newObject() = 0;
+    virtual ScriptValue newObject(ScriptClass *scriptClass) = 0;
+    virtual ScriptValue toScriptValue(const QVariant &value) = 0;
+
+    // Evaluation
+    virtual ScriptProgram compile(const QString &sourceCode, const CodeLocation &location) = 0;
+    virtual ScriptValue evaluate(const ScriptProgram &program) = 0;
+    virtual void pushScope(const ScriptValue &scope) = 0;
+    virtual void popScope() = 0;
+    virtual bool hasUncaughtException() const = 0;
+    virtual ScriptValue uncaughtException() const = 0;
+    virtual void abortEvaluation() = 0;
+
+    // Imports and property observation
+    virtual void import(const FileContextBaseConstPtr &fileCtx, ScriptValue &targetObject,
+                        ObserveMode observeMode) = 0;
+    virtual void setObservedProperty(ScriptValue &object, const QString &name,
+                                     const ScriptValue &value) = 0;
+    virtual void unobserveProperties() = 0;
+
+    // The engine-independent bookkeeping, e.g. of the properties requested in a script,
+    // as well as the code that still uses the QtScript API directly.
+    virtual ScriptEngine *engine() const = 0;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_SCRIPTBACKEND_H
@@ -214,6 +214,23 @@ void ScriptEngine::clearImportsCache()
     m_jsImportCache.clear();
 }
 
+// Identical scripts at the same location, such as the prepare scripts of a module's rule
+// in different products, are compiled only once per engine. This is safe because
+// such functions are evaluated in the global context and resolve names at call time.
+QScriptValue ScriptEngine::evaluateFunction(const QString &sourceCode,
+                                            const CodeLocation &location)
+{
+    const auto key = std::make_pair(sourceCode,
+                                    std::make_pair(location.filePath(), location.line()));
+    const auto it = m_functionCache.constFind(key);
+    if (it != m_functionCache.constEnd())
+        return it.value();
+    const QScriptValue function = evaluate(sourceCode, location.filePath(), location.line());
+    if (function.isFunction())
+        m_functionCache.insert(key, function);
+    return function;
+}
+
 void ScriptEngine::checkContext(const QString &operation,
                                 const DubiousContextList &dubiousContexts)
 {
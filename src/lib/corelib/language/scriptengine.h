@@ -111,6 +111,7 @@ public:
     void import(const FileContextBaseConstPtr &fileCtx, QScriptValue &targetObject,
                 ObserveMode observeMode);
     void clearImportsCache();
+    QScriptValue evaluateFunction(const QString &sourceCode, const CodeLocation &location);
 
     void setEvalContext(EvalContext c) { m_evalContext = c; }
     EvalContext evalContext() const { return m_evalContext; }
@@ -324,6 +325,7 @@ private:
     QScriptClass *m_artifactsScriptClass = nullptr;
     QHash<JsImport, QScriptValue> m_jsImportCache;
     std::unordered_map<QString, QScriptValue> m_jsFileCache;
+    QHash<std::pair<QString, std::pair<QString, int>>, QScriptValue> m_functionCache;
     bool m_propertyCacheEnabled;
     bool m_active;
     QHash<PropertyCacheKey, QVariant> m_propertyCache;
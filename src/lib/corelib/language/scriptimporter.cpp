@@ -116,6 +116,9 @@ private:
 };
 
 
+QHash<QString, std::pair<QString, QString>> ScriptImporter::m_sourceCodeCache;
+std::mutex ScriptImporter::m_sourceCodeCacheMutex;
+
 ScriptImporter::ScriptImporter(ScriptEngine *scriptEngine)
     : m_engine(scriptEngine)
 {
@@ -128,28 +131,41 @@ QScriptValue ScriptImporter::importSourceCode(const QString &sourceCode, const Q
     // The targetObject doesn't get overwritten but enhanced by the contents of the .js file.
     // This is necessary for library imports that consist of multiple js files.
 
-    QString &code = m_sourceCodeCache[filePath];
-    if (code.isEmpty()) {
-        QbsQmlJS::Engine engine;
-        QbsQmlJS::Lexer lexer(&engine);
-        lexer.setCode(sourceCode, 1, false);
-        QbsQmlJS::Parser parser(&engine);
-        if (!parser.parseProgram()) {
-            throw ErrorInfo(parser.errorMessage(), CodeLocation(filePath, parser.errorLineNumber(),
-                                                                parser.errorColumnNumber()));
-        }
-
-        IdentifierExtractor extractor;
-        extractor.start(parser.rootNode());
-        code = QLatin1String("(function(){\n") + sourceCode + extractor.suffix();
-    }
-
-    QScriptValue result = m_engine->evaluate(code, filePath, 0);
+    QScriptValue result = m_engine->evaluate(wrappedSourceCode(sourceCode, filePath), filePath, 0);
     throwOnEvaluationError(m_engine, result, [&filePath] () { return CodeLocation(filePath, 0); });
     copyProperties(result, targetObject);
     return result;
 }
 
+// The file is parsed only once per process, no matter how many engines import it.
+// The cache entry is validated against the source code, as the file might have changed
+// between two project resolves in the same process.
+QString ScriptImporter::wrappedSourceCode(const QString &sourceCode, const QString &filePath)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sourceCodeCacheMutex);
+        const auto it = m_sourceCodeCache.constFind(filePath);
+        if (it != m_sourceCodeCache.constEnd() && it->first == sourceCode)
+            return it->second;
+    }
+
+    QbsQmlJS::Engine engine;
+    QbsQmlJS::Lexer lexer(&engine);
+    lexer.setCode(sourceCode, 1, false);
+    QbsQmlJS::Parser parser(&engine);
+    if (!parser.parseProgram()) {
+        throw ErrorInfo(parser.errorMessage(), CodeLocation(filePath, parser.errorLineNumber(),
+                                                            parser.errorColumnNumber()));
+    }
+
+    IdentifierExtractor extractor;
+    extractor.start(parser.rootNode());
+    const QString code = QLatin1String("(function(){\n") + sourceCode + extractor.suffix();
+    std::lock_guard<std::mutex> lock(m_sourceCodeCacheMutex);
+    m_sourceCodeCache.insert(filePath, std::make_pair(sourceCode, code));
+    return code;
+}
+
 void ScriptImporter::copyProperties(const QScriptValue &src, QScriptValue &dst)
 {
     QScriptValueIterator it(src);
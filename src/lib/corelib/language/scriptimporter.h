@@ -44,6 +44,8 @@
 
 #include <QtScript/qscriptvalue.h>
 
+#include <mutex>
+
 namespace qbs {
 namespace Internal {
 
@@ -58,8 +60,13 @@ public:
     static void copyProperties(const QScriptValue &src, QScriptValue &dst);
 
 private:
+    QString wrappedSourceCode(const QString &sourceCode, const QString &filePath);
+
     ScriptEngine *m_engine;
-    QHash<QString, QString> m_sourceCodeCache;
+
+    // Shared between all engines. Maps a file path to its source code and the wrapped code.
+    static QHash<QString, std::pair<QString, QString>> m_sourceCodeCache;
+    static std::mutex m_sourceCodeCacheMutex;
 };
 
 } // namespace Internal
@@ -59,6 +59,7 @@ public:
     }
 
     QStringList changedFiles;
+    bool changedFilesComplete = false;
     QStringList filesToConsider;
     QStringList activeFileTags;
     JobLimits jobLimits;
@@ -74,6 +75,8 @@ public:
     bool removeExistingInstallation;
     bool onlyExecuteRules;
     bool jobLimitsFromProjectTakePrecedence = false;
+    int memoryBudget = 0;
+    bool streamProcessOutput = false;
 };
 
 } // namespace Internal
@@ -115,6 +118,30 @@ void BuildOptions::setChangedFiles(const QStringList &changedFiles)
     d->changedFiles = changedFiles;
 }
 
+/*!
+ * \brief Returns true if the list of changed files is complete even when it is empty.
+ * \sa setChangedFilesComplete
+ */
+bool BuildOptions::changedFilesComplete() const
+{
+    return d->changedFilesComplete;
+}
+
+/*!
+ * \brief Declares that no source files other than the ones in \c changedFiles() have changed
+ *        since qbs last retrieved their timestamps in this process.
+ * qbs then retrieves timestamps only for the changed files and for source files that it has not
+ * looked at yet, which makes repeated builds of the same project object very cheap.
+ * Unlike with a plain list of changed files, an empty list means that nothing has changed,
+ * and the listed files are only considered changed if their timestamp says so.
+ * This is meant for long-running clients that watch the source files of the project.
+ * The default is \c false.
+ */
+void BuildOptions::setChangedFilesComplete(bool complete)
+{
+    d->changedFilesComplete = complete;
+}
+
 /*!
  * \brief The list of files to consider.
  * \sa setFilesToConsider.
@@ -224,6 +251,29 @@ void BuildOptions::setProjectJobLimitsTakePrecedence(bool toggle)
     d->jobLimitsFromProjectTakePrecedence = toggle;
 }
 
+/*!
+ * \brief Returns the amount of memory in MiB that the running build jobs may use together.
+ * A value <= 0 means that there is no limit. The default is 0.
+ */
+int BuildOptions::memoryBudget() const
+{
+    return d->memoryBudget;
+}
+
+/*!
+ * \brief Sets the amount of memory in MiB that the running build jobs may use together.
+ * A new job is not started if its expected memory usage, added to that of the jobs that are
+ * currently running, would exceed this value. The expected memory usage of a job is the
+ * peak memory usage that its commands had in the previous build; jobs without such data
+ * are not restricted. A job is always started if no other job is running, so the build
+ * can make progress even if a single job exceeds the budget.
+ * A value <= 0 means that there is no limit.
+ */
+void BuildOptions::setMemoryBudget(int megaBytes)
+{
+    d->memoryBudget = megaBytes;
+}
+
 /*!
  * \brief Returns true iff qbs will not actually execute any commands, but just show what
  *        would happen.
@@ -395,10 +445,33 @@ void BuildOptions::setExecuteRulesOnly(bool onlyRules)
     d->onlyExecuteRules = onlyRules;
 }
 
+/*!
+ * \brief Returns true iff the output of processes is reported while they are running.
+ * The default is false.
+ */
+bool BuildOptions::streamProcessOutput() const
+{
+    return d->streamProcessOutput;
+}
+
+/*!
+ * If \a stream is \c true, then the output of a process command is reported via
+ * \c BuildJob::reportProcessOutput() in chunks of complete lines as it arrives, rather than
+ * only as part of the \c ProcessResult once the process has finished.
+ * Output that has been reported this way is not repeated in the final \c ProcessResult.
+ * Output channels that have a filter function or are redirected into a file are not streamed,
+ * because these operations need the complete output.
+ */
+void BuildOptions::setStreamProcessOutput(bool stream)
+{
+    d->streamProcessOutput = stream;
+}
+
 
 bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
 {
     return bo1.changedFiles() == bo2.changedFiles()
+            && bo1.changedFilesComplete() == bo2.changedFilesComplete()
             && bo1.dryRun() == bo2.dryRun()
             && bo1.keepGoing() == bo2.keepGoing()
             && bo1.logElapsedTime() == bo2.logElapsedTime()
@@ -443,6 +516,7 @@ qbs::BuildOptions qbs::BuildOptions::fromJson(const QJsonObject &data)
     using namespace Internal;
     BuildOptions opt;
     setValueFromJson(opt.d->changedFiles, data, "changed-files");
+    setValueFromJson(opt.d->changedFilesComplete, data, "changed-files-complete");
     setValueFromJson(opt.d->filesToConsider, data, "files-to-consider");
     setValueFromJson(opt.d->activeFileTags, data, "active-file-tags");
     setValueFromJson(opt.d->jobLimits, data, "job-limits");
@@ -457,6 +531,8 @@ qbs::BuildOptions qbs::BuildOptions::fromJson(const QJsonObject &data)
     setValueFromJson(opt.d->removeExistingInstallation, data, "clean-install-root");
     setValueFromJson(opt.d->onlyExecuteRules, data, "only-execute-rules");
     setValueFromJson(opt.d->jobLimitsFromProjectTakePrecedence, data, "enforce-project-job-limits");
+    setValueFromJson(opt.d->memoryBudget, data, "memory-budget");
+    setValueFromJson(opt.d->streamProcessOutput, data, "stream-process-output");
     return opt;
 }
 
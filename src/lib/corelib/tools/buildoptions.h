@@ -70,6 +70,9 @@ public:
     QStringList changedFiles() const;
     void setChangedFiles(const QStringList &changedFiles);
 
+    bool changedFilesComplete() const;
+    void setChangedFilesComplete(bool complete);
+
     QStringList activeFileTags() const;
     void setActiveFileTags(const QStringList &fileTags);
 
@@ -86,6 +89,9 @@ public:
     bool projectJobLimitsTakePrecedence() const;
     void setProjectJobLimitsTakePrecedence(bool toggle);
 
+    int memoryBudget() const;
+    void setMemoryBudget(int megaBytes);
+
     bool dryRun() const;
     void setDryRun(bool dryRun);
 
@@ -113,6 +119,9 @@ public:
     bool executeRulesOnly() const;
     void setExecuteRulesOnly(bool onlyRules);
 
+    bool streamProcessOutput() const;
+    void setStreamProcessOutput(bool stream);
+
 private:
     QSharedDataPointer<Internal::BuildOptionsPrivate> d;
 };
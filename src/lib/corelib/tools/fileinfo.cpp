@@ -49,6 +49,8 @@
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qregularexpression.h>
 
+#include <algorithm>
+
 #if defined(Q_OS_UNIX)
 #include <cerrno>
 #include <sys/stat.h>
@@ -191,6 +193,27 @@ bool FileInfo::isPattern(QStringView str)
     return false;
 }
 
+/**
+ * Joins the non-empty entries of \a paths with a slash and removes duplicate slashes
+ * from the result.
+ */
+QString FileInfo::joinPaths(const QStringList &paths)
+{
+    QString path;
+    for (const QString &p : paths) {
+        if (p.isEmpty())
+            continue;
+        if (!path.isEmpty())
+            path += QLatin1Char('/');
+        path += p;
+    }
+    const auto it = std::unique(path.begin(), path.end(), [](QChar c1, QChar c2) {
+        return c1 == c2 && c1 == QLatin1Char('/');
+    });
+    path.resize(int(it - path.begin()));
+    return path;
+}
+
 /**
  * Concatenates the paths \a base and \a rel.
  * Base must be an absolute path.
@@ -78,6 +78,7 @@ public:
     static bool isPattern(QStringView str);
     static QString resolvePath(const QString &base, const QString &rel,
                                HostOsInfo::HostOs hostOs = HostOsInfo::hostOs());
+    static QString joinPaths(const QStringList &paths);
     static bool isFileCaseCorrect(const QString &filePath);
 
     // Symlink-correct check.
@@ -0,0 +1,122 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "filesystemcache.h"
+
+#include "qbsassert.h"
+
+namespace qbs {
+namespace Internal {
+
+FileSystemCache &FileSystemCache::instance()
+{
+    static thread_local FileSystemCache cache;
+    return cache;
+}
+
+FileSystemCache::Scope::Scope() : m_cache(instance())
+{
+    ++m_cache.m_scopeCount;
+}
+
+FileSystemCache::Scope::~Scope()
+{
+    QBS_CHECK(m_cache.m_scopeCount > 0);
+    if (--m_cache.m_scopeCount > 0)
+        return;
+    m_cache.m_fileInfos.clear();
+    m_cache.m_directoryEntries.clear();
+}
+
+FileInfo FileSystemCache::fileInfo(const QString &filePath)
+{
+    if (m_scopeCount == 0)
+        return FileInfo(filePath);
+    const QString key = normalizedPath(filePath);
+    const auto it = m_fileInfos.find(key);
+    if (it != m_fileInfos.end())
+        return it->second;
+    return m_fileInfos.emplace(key, FileInfo(key)).first->second;
+}
+
+QStringList FileSystemCache::directoryEntries(const QString &dirPath, QDir::Filters filters)
+{
+    if (m_scopeCount == 0)
+        return QDir(dirPath).entryList(filters, QDir::Name);
+    const auto key = std::make_pair(normalizedPath(dirPath), int(filters));
+    const auto it = m_directoryEntries.constFind(key);
+    if (it != m_directoryEntries.constEnd())
+        return it.value();
+    const QStringList entries = QDir(key.first).entryList(filters, QDir::Name);
+    m_directoryEntries.insert(key, entries);
+    return entries;
+}
+
+void FileSystemCache::invalidate(const QString &path)
+{
+    if (m_scopeCount == 0)
+        return;
+    const QString key = normalizedPath(path);
+    const QString prefix = key.endsWith(QLatin1Char('/')) ? key : key + QLatin1Char('/');
+    const auto isAffected = [&key, &prefix](const QString &p) {
+        return p == key || p.startsWith(prefix);
+    };
+    for (auto it = m_fileInfos.begin(); it != m_fileInfos.end();) {
+        if (isAffected(it->first))
+            it = m_fileInfos.erase(it);
+        else
+            ++it;
+    }
+    const QString parentDirPath = FileInfo::path(key);
+    for (auto it = m_directoryEntries.begin(); it != m_directoryEntries.end();) {
+        if (it.key().first == parentDirPath || isAffected(it.key().first))
+            it = m_directoryEntries.erase(it);
+        else
+            ++it;
+    }
+}
+
+QString FileSystemCache::normalizedPath(const QString &path)
+{
+    return QDir::cleanPath(FileInfo::isAbsolute(path) ? path
+                                                      : QDir::current().absoluteFilePath(path));
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,101 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_FILESYSTEMCACHE_H
+#define QBS_FILESYSTEMCACHE_H
+
+#include "fileinfo.h"
+#include "qbs_export.h"
+#include "qttools.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
+
+#include <unordered_map>
+
+namespace qbs {
+namespace Internal {
+
+// A cache of file metadata and directory listings.
+// Results are cached only while at least one Scope object exists; outside of scopes,
+// all queries go to the file system. The cache is cleared when the last scope ends.
+// Every thread has its own cache, so jobs running in parallel do not see each other's
+// scopes and results.
+// Paths are made absolute and cleaned before they are used as keys.
+class QBS_AUTOTEST_EXPORT FileSystemCache
+{
+public:
+    static FileSystemCache &instance();
+
+    class QBS_AUTOTEST_EXPORT Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        FileSystemCache &m_cache;
+    };
+
+    FileInfo fileInfo(const QString &filePath);
+    bool exists(const QString &filePath) { return fileInfo(filePath).exists(); }
+    FileTime lastModified(const QString &filePath) { return fileInfo(filePath).lastModified(); }
+    QStringList directoryEntries(const QString &dirPath, QDir::Filters filters);
+
+    // Must be called for files and directories that are created, changed or removed
+    // while a scope is active. Everything below the path is invalidated as well.
+    void invalidate(const QString &path);
+
+private:
+    FileSystemCache() = default;
+
+    static QString normalizedPath(const QString &path);
+
+    int m_scopeCount = 0;
+    std::unordered_map<QString, FileInfo> m_fileInfos;
+    QHash<std::pair<QString, int>, QStringList> m_directoryEntries;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_FILESYSTEMCACHE_H
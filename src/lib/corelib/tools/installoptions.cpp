@@ -54,13 +54,14 @@ class InstallOptionsPrivate : public QSharedData
 {
 public:
     InstallOptionsPrivate()
-        : useSysroot(false), removeExisting(false), dryRun(false),
+        : useSysroot(false), removeExisting(false), uninstall(false), dryRun(false),
           keepGoing(false), logElapsedTime(false)
     {}
 
     QString installRoot;
     bool useSysroot;
     bool removeExisting;
+    bool uninstall;
     bool dryRun;
     bool keepGoing;
     bool logElapsedTime;
@@ -170,6 +171,26 @@ void InstallOptions::setRemoveExistingInstallation(bool removeExisting)
     d->removeExisting = removeExisting;
 }
 
+/*!
+ * \brief Returns true iff the files recorded as installed will be removed instead of
+ *        installing anything.
+ * The default is false.
+ */
+bool InstallOptions::uninstall() const
+{
+    return d->uninstall;
+}
+
+/*!
+ * Controls whether to remove the previously installed files of the products.
+ * Only files that qbs has recorded in the project's install manifest are removed, so unlike
+ * with \c setRemoveExistingInstallation(), foreign files in the install root are left alone.
+ */
+void InstallOptions::setUninstall(bool uninstall)
+{
+    d->uninstall = uninstall;
+}
+
 /*!
  * \brief Returns true iff qbs will not actually copy any files, but just show what would happen.
  * The default is false.
@@ -233,6 +254,7 @@ qbs::InstallOptions qbs::InstallOptions::fromJson(const QJsonObject &data)
     setValueFromJson(opt.d->installRoot, data, "install-root");
     setValueFromJson(opt.d->useSysroot, data, "use-sysroot");
     setValueFromJson(opt.d->removeExisting, data, "clean-install-root");
+    setValueFromJson(opt.d->uninstall, data, "uninstall");
     setValueFromJson(opt.d->dryRun, data, "dry-run");
     setValueFromJson(opt.d->keepGoing, data, "keep-going");
     setValueFromJson(opt.d->logElapsedTime, data, "log-time");
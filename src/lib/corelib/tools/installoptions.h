@@ -78,6 +78,9 @@ public:
     bool removeExistingInstallation() const;
     void setRemoveExistingInstallation(bool removeExisting);
 
+    bool uninstall() const;
+    void setUninstall(bool uninstall);
+
     bool dryRun() const;
     void setDryRun(bool dryRun);
 
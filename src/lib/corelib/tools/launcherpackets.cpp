@@ -123,20 +123,39 @@ ProcessFinishedPacket::ProcessFinishedPacket(quintptr token)
 
 void ProcessFinishedPacket::doSerialize(QDataStream &stream) const
 {
-    stream << errorString << stdOut << stdErr
+    stream << errorString
            << static_cast<quint8>(exitStatus) << static_cast<quint8>(error)
-           << exitCode;
+           << exitCode << resourceUsage;
 }
 
 void ProcessFinishedPacket::doDeserialize(QDataStream &stream)
 {
-    stream >> errorString >> stdOut >> stdErr;
+    stream >> errorString;
     quint8 val;
     stream >> val;
     exitStatus = static_cast<QProcess::ExitStatus>(val);
     stream >> val;
     error = static_cast<QProcess::ProcessError>(val);
-    stream >> exitCode;
+    stream >> exitCode >> resourceUsage;
+}
+
+
+ProcessOutputPacket::ProcessOutputPacket(quintptr token)
+    : LauncherPacket(LauncherPacketType::ProcessOutput, token)
+{
+}
+
+void ProcessOutputPacket::doSerialize(QDataStream &stream) const
+{
+    stream << static_cast<quint8>(channel) << data;
+}
+
+void ProcessOutputPacket::doDeserialize(QDataStream &stream)
+{
+    quint8 c;
+    stream >> c;
+    channel = static_cast<QProcess::ProcessChannel>(c);
+    stream >> data;
 }
 
 ShutdownPacket::ShutdownPacket() : LauncherPacket(LauncherPacketType::Shutdown, 0) { }
@@ -40,6 +40,8 @@
 #ifndef QBS_LAUNCHERPACKETS_H
 #define QBS_LAUNCHERPACKETS_H
 
+#include "processresourceusage.h"
+
 #include <QtCore/qdatastream.h>
 #include <QtCore/qprocess.h>
 #include <QtCore/qstringlist.h>
@@ -52,7 +54,7 @@ namespace qbs {
 namespace Internal {
 
 enum class LauncherPacketType {
-    Shutdown, StartProcess, StopProcess, ProcessError, ProcessFinished
+    Shutdown, StartProcess, StopProcess, ProcessError, ProcessFinished, ProcessOutput
 };
 
 class PacketParser
@@ -159,11 +161,27 @@ public:
     ProcessFinishedPacket(quintptr token);
 
     QString errorString;
-    QByteArray stdOut;
-    QByteArray stdErr;
     QProcess::ExitStatus exitStatus = QProcess::ExitStatus::NormalExit;
     QProcess::ProcessError error = QProcess::ProcessError::UnknownError;
     int exitCode = 0;
+    ProcessResourceUsage resourceUsage;
+
+private:
+    void doSerialize(QDataStream &stream) const override;
+    void doDeserialize(QDataStream &stream) override;
+};
+
+// Output is sent while the process is running, so all of it has arrived
+// by the time the ProcessFinished packet is received.
+class ProcessOutputPacket : public LauncherPacket
+{
+public:
+    ProcessOutputPacket(quintptr token);
+
+    static int maxDataSize() { return 64 * 1024; }
+
+    QProcess::ProcessChannel channel = QProcess::StandardOutput;
+    QByteArray data;
 
 private:
     void doSerialize(QDataStream &stream) const override;
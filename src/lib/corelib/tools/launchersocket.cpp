@@ -115,6 +115,7 @@ void LauncherSocket::handleSocketDataAvailable()
     switch (m_packetParser.type()) {
     case LauncherPacketType::ProcessError:
     case LauncherPacketType::ProcessFinished:
+    case LauncherPacketType::ProcessOutput:
         emit packetArrived(m_packetParser.type(), m_packetParser.token(),
                            m_packetParser.packetData());
         break;
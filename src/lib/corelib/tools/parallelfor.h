@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_PARALLELFOR_H
+#define QBS_PARALLELFOR_H
+
+#include <QtCore/qthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// Calls func(i) for all i in [0, count) using as many threads as there are cores.
+// If some of the calls throw, the exception thrown for the lowest index is re-thrown
+// in the calling thread after all threads have finished, so errors are reported
+// deterministically. func must be safe to call concurrently for different indexes.
+// The worker threads get a stack as large as a typical main thread's, as the platform
+// defaults for secondary threads (512 KiB on macOS) are too small for recursive traversals
+// of big build graphs.
+template<typename Func> void parallelFor(size_t count, const Func &func)
+{
+    const size_t threadCount = std::min<size_t>(count,
+            std::max<size_t>(1, std::thread::hardware_concurrency()));
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::vector<std::exception_ptr> exceptions(count);
+    const auto worker = [&] {
+        for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+            try {
+                func(i);
+            } catch (...) {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::unique_ptr<QThread>> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i) {
+        threads.emplace_back(QThread::create(worker));
+        threads.back()->setStackSize(8 * 1024 * 1024);
+        threads.back()->start();
+    }
+    worker();
+    for (const std::unique_ptr<QThread> &thread : threads)
+        thread->wait();
+    for (const std::exception_ptr &exception : exceptions) {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+}
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_PARALLELFOR_H
@@ -40,15 +40,20 @@
 #include "persistence.h"
 
 #include "fileinfo.h"
+#include "parallelfor.h"
+#include "profiling.h"
 #include <logging/translator.h>
 #include <tools/error.h>
 
+#include <QtCore/qbuffer.h>
 #include <QtCore/qdir.h>
 
+#include <algorithm>
+
 namespace qbs {
 namespace Internal {
 
-static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-130";
+static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-139";
 
 NoBuildGraphError::NoBuildGraphError(const QString &filePath)
     : ErrorInfo(Tr::tr("Build graph not found for configuration '%1'. Expected location was '%2'.")
@@ -56,7 +61,8 @@ NoBuildGraphError::NoBuildGraphError(const QString &filePath)
 {
 }
 
-PersistentPool::PersistentPool(Logger &logger) : m_logger(logger)
+PersistentPool::PersistentPool(Logger &logger)
+    : m_globalObjects(std::make_shared<GlobalObjects>()), m_logger(logger)
 {
     Q_UNUSED(m_logger);
     m_stream.setVersion(QDataStream::Qt_4_8);
@@ -90,8 +96,12 @@ void PersistentPool::load(const QString &filePath)
     m_loadedRaw.clear();
     m_loaded.clear();
     m_storageIndices.clear();
+    m_globalObjects = std::make_shared<GlobalObjects>();
     m_stringStorage.clear();
     m_inverseStringStorage.clear();
+    m_variantMapStorage.clear();
+    m_variantMapIds.clear();
+    m_stringListDeltaBases.clear();
 }
 
 void PersistentPool::setupWriteStream(const QString &filePath)
@@ -138,6 +148,64 @@ void PersistentPool::finalizeWriteStream()
     }
 }
 
+void PersistentPool::storeChunks(int count, const ChunkFunction &storeChunk)
+{
+    std::vector<QByteArray> chunks(count);
+    for (int i = 0; i < count; ++i) {
+        QBuffer buffer(&chunks.at(i));
+        buffer.open(QIODevice::WriteOnly);
+        PersistentPool chunkPool(m_logger);
+        chunkPool.m_globalObjects = m_globalObjects;
+        chunkPool.m_stream.setDevice(&buffer);
+        storeChunk(chunkPool, i);
+        if (chunkPool.m_stream.status() != QDataStream::Ok)
+            throw ErrorInfo(Tr::tr("Failure serializing build graph."));
+        m_chunkStatistics.dataSize += chunks.at(i).size();
+    }
+    if (m_compressChunks) {
+        m_chunkStatistics.compressed = true;
+        AccumulatingTimer compressionTimer(&m_chunkStatistics.compressionTime);
+        parallelFor(chunks.size(), [&chunks](size_t i) {
+            chunks.at(i) = qCompress(chunks.at(i), 1);
+        });
+    }
+    for (const QByteArray &chunk : chunks)
+        m_chunkStatistics.storedSize += chunk.size();
+    store(m_compressChunks, chunks);
+}
+
+void PersistentPool::loadChunks(const ChunkFunction &loadChunk)
+{
+    const auto compressed = load<bool>();
+    auto chunks = load<std::vector<QByteArray>>();
+    for (const QByteArray &chunk : chunks)
+        m_chunkStatistics.storedSize += chunk.size();
+    if (compressed) {
+        m_chunkStatistics.compressed = true;
+        AccumulatingTimer decompressionTimer(&m_chunkStatistics.compressionTime);
+        parallelFor(chunks.size(), [&chunks](size_t i) {
+            QByteArray &chunk = chunks.at(i);
+            QByteArray data = qUncompress(chunk);
+
+            // The first four bytes hold the size of the uncompressed data.
+            if (data.isEmpty() && chunk.size() > 4)
+                throw ErrorInfo(Tr::tr("Failure decompressing build graph data."));
+            chunk = std::move(data);
+        });
+    }
+    for (const QByteArray &chunk : chunks)
+        m_chunkStatistics.dataSize += chunk.size();
+
+    parallelFor(chunks.size(), [this, &chunks, &loadChunk](size_t i) {
+        QBuffer buffer(&chunks.at(i));
+        buffer.open(QIODevice::ReadOnly);
+        PersistentPool chunkPool(m_logger);
+        chunkPool.m_globalObjects = m_globalObjects;
+        chunkPool.m_stream.setDevice(&buffer);
+        loadChunk(chunkPool, int(i));
+    });
+}
+
 void PersistentPool::storeVariant(const QVariant &variant)
 {
     const auto type = static_cast<quint32>(variant.userType());
@@ -160,6 +228,85 @@ void PersistentPool::storeVariant(const QVariant &variant)
     }
 }
 
+void PersistentPool::storeSharedVariantMap(const QVariantMap &map)
+{
+    if (map.isEmpty()) {
+        m_stream << EmptyValueId;
+        return;
+    }
+
+    // Maps sharing their data also share their nodes, so the address of the first value
+    // identifies the data. All stored maps are alive while storing, so addresses cannot
+    // get re-used.
+    const void * const key = &map.first();
+    const auto it = m_variantMapIds.find(key);
+    if (it != m_variantMapIds.end()) {
+        m_stream << it->second;
+        return;
+    }
+    const auto id = PersistentObjectId(m_variantMapStorage.size());
+    m_variantMapIds.emplace(key, id);
+    m_variantMapStorage.push_back(map);
+    m_stream << id;
+    store(map);
+}
+
+QVariantMap PersistentPool::loadSharedVariantMap()
+{
+    const auto id = load<PersistentObjectId>();
+    if (id == EmptyValueId)
+        return {};
+    QBS_CHECK(id >= 0);
+    if (id < PersistentObjectId(m_variantMapStorage.size()))
+        return m_variantMapStorage.at(id);
+    QBS_CHECK(id == PersistentObjectId(m_variantMapStorage.size()));
+    const auto map = load<QVariantMap>();
+    m_variantMapStorage.push_back(map);
+    return map;
+}
+
+void PersistentPool::storeStringListDelta(const QString &key, const QStringList &list)
+{
+    QStringList &base = m_stringListDeltaBases[key];
+    const int maxCommonLength = std::min(list.size(), base.size());
+    int prefixLength = 0;
+    while (prefixLength < maxCommonLength && list.at(prefixLength) == base.at(prefixLength))
+        ++prefixLength;
+    int suffixLength = 0;
+    while (suffixLength < maxCommonLength - prefixLength
+           && list.at(list.size() - suffixLength - 1) == base.at(base.size() - suffixLength - 1)) {
+        ++suffixLength;
+    }
+    const int middleLength = list.size() - prefixLength - suffixLength;
+    store(prefixLength, suffixLength, middleLength);
+    for (int i = prefixLength; i < prefixLength + middleLength; ++i)
+        store(list.at(i));
+    base = list;
+}
+
+QStringList PersistentPool::loadStringListDelta(const QString &key)
+{
+    QStringList &base = m_stringListDeltaBases[key];
+    int prefixLength;
+    int suffixLength;
+    int middleLength;
+    load(prefixLength, suffixLength, middleLength);
+    QBS_CHECK(prefixLength >= 0 && suffixLength >= 0 && middleLength >= 0);
+    QBS_CHECK(prefixLength + suffixLength <= base.size());
+    if (prefixLength == base.size() && middleLength == 0)
+        return base;
+    QStringList list;
+    list.reserve(prefixLength + middleLength + suffixLength);
+    for (int i = 0; i < prefixLength; ++i)
+        list << base.at(i);
+    for (int i = 0; i < middleLength; ++i)
+        list << load<QString>();
+    for (int i = base.size() - suffixLength; i < base.size(); ++i)
+        list << base.at(i);
+    base = list;
+    return list;
+}
+
 QVariant PersistentPool::loadVariant()
 {
     const auto type = load<quint32>();
@@ -187,8 +334,12 @@ void PersistentPool::clear()
 {
     m_loaded.clear();
     m_storageIndices.clear();
+    m_globalObjects = std::make_shared<GlobalObjects>();
     m_stringStorage.clear();
     m_inverseStringStorage.clear();
+    m_variantMapStorage.clear();
+    m_variantMapIds.clear();
+    m_stringListDeltaBases.clear();
 }
 
 void PersistentPool::doLoadValue(QString &s)
@@ -233,6 +384,7 @@ void PersistentPool::doStoreValue(const QProcessEnvironment &env)
 
 const PersistentPool::PersistentObjectId PersistentPool::ValueNotFoundId;
 const PersistentPool::PersistentObjectId PersistentPool::EmptyValueId;
+const PersistentPool::PersistentObjectId PersistentPool::FirstGlobalObjectId;
 
 } // namespace Internal
 } // namespace qbs
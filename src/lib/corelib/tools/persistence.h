@@ -53,6 +53,7 @@
 #include <QtCore/qstringlist.h>
 #include <QtCore/qvariant.h>
 
+#include <functional>
 #include <memory>
 #include <type_traits>
 #include <unordered_map>
@@ -82,6 +83,15 @@ public:
         QVariantMap projectConfig;
     };
 
+    class ChunkStatistics
+    {
+    public:
+        bool compressed = false;
+        qint64 dataSize = 0;
+        qint64 storedSize = 0;
+        qint64 compressionTime = 0; // Spent on compressing or decompressing, in milliseconds.
+    };
+
     template<typename ...Types> void store(const Types &...args)
     {
         (... , PPHelper<Types>::store(args, this));
@@ -119,9 +129,41 @@ public:
     const HeadData &headData() const { return m_headData; }
     void setHeadData(const HeadData &hd) { m_headData = hd; }
 
+    // Maps that share their data are stored only once and share their data again after loading.
+    void storeSharedVariantMap(const QVariantMap &map);
+    QVariantMap loadSharedVariantMap();
+
+    // A list is stored relative to the one previously stored under the same key, namely as the
+    // lengths of their common prefix and suffix plus the elements in between. This pays off for
+    // lists that differ only in a few places, such as the arguments of commands running the
+    // same program. Lists equal to their predecessor share their data after loading.
+    void storeStringListDelta(const QString &key, const QStringList &list);
+    QStringList loadStringListDelta(const QString &key);
+
+    // Objects that can be referenced from more than one chunk must be registered in the same
+    // order when storing and loading. References to them are stored as indexes, so they
+    // must already exist when the chunks are loaded, and their data must be stored separately.
+    template<typename T> void addGlobalObject(T *object);
+    template<typename T> void addGlobalObject(const std::shared_ptr<T> &object);
+
+    // Every chunk is stored and loaded with a pool of its own. The chunks are loaded concurrently.
+    // If compression is enabled, they are compressed and decompressed concurrently as well.
+    using ChunkFunction = std::function<void(PersistentPool &pool, int chunkIndex)>;
+    void storeChunks(int count, const ChunkFunction &storeChunk);
+    void loadChunks(const ChunkFunction &loadChunk);
+    void setCompressChunks(bool compress) { m_compressChunks = compress; }
+    const ChunkStatistics &chunkStatistics() const { return m_chunkStatistics; }
+
 private:
     using PersistentObjectId = int;
 
+    struct GlobalObjects
+    {
+        std::unordered_map<const void *, PersistentObjectId> indexes;
+        std::vector<void *> rawObjects;
+        std::vector<std::shared_ptr<void>> sharedObjects;
+    };
+
     template <typename T> T *idLoad();
     template <class T> std::shared_ptr<T> idLoadS();
     template <typename T> T idLoadValue();
@@ -147,6 +189,7 @@ private:
 
     static const PersistentObjectId ValueNotFoundId = -1;
     static const PersistentObjectId EmptyValueId = -2;
+    static const PersistentObjectId FirstGlobalObjectId = -3;
 
     std::unique_ptr<QIODevice> m_file;
     QDataStream m_stream;
@@ -155,6 +198,9 @@ private:
     std::vector<std::shared_ptr<void>> m_loaded;
     std::unordered_map<const void*, int> m_storageIndices;
     PersistentObjectId m_lastStoredObjectId = 0;
+    std::shared_ptr<GlobalObjects> m_globalObjects;
+    bool m_compressChunks = false;
+    ChunkStatistics m_chunkStatistics;
 
     std::vector<QString> m_stringStorage;
     QHash<QString, int> m_inverseStringStorage;
@@ -165,6 +211,9 @@ private:
     std::vector<QStringList> m_stringListStorage;
     QHash<QStringList, int> m_inverseStringListStorage;
     PersistentObjectId m_lastStoredStringListId = 0;
+    std::vector<QVariantMap> m_variantMapStorage;
+    std::unordered_map<const void *, PersistentObjectId> m_variantMapIds;
+    QHash<QString, QStringList> m_stringListDeltaBases;
     Logger &m_logger;
 
     template<typename T, typename Enable>
@@ -173,6 +222,21 @@ private:
 
 template<typename T> inline const void *uniqueAddress(const T *t) { return t; }
 
+template<typename T> inline void PersistentPool::addGlobalObject(T *object)
+{
+    const auto index = PersistentObjectId(m_globalObjects->rawObjects.size());
+    m_globalObjects->indexes.emplace(uniqueAddress(object), index);
+    m_globalObjects->rawObjects.push_back(const_cast<std::remove_const_t<T> *>(object));
+    m_globalObjects->sharedObjects.emplace_back();
+}
+
+template<typename T> inline void PersistentPool::addGlobalObject(const std::shared_ptr<T> &object)
+{
+    addGlobalObject(object.get());
+    m_globalObjects->sharedObjects.back()
+            = std::const_pointer_cast<std::remove_const_t<T>>(object);
+}
+
 template<typename T> inline void PersistentPool::storeSharedObject(const T *object)
 {
     if (!object) {
@@ -180,6 +244,11 @@ template<typename T> inline void PersistentPool::storeSharedObject(const T *obje
         return;
     }
     const void * const addr = uniqueAddress(object);
+    const auto globalObject = m_globalObjects->indexes.find(addr);
+    if (globalObject != m_globalObjects->indexes.end()) {
+        m_stream << FirstGlobalObjectId - globalObject->second;
+        return;
+    }
     const auto found = m_storageIndices.find(addr);
     if (found == m_storageIndices.end()) {
         PersistentObjectId id = m_lastStoredObjectId++;
@@ -196,6 +265,8 @@ template <typename T> inline T *PersistentPool::idLoad()
     PersistentObjectId id;
     m_stream >> id;
 
+    if (id <= FirstGlobalObjectId)
+        return static_cast<T *>(m_globalObjects->rawObjects.at(FirstGlobalObjectId - id));
     if (id < 0)
         return nullptr;
 
@@ -254,6 +325,12 @@ template <class T> inline std::shared_ptr<T> PersistentPool::idLoadS()
     PersistentObjectId id;
     m_stream >> id;
 
+    if (id <= FirstGlobalObjectId) {
+        const std::shared_ptr<void> &object
+                = m_globalObjects->sharedObjects.at(FirstGlobalObjectId - id);
+        QBS_CHECK(object);
+        return std::static_pointer_cast<T>(object);
+    }
     if (id < 0)
         return std::shared_ptr<T>();
 
@@ -408,6 +485,12 @@ template<> struct PPHelper<QVariant>
     static void load(QVariant &v, PersistentPool *pool) { v = pool->loadVariant(); }
 };
 
+template<> struct PPHelper<QByteArray>
+{
+    static void store(const QByteArray &v, PersistentPool *pool) { pool->m_stream << v; }
+    static void load(QByteArray &v, PersistentPool *pool) { pool->m_stream >> v; }
+};
+
 template<> struct PPHelper<QRegularExpression>
 {
     static void store(const QRegularExpression &re, PersistentPool *pool)
@@ -153,6 +153,14 @@ JobLimits Preferences::jobLimits() const
     return limits;
 }
 
+/*!
+ * \brief Returns true <=> the build graph should be stored in compressed form.
+ */
+bool Preferences::compressBuildGraph() const
+{
+    return getPreference(QStringLiteral("compressBuildGraph"), false).toBool();
+}
+
 QVariant Preferences::getPreference(const QString &key, const QVariant &defaultValue) const
 {
     static const QString keyPrefix = QStringLiteral("preferences");
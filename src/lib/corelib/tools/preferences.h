@@ -65,6 +65,7 @@ public:
     QStringList searchPaths(const QString &baseDir = QString()) const;
     QStringList pluginPaths(const QString &baseDir = QString()) const;
     JobLimits jobLimits() const;
+    bool compressBuildGraph() const;
 
 private:
     QVariant getPreference(const QString &key, const QVariant &defaultValue = QVariant()) const;
@@ -0,0 +1,148 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "processoutputbuffer.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtemporaryfile.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+ProcessOutputBuffer::ProcessOutputBuffer(qint64 memoryLimit) : m_memoryLimit(memoryLimit)
+{
+}
+
+ProcessOutputBuffer::~ProcessOutputBuffer() = default;
+
+void ProcessOutputBuffer::append(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+    m_size += data.size();
+    if (m_spillFile && !m_spillFileFailed) {
+        const qint64 written = m_spillFile->write(data);
+        if (written == data.size())
+            return;
+
+        // Whatever did not make it into the file is kept in memory from now on.
+        m_spillFileFailed = true;
+        m_data.append(data.mid(int(std::max<qint64>(written, 0))));
+        return;
+    }
+    m_data.append(data);
+    if (!m_spillFile && m_data.size() > m_memoryLimit)
+        spill();
+}
+
+void ProcessOutputBuffer::clear()
+{
+    m_data.clear();
+    m_spillFile.reset();
+    m_spillFileFailed = false;
+    m_size = 0;
+}
+
+QByteArray ProcessOutputBuffer::readAll() const
+{
+    if (!m_spillFile)
+        return m_data;
+    QByteArray content;
+    content.reserve(int(m_size));
+    if (!readChunks([&content](const QByteArray &chunk) { content += chunk; }))
+        return {};
+    return content;
+}
+
+// Passes the contents to the consumer piece by piece, so that spilled data does not have
+// to be read back into memory all at once.
+bool ProcessOutputBuffer::readChunks(const std::function<void(const QByteArray &)> &consumer,
+                                     qint64 chunkSize) const
+{
+    if (m_spillFile) {
+        m_spillFile->flush();
+        QFile file(m_spillFile->fileName());
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        while (!file.atEnd()) {
+            const QByteArray chunk = file.read(chunkSize);
+            if (chunk.isEmpty())
+                return false;
+            consumer(chunk);
+        }
+    }
+    for (int offset = 0; offset < m_data.size(); offset += int(chunkSize))
+        consumer(m_data.mid(offset, int(chunkSize)));
+    return true;
+}
+
+// Does not read spilled data back into memory.
+bool ProcessOutputBuffer::saveToFile(const QString &filePath) const
+{
+    QFile::remove(filePath);
+    if (m_spillFile) {
+        m_spillFile->flush();
+        if (!QFile::copy(m_spillFile->fileName(), filePath))
+            return false;
+    }
+    QFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+    if (f.write(m_data) != m_data.size())
+        return false;
+    f.close();
+    return f.error() == QFileDevice::NoError;
+}
+
+// If the temporary file cannot be written, the data simply stays in memory.
+bool ProcessOutputBuffer::spill()
+{
+    auto spillFile = std::make_unique<QTemporaryFile>(QDir::tempPath()
+                                                      + QLatin1String("/qbsoutput"));
+    if (!spillFile->open() || spillFile->write(m_data) != m_data.size())
+        return false;
+    m_spillFile = std::move(spillFile);
+    m_data.clear();
+    return true;
+}
+
+} // namespace Internal
+} // namespace qbs
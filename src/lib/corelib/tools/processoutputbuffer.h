@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_PROCESSOUTPUTBUFFER_H
+#define QBS_PROCESSOUTPUTBUFFER_H
+
+#include "qbs_export.h"
+
+#include <QtCore/qbytearray.h>
+
+#include <functional>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+class QTemporaryFile;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+// Collects the output of a process. Once the amount of data exceeds the memory limit,
+// all of it is moved into a temporary file, and subsequently appended data goes there as well.
+class QBS_AUTOTEST_EXPORT ProcessOutputBuffer
+{
+public:
+    explicit ProcessOutputBuffer(qint64 memoryLimit = defaultMemoryLimit());
+    ~ProcessOutputBuffer();
+
+    static qint64 defaultMemoryLimit() { return 4 * 1024 * 1024; }
+
+    void append(const QByteArray &data);
+    void clear();
+    qint64 size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    bool isSpilled() const { return !!m_spillFile; }
+
+    QByteArray readAll() const;
+    bool readChunks(const std::function<void(const QByteArray &)> &consumer,
+                    qint64 chunkSize = 64 * 1024) const;
+    bool saveToFile(const QString &filePath) const;
+
+private:
+    bool spill();
+
+    const qint64 m_memoryLimit;
+    QByteArray m_data;
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+    qint64 m_size = 0;
+    bool m_spillFileFailed = false;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_PROCESSOUTPUTBUFFER_H
@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_PROCESSRESOURCEUSAGE_H
+#define QBS_PROCESSRESOURCEUSAGE_H
+
+#include <QtCore/qdatastream.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+// What a process and its child processes consumed. A value of -1 means unknown.
+class ProcessResourceUsage
+{
+public:
+    qint64 userTime = -1;           // In milliseconds.
+    qint64 systemTime = -1;         // In milliseconds.
+    qint64 peakMemoryUsage = -1;    // In bytes.
+    qint64 bytesRead = -1;
+    qint64 bytesWritten = -1;
+
+    qint64 cpuTime() const
+    {
+        if (userTime < 0 && systemTime < 0)
+            return -1;
+        return std::max<qint64>(userTime, 0) + std::max<qint64>(systemTime, 0);
+    }
+
+    // For processes that ran one after the other: Times and I/O add up, memory does not.
+    void accumulate(const ProcessResourceUsage &other)
+    {
+        const auto add = [](qint64 &value, qint64 otherValue) {
+            if (otherValue >= 0)
+                value = std::max<qint64>(value, 0) + otherValue;
+        };
+        add(userTime, other.userTime);
+        add(systemTime, other.systemTime);
+        add(bytesRead, other.bytesRead);
+        add(bytesWritten, other.bytesWritten);
+        peakMemoryUsage = std::max(peakMemoryUsage, other.peakMemoryUsage);
+    }
+
+    bool isValid() const
+    {
+        return userTime >= 0 || systemTime >= 0 || peakMemoryUsage >= 0 || bytesRead >= 0
+                || bytesWritten >= 0;
+    }
+};
+
+inline QDataStream &operator<<(QDataStream &stream, const ProcessResourceUsage &usage)
+{
+    return stream << usage.userTime << usage.systemTime << usage.peakMemoryUsage
+                  << usage.bytesRead << usage.bytesWritten;
+}
+
+inline QDataStream &operator>>(QDataStream &stream, ProcessResourceUsage &usage)
+{
+    return stream >> usage.userTime >> usage.systemTime >> usage.peakMemoryUsage
+                  >> usage.bytesRead >> usage.bytesWritten;
+}
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_PROCESSRESOURCEUSAGE_H
@@ -124,6 +124,55 @@ QStringList ProcessResult::stdErr() const
     return d->stdErr;
 }
 
+/*!
+ * \brief Returns the CPU time in milliseconds that the command spent in user mode,
+ *        or -1 if that is unknown.
+ * Depending on the platform, the values reported by this and the following functions include
+ * the child processes of the command.
+ */
+qint64 ProcessResult::userTime() const
+{
+    return d->resourceUsage.userTime;
+}
+
+/*!
+ * \brief Returns the CPU time in milliseconds that the command spent in kernel mode,
+ *        or -1 if that is unknown.
+ */
+qint64 ProcessResult::systemTime() const
+{
+    return d->resourceUsage.systemTime;
+}
+
+/*!
+ * \brief Returns the maximum amount of memory in bytes that the command used at any time,
+ *        or -1 if that is unknown.
+ */
+qint64 ProcessResult::peakMemoryUsage() const
+{
+    return d->resourceUsage.peakMemoryUsage;
+}
+
+/*!
+ * \brief Returns the number of bytes the command read from storage devices,
+ *        or -1 if that is unknown.
+ * On Windows, all I/O operations of the process are counted.
+ */
+qint64 ProcessResult::bytesRead() const
+{
+    return d->resourceUsage.bytesRead;
+}
+
+/*!
+ * \brief Returns the number of bytes the command wrote to storage devices,
+ *        or -1 if that is unknown.
+ * On Windows, all I/O operations of the process are counted.
+ */
+qint64 ProcessResult::bytesWritten() const
+{
+    return d->resourceUsage.bytesWritten;
+}
+
 static QJsonValue processErrorToJson(QProcess::ProcessError error)
 {
     switch (error) {
@@ -147,7 +196,12 @@ QJsonObject qbs::ProcessResult::toJson() const
         {QStringLiteral("error"), processErrorToJson(error())},
         {QStringLiteral("exit-code"), exitCode()},
         {QStringLiteral("stdout"), QJsonArray::fromStringList(stdOut())},
-        {QStringLiteral("stderr"), QJsonArray::fromStringList(stdErr())}
+        {QStringLiteral("stderr"), QJsonArray::fromStringList(stdErr())},
+        {QStringLiteral("user-time"), userTime()},
+        {QStringLiteral("system-time"), systemTime()},
+        {QStringLiteral("peak-memory-usage"), peakMemoryUsage()},
+        {QStringLiteral("bytes-read"), bytesRead()},
+        {QStringLiteral("bytes-written"), bytesWritten()}
     };
 }
 
@@ -76,6 +76,12 @@ public:
     QStringList stdOut() const;
     QStringList stdErr() const;
 
+    qint64 userTime() const;
+    qint64 systemTime() const;
+    qint64 peakMemoryUsage() const;
+    qint64 bytesRead() const;
+    qint64 bytesWritten() const;
+
 private:
     QExplicitlySharedDataPointer<Internal::ProcessResultPrivate> d;
 };
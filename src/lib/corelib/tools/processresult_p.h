@@ -39,6 +39,8 @@
 #ifndef QBS_PROCESSRESULT_P_H
 #define QBS_PROCESSRESULT_P_H
 
+#include "processresourceusage.h"
+
 #include <QtCore/qshareddata.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qprocess.h>
@@ -58,6 +60,7 @@ public:
     int exitCode = 0;
     QStringList stdOut;
     QStringList stdErr;
+    ProcessResourceUsage resourceUsage;
 };
 
 } // namespace Internal
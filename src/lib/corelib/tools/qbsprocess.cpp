@@ -70,6 +70,9 @@ void QbsProcess::start(const QString &command, const QStringList &arguments)
     }
     m_command = command;
     m_arguments = arguments;
+    m_stdout.clear();
+    m_stderr.clear();
+    m_resourceUsage = ProcessResourceUsage();
     m_state = QProcess::Starting;
     if (LauncherInterface::socket()->isReady())
         doStart();
@@ -136,6 +139,9 @@ void QbsProcess::handlePacket(LauncherPacketType type, quintptr token, const QBy
     case LauncherPacketType::ProcessFinished:
         handleFinishedPacket(payload);
         break;
+    case LauncherPacketType::ProcessOutput:
+        handleOutputPacket(payload);
+        break;
     default:
         QBS_ASSERT(false, break);
     }
@@ -175,11 +181,23 @@ void QbsProcess::handleFinishedPacket(const QByteArray &packetData)
     m_state = QProcess::NotRunning;
     const auto packet = LauncherPacket::extractPacket<ProcessFinishedPacket>(token(), packetData);
     m_exitCode = packet.exitCode;
-    m_stdout = packet.stdOut;
-    m_stderr = packet.stdErr;
+    m_resourceUsage = packet.resourceUsage;
     m_errorString = packet.errorString;
     emit finished(m_exitCode);
 }
 
+void QbsProcess::handleOutputPacket(const QByteArray &packetData)
+{
+    QBS_ASSERT(m_state == QProcess::Running, return);
+    const auto packet = LauncherPacket::extractPacket<ProcessOutputPacket>(token(), packetData);
+    if (packet.channel == QProcess::StandardOutput) {
+        m_stdout.append(packet.data);
+        emit readyReadStandardOutput();
+    } else {
+        m_stderr.append(packet.data);
+        emit readyReadStandardError();
+    }
+}
+
 } // namespace Internal
 } // namespace qbs
@@ -67,10 +67,13 @@ public:
     int exitCode() const { return m_exitCode; }
     QProcess::ProcessError error() const { return m_error; }
     QString errorString() const { return m_errorString; }
+    ProcessResourceUsage resourceUsage() const { return m_resourceUsage; }
 
 signals:
     void error(QProcess::ProcessError error);
     void finished(int exitCode);
+    void readyReadStandardOutput();
+    void readyReadStandardError();
 
 private:
     void doStart();
@@ -82,6 +85,7 @@ private:
                       const QByteArray &payload);
     void handleErrorPacket(const QByteArray &packetData);
     void handleFinishedPacket(const QByteArray &packetData);
+    void handleOutputPacket(const QByteArray &packetData);
     void handleSocketReady();
 
     quintptr token() const { return reinterpret_cast<quintptr>(this); }
@@ -96,6 +100,7 @@ private:
     QProcess::ProcessError m_error = QProcess::UnknownError;
     QProcess::ProcessState m_state = QProcess::NotRunning;
     int m_exitCode = 0;
+    ProcessResourceUsage m_resourceUsage;
     int m_connectionAttempts = 0;
     bool m_socketError = false;
 };
@@ -118,6 +118,7 @@ public:
     iterator find(const T &v) { return binaryFind(m_data.begin(), m_data.end(), v); }
     const_iterator find(const T &v) const { return binaryFind(m_data.cbegin(), m_data.cend(), v); }
     std::pair<iterator, bool> insert(const T &v);
+    template<typename InputIterator> void insert(InputIterator first, InputIterator last);
     Set &operator+=(const T &v) { insert(v); return *this; }
     Set &operator|=(const T &v) { return operator+=(v); }
     Set &operator<<(const T &v) { return operator+=(v); }
@@ -163,6 +164,11 @@ private:
     bool sortAfterLoadRequired() const { return helper::SortAfterLoad<T>::required; }
     iterator asMutableIterator(const_iterator cit);
 
+    // Above this number of elements, operations that take several elements are done
+    // by merging the sorted ranges, rather than inserting or removing elements one by one,
+    // which is quadratic.
+    static constexpr size_type MergeThreshold = 16;
+
     std::vector<T> m_data;
 };
 
@@ -210,6 +216,18 @@ template<typename T> std::pair<typename Set<T>::iterator, bool> Set<T>::insert(c
     return std::make_pair(it, false);
 }
 
+template<typename T>
+template<typename InputIterator>
+void Set<T>::insert(InputIterator first, InputIterator last)
+{
+    const auto oldSize = m_data.size();
+    std::copy(first, last, std::back_inserter(m_data));
+    const auto firstNew = m_data.begin() + oldSize;
+    std::sort(firstNew, m_data.end());
+    std::inplace_merge(m_data.begin(), firstNew, m_data.end());
+    m_data.erase(std::unique(m_data.begin(), m_data.end()), m_data.end());
+}
+
 template<typename T> bool Set<T>::contains(const Set<T> &other) const
 {
     auto it = cbegin();
@@ -247,6 +265,14 @@ template<typename T> Set<T> &Set<T>::unite(const Set<T> &other)
         m_data = other.m_data;
         return *this;
     }
+    if (other.size() > MergeThreshold) {
+        std::vector<T> united;
+        united.reserve(size() + other.size());
+        std::set_union(m_data.cbegin(), m_data.cend(), other.cbegin(), other.cend(),
+                       std::back_inserter(united));
+        m_data.swap(united);
+        return *this;
+    }
     auto lowerBound = m_data.begin();
     for (auto otherIt = other.cbegin(); otherIt != other.cend(); ++otherIt) {
         lowerBound = std::lower_bound(lowerBound, m_data.end(), *otherIt);
@@ -331,6 +357,14 @@ template<typename T> Set<T> &Set<T>::subtract(const Set<T> &other)
 {
     if (empty() || other.empty())
         return *this;
+    if (other.size() > MergeThreshold) {
+        std::vector<T> difference;
+        difference.reserve(size());
+        std::set_difference(m_data.cbegin(), m_data.cend(), other.cbegin(), other.cend(),
+                            std::back_inserter(difference));
+        m_data.swap(difference);
+        return *this;
+    }
     auto lowerBound = m_data.begin();
     for (auto otherIt = other.cbegin(); otherIt != other.cend(); ++otherIt) {
         lowerBound = std::lower_bound(lowerBound, m_data.end(), *otherIt);
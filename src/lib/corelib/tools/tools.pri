@@ -18,6 +18,7 @@ HEADERS += \
     $$PWD/executablefinder.h \
     $$PWD/fileinfo.h \
     $$PWD/filesaver.h \
+    $$PWD/filesystemcache.h \
     $$PWD/filetime.h \
     $$PWD/generateoptions.h \
     $$PWD/id.h \
@@ -36,10 +37,13 @@ HEADERS += \
     $$PWD/settings.h \
     $$PWD/settingsmodel.h \
     $$PWD/settingsrepresentation.h \
+    $$PWD/parallelfor.h \
     $$PWD/pathutils.h \
     $$PWD/preferences.h \
     $$PWD/profile.h \
     $$PWD/profiling.h \
+    $$PWD/processoutputbuffer.h \
+    $$PWD/processresourceusage.h \
     $$PWD/processresult.h \
     $$PWD/processresult_p.h \
     $$PWD/processutils.h \
@@ -76,6 +80,7 @@ SOURCES += \
     $$PWD/executablefinder.cpp \
     $$PWD/fileinfo.cpp \
     $$PWD/filesaver.cpp \
+    $$PWD/filesystemcache.cpp \
     $$PWD/filetime.cpp \
     $$PWD/generateoptions.cpp \
     $$PWD/id.cpp \
@@ -92,6 +97,7 @@ SOURCES += \
     $$PWD/settingsmodel.cpp \
     $$PWD/settingsrepresentation.cpp \
     $$PWD/preferences.cpp \
+    $$PWD/processoutputbuffer.cpp \
     $$PWD/processresult.cpp \
     $$PWD/processutils.cpp \
     $$PWD/profile.cpp \
@@ -44,3 +44,5 @@ CONFIG(static, static|shared) {
     DEFINES += QBS_STATIC_LIB
 }
 qbs_enable_unit_tests:DEFINES += QBS_ENABLE_UNIT_TESTS
+isEmpty(QBS_SCRIPT_BACKEND): QBS_SCRIPT_BACKEND = qtscript
+DEFINES += QBS_SCRIPT_BACKEND_$$upper($$QBS_SCRIPT_BACKEND)
@@ -58,8 +58,15 @@ public:
     {
         m_stopTimer->setSingleShot(true);
         connect(m_stopTimer, &QTimer::timeout, this, &Process::cancel);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0) && defined(Q_OS_UNIX)
+        setChildProcessModifier([this] {
+            ProcessResourceMonitor::setUpChildProcess(m_resourceReportFd);
+        });
+#endif
     }
 
+    void setResourceReportFd(int fd) { m_resourceReportFd = fd; }
+
     void cancel()
     {
         switch (m_stopState) {
@@ -91,8 +98,17 @@ public:
 signals:
     void failedToStop();
 
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+protected:
+    void setupChildProcess() override
+    {
+        ProcessResourceMonitor::setUpChildProcess(m_resourceReportFd);
+    }
+#endif
+
 private:
     const quintptr m_token;
+    int m_resourceReportFd = -1;
     QTimer * const m_stopTimer;
     enum class StopState { Inactive, Terminating, Killing } m_stopState = StopState::Inactive;
 };
@@ -186,26 +202,44 @@ void LauncherSocketHandler::handleProcessError()
     if (proc->error() != QProcess::FailedToStart)
         return;
     proc->stopStopProcedure();
+    m_resourceMonitor.forgetProcess(proc->token());
     ProcessErrorPacket packet(proc->token());
     packet.error = proc->error();
     packet.errorString = proc->errorString();
     sendPacket(packet);
 }
 
+void LauncherSocketHandler::handleProcessStarted()
+{
+    Process * proc = senderProcess();
+    m_resourceMonitor.processStarted(proc->token(), proc->processId());
+}
+
 void LauncherSocketHandler::handleProcessFinished()
 {
     Process * proc = senderProcess();
     proc->stopStopProcedure();
+    sendProcessOutput(proc, QProcess::StandardOutput);
+    sendProcessOutput(proc, QProcess::StandardError);
     ProcessFinishedPacket packet(proc->token());
     packet.error = proc->error();
     packet.errorString = proc->errorString();
     packet.exitCode = proc->exitCode();
     packet.exitStatus = proc->exitStatus();
-    packet.stdErr = proc->readAllStandardError();
-    packet.stdOut = proc->readAllStandardOutput();
+    packet.resourceUsage = m_resourceMonitor.processFinished(proc->token());
     sendPacket(packet);
 }
 
+void LauncherSocketHandler::handleProcessStandardOutput()
+{
+    sendProcessOutput(senderProcess(), QProcess::StandardOutput);
+}
+
+void LauncherSocketHandler::handleProcessStandardError()
+{
+    sendProcessOutput(senderProcess(), QProcess::StandardError);
+}
+
 void LauncherSocketHandler::handleStopFailure()
 {
     // Process did not react to a kill signal. Rare, but not unheard of.
@@ -213,12 +247,13 @@ void LauncherSocketHandler::handleStopFailure()
     Process * proc = senderProcess();
     proc->disconnect();
     m_processes.remove(proc->token());
+    m_resourceMonitor.forgetProcess(proc->token());
+    sendProcessOutput(proc, QProcess::StandardOutput);
+    sendProcessOutput(proc, QProcess::StandardError);
     ProcessFinishedPacket packet(proc->token());
     packet.error = QProcess::Crashed;
     packet.exitCode = -1;
     packet.exitStatus = QProcess::CrashExit;
-    packet.stdErr = proc->readAllStandardError();
-    packet.stdOut = proc->readAllStandardOutput();
     sendPacket(packet);
 }
 
@@ -236,7 +271,9 @@ void LauncherSocketHandler::handleStartPacket()
                 m_packetParser.packetData());
     process->setEnvironment(packet.env);
     process->setWorkingDirectory(packet.workingDir);
+    process->setResourceReportFd(m_resourceMonitor.prepareProcessStart(process->token()));
     process->start(packet.command, packet.arguments);
+    m_resourceMonitor.processStartAttempted(process->token());
 }
 
 void LauncherSocketHandler::handleStopPacket()
@@ -274,12 +311,31 @@ void LauncherSocketHandler::sendPacket(const LauncherPacket &packet)
     m_socket->write(packet.serialize());
 }
 
+// Output is forwarded as soon as it arrives, so it does not pile up in the launcher.
+// Large amounts of data are split, so that no single packet gets overly big.
+void LauncherSocketHandler::sendProcessOutput(Process *process, QProcess::ProcessChannel channel)
+{
+    const QByteArray output = channel == QProcess::StandardOutput
+            ? process->readAllStandardOutput() : process->readAllStandardError();
+    for (int pos = 0; pos < output.size(); pos += ProcessOutputPacket::maxDataSize()) {
+        ProcessOutputPacket packet(process->token());
+        packet.channel = channel;
+        packet.data = output.mid(pos, ProcessOutputPacket::maxDataSize());
+        sendPacket(packet);
+    }
+}
+
 Process *LauncherSocketHandler::setupProcess(quintptr token)
 {
     const auto p = new Process(token, this);
     connect(p, &QProcess::errorOccurred, this, &LauncherSocketHandler::handleProcessError);
+    connect(p, &QProcess::started, this, &LauncherSocketHandler::handleProcessStarted);
     connect(p, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
             this, &LauncherSocketHandler::handleProcessFinished);
+    connect(p, &QProcess::readyReadStandardOutput,
+            this, &LauncherSocketHandler::handleProcessStandardOutput);
+    connect(p, &QProcess::readyReadStandardError,
+            this, &LauncherSocketHandler::handleProcessStandardError);
     connect(p, &Process::failedToStop, this, &LauncherSocketHandler::handleStopFailure);
     return p;
 }
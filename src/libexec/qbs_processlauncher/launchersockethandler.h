@@ -40,11 +40,14 @@
 #ifndef QBS_LAUNCHERSOCKETHANDLER_H
 #define QBS_LAUNCHERSOCKETHANDLER_H
 
+#include "processresourcemonitor.h"
+
 #include <launcherpackets.h>
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qhash.h>
 #include <QtCore/qobject.h>
+#include <QtCore/qprocess.h>
 
 QT_BEGIN_NAMESPACE
 class QLocalSocket;
@@ -68,7 +71,10 @@ private:
     void handleSocketError();
     void handleSocketClosed();
     void handleProcessError();
+    void handleProcessStarted();
     void handleProcessFinished();
+    void handleProcessStandardOutput();
+    void handleProcessStandardError();
     void handleStopFailure();
 
     void handleStartPacket();
@@ -76,6 +82,7 @@ private:
     void handleShutdownPacket();
 
     void sendPacket(const LauncherPacket &packet);
+    void sendProcessOutput(Process *process, QProcess::ProcessChannel channel);
 
     Process *setupProcess(quintptr token);
     Process *senderProcess() const;
@@ -84,6 +91,7 @@ private:
     QLocalSocket * const m_socket;
     PacketParser m_packetParser;
     QHash<quintptr, Process *> m_processes;
+    ProcessResourceMonitor m_resourceMonitor;
 };
 
 } // namespace Internal
@@ -0,0 +1,410 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "processresourcemonitor.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qtimer.h>
+
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#   define PSAPI_VERSION 2      // GetProcessMemoryInfo from kernel32, no need to link Psapi.lib.
+#   include <QtCore/qt_windows.h>
+#   include <psapi.h>
+#else
+#   include <cerrno>
+#   include <csignal>
+#   include <cstring>
+#   include <fcntl.h>
+#   include <sys/resource.h>
+#   include <sys/time.h>
+#   include <sys/wait.h>
+#   include <unistd.h>
+#   ifdef Q_OS_LINUX
+#       include <sys/prctl.h>
+#       include <sys/syscall.h>
+#   endif
+#endif
+
+namespace qbs {
+namespace Internal {
+
+#ifdef Q_OS_LINUX
+static QByteArray readProcFile(const QString &filePath)
+{
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly))
+        return {};
+    return f.readAll();
+}
+
+static qint64 residentSetSize(qint64 pid)
+{
+    const QByteArray status = readProcFile(QStringLiteral("/proc/%1/status").arg(pid));
+    const int keyPos = status.indexOf("VmRSS:");
+    if (keyPos == -1)
+        return 0;
+    const int endPos = status.indexOf('\n', keyPos);
+    QByteArray value = status.mid(keyPos + 6, endPos == -1 ? -1 : endPos - keyPos - 6).trimmed();
+    if (value.endsWith(" kB"))
+        value.chop(3);
+    return value.toLongLong() * 1024;
+}
+
+static QList<qint64> childProcesses(qint64 pid)
+{
+    QList<qint64> children;
+    const QString taskDirPath = QStringLiteral("/proc/%1/task").arg(pid);
+    const QStringList tasks = QDir(taskDirPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &task : tasks) {
+        const QList<QByteArray> childList = readProcFile(
+                    taskDirPath + QLatin1Char('/') + task + QLatin1String("/children"))
+                .simplified().split(' ');
+        for (const QByteArray &child : childList) {
+            if (!child.isEmpty())
+                children << child.toLongLong();
+        }
+    }
+    return children;
+}
+
+// Compilers and linkers frequently do their heavy lifting in child processes,
+// so the whole tree needs to be considered. The intermediate process set up by
+// setUpChildProcess() is only a copy of the launcher, so it does not count.
+static qint64 processTreeResidentSetSize(qint64 pid, bool isIntermediateProcess)
+{
+    qint64 size = 0;
+    QList<qint64> pids;
+    if (isIntermediateProcess)
+        pids = childProcesses(pid);
+    else
+        pids << pid;
+    while (!pids.empty()) {
+        const qint64 current = pids.takeLast();
+        size += residentSetSize(current);
+        pids << childProcesses(current);
+    }
+    return size;
+}
+#endif // Q_OS_LINUX
+
+#if defined(Q_OS_WIN)
+static qint64 toMilliseconds(const FILETIME &fileTime)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = fileTime.dwLowDateTime;
+    value.HighPart = fileTime.dwHighDateTime;
+    return qint64(value.QuadPart / 10000); // 100 ns intervals.
+}
+#else
+static qint64 toMilliseconds(const timeval &time)
+{
+    return qint64(time.tv_sec) * 1000 + time.tv_usec / 1000;
+}
+
+// What the intermediate process writes into the pipe. Both sides are the same binary,
+// so there is no need for a portable format.
+struct ChildUsageReport
+{
+    qint64 userTime;
+    qint64 systemTime;
+    qint64 peakMemoryUsage;
+    qint64 bytesRead;
+    qint64 bytesWritten;
+};
+
+// Everything from here to setUpChildProcess() runs between fork() and exec(),
+// so only async-signal-safe functions may be used.
+static pid_t commandPid = 0;
+static const int forwardedSignals[] = {SIGTERM, SIGINT, SIGHUP, SIGQUIT};
+
+static void forwardSignal(int signal)
+{
+    if (commandPid > 0)
+        kill(commandPid, signal);
+}
+
+// The intermediate process must not keep the launcher's file descriptors open. Among them is
+// the pipe through which QProcess finds out whether exec() succeeded.
+static void closeFileDescriptorsExcept(int keepFd)
+{
+#if defined(Q_OS_LINUX) && defined(SYS_close_range)
+    if ((keepFd == 3 || syscall(SYS_close_range, 3u, unsigned(keepFd - 1), 0u) == 0)
+            && syscall(SYS_close_range, unsigned(keepFd + 1), ~0u, 0u) == 0) {
+        return;
+    }
+#endif
+    long maxFd = sysconf(_SC_OPEN_MAX);
+    if (maxFd < 0 || maxFd > 65536)
+        maxFd = 65536;
+    for (int fd = 3; fd < maxFd; ++fd) {
+        if (fd != keepFd)
+            close(fd);
+    }
+}
+
+static void writeReport(int fd, const struct rusage &ru)
+{
+    ChildUsageReport report;
+    report.userTime = toMilliseconds(ru.ru_utime);
+    report.systemTime = toMilliseconds(ru.ru_stime);
+#ifdef Q_OS_DARWIN
+    report.peakMemoryUsage = ru.ru_maxrss;
+#else
+    report.peakMemoryUsage = qint64(ru.ru_maxrss) * 1024;
+#endif
+    report.bytesRead = qint64(ru.ru_inblock) * 512;
+    report.bytesWritten = qint64(ru.ru_oublock) * 512;
+    while (write(fd, &report, sizeof report) == -1 && errno == EINTR)
+        ;
+}
+
+// Terminates the intermediate process the same way the command terminated.
+static void exitLike(int status)
+{
+    if (WIFSIGNALED(status)) {
+        const int signal = WTERMSIG(status);
+        const struct rlimit noCoreDumps = {0, 0};
+        setrlimit(RLIMIT_CORE, &noCoreDumps);
+        struct sigaction action;
+        std::memset(&action, 0, sizeof action);
+        action.sa_handler = SIG_DFL;
+        sigemptyset(&action.sa_mask);
+        sigaction(signal, &action, nullptr);
+        sigset_t signalSet;
+        sigemptyset(&signalSet);
+        sigaddset(&signalSet, signal);
+        sigprocmask(SIG_UNBLOCK, &signalSet, nullptr);
+        kill(getpid(), signal);
+    }
+    _exit(WIFEXITED(status) ? WEXITSTATUS(status) : 127);
+}
+#endif // Q_OS_WIN
+
+void ProcessResourceMonitor::setUpChildProcess(int reportFd)
+{
+#ifdef Q_OS_WIN
+    Q_UNUSED(reportFd);
+#else
+    if (reportFd == -1)
+        return;
+#ifdef Q_OS_LINUX
+    const pid_t intermediatePid = getpid();
+#endif
+    const pid_t pid = fork();
+    if (pid == -1)
+        return; // The command runs unobserved.
+    if (pid == 0) {
+#ifdef Q_OS_LINUX
+        // Do not outlive the intermediate process, which is what QProcess kills.
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        if (getppid() != intermediatePid)
+            _exit(127);
+#endif
+        close(reportFd);
+        return;
+    }
+
+    closeFileDescriptorsExcept(reportFd);
+    commandPid = pid;
+    struct sigaction action;
+    std::memset(&action, 0, sizeof action);
+    action.sa_handler = forwardSignal;
+    sigemptyset(&action.sa_mask);
+    sigset_t signalSet;
+    sigemptyset(&signalSet);
+    for (const int signal : forwardedSignals) {
+        sigaction(signal, &action, nullptr);
+        sigaddset(&signalSet, signal);
+    }
+    sigprocmask(SIG_UNBLOCK, &signalSet, nullptr);
+
+    int status = 0;
+    struct rusage ru;
+    pid_t result;
+    do {
+        result = wait4(pid, &status, 0, &ru);
+    } while (result == -1 && errno == EINTR);
+    if (result != pid)
+        _exit(127);
+    writeReport(reportFd, ru);
+    exitLike(status);
+#endif // Q_OS_WIN
+}
+
+ProcessResourceMonitor::ProcessResourceMonitor(QObject *parent)
+    : QObject(parent), m_sampleTimer(new QTimer(this))
+{
+    m_sampleTimer->setInterval(250);
+    connect(m_sampleTimer, &QTimer::timeout, this, &ProcessResourceMonitor::sample);
+}
+
+ProcessResourceMonitor::~ProcessResourceMonitor()
+{
+    const auto tokens = m_processes.keys();
+    for (const quintptr token : tokens)
+        forgetProcess(token);
+}
+
+int ProcessResourceMonitor::prepareProcessStart(quintptr token)
+{
+    forgetProcess(token);
+    ProcessData &data = m_processes[token];
+#ifdef Q_OS_WIN
+    Q_UNUSED(data);
+    return -1;
+#else
+    // The launcher is single-threaded, so no other process can be forked before the
+    // close-on-exec flags are set.
+    int fds[2];
+    if (pipe(fds) != 0)
+        return -1;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+    data.reportReadFd = fds[0];
+    data.reportWriteFd = fds[1];
+    return data.reportWriteFd;
+#endif
+}
+
+void ProcessResourceMonitor::processStartAttempted(quintptr token)
+{
+#ifndef Q_OS_WIN
+    // Only the child process must hold the write end, so that reading cannot block forever.
+    const auto it = m_processes.find(token);
+    if (it != m_processes.end() && it->reportWriteFd != -1) {
+        close(it->reportWriteFd);
+        it->reportWriteFd = -1;
+    }
+#else
+    Q_UNUSED(token);
+#endif
+}
+
+void ProcessResourceMonitor::processStarted(quintptr token, qint64 pid)
+{
+    ProcessData &data = m_processes[token];
+    data.pid = pid;
+#if defined(Q_OS_WIN)
+    data.handle = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, DWORD(pid));
+#elif defined(Q_OS_LINUX)
+    if (!m_sampleTimer->isActive())
+        m_sampleTimer->start();
+#endif
+}
+
+ProcessResourceUsage ProcessResourceMonitor::processFinished(quintptr token)
+{
+    const auto it = m_processes.find(token);
+    if (it == m_processes.end())
+        return {};
+    ProcessResourceUsage usage;
+    usage.peakMemoryUsage = it->peakMemoryUsage;
+#if defined(Q_OS_WIN)
+    if (it->handle) {
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(it->handle, &counters, sizeof counters))
+            usage.peakMemoryUsage = qint64(counters.PeakWorkingSetSize);
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+        if (GetProcessTimes(it->handle, &creationTime, &exitTime, &kernelTime, &userTime)) {
+            usage.userTime = toMilliseconds(userTime);
+            usage.systemTime = toMilliseconds(kernelTime);
+        }
+        IO_COUNTERS ioCounters;
+        if (GetProcessIoCounters(it->handle, &ioCounters)) {
+            usage.bytesRead = qint64(ioCounters.ReadTransferCount);
+            usage.bytesWritten = qint64(ioCounters.WriteTransferCount);
+        }
+    }
+#else
+    // The intermediate process has exited at this point, so the report is complete if it
+    // exists at all. It does not exist if the command could not be observed.
+    ChildUsageReport report;
+    ssize_t bytesRead;
+    do {
+        bytesRead = it->reportReadFd != -1 ? read(it->reportReadFd, &report, sizeof report) : 0;
+    } while (bytesRead == -1 && errno == EINTR);
+    if (bytesRead == sizeof report) {
+        usage.userTime = report.userTime;
+        usage.systemTime = report.systemTime;
+        usage.bytesRead = report.bytesRead;
+        usage.bytesWritten = report.bytesWritten;
+        usage.peakMemoryUsage = std::max(usage.peakMemoryUsage, report.peakMemoryUsage);
+    }
+#endif
+    forgetProcess(token);
+    return usage;
+}
+
+void ProcessResourceMonitor::forgetProcess(quintptr token)
+{
+    const auto it = m_processes.find(token);
+    if (it == m_processes.end())
+        return;
+#ifdef Q_OS_WIN
+    if (it->handle)
+        CloseHandle(it->handle);
+#else
+    for (const int fd : {it->reportReadFd, it->reportWriteFd}) {
+        if (fd != -1)
+            close(fd);
+    }
+#endif
+    m_processes.erase(it);
+    if (m_processes.empty())
+        m_sampleTimer->stop();
+}
+
+void ProcessResourceMonitor::sample()
+{
+#ifdef Q_OS_LINUX
+    for (ProcessData &data : m_processes) {
+        if (data.pid > 0) {
+            data.peakMemoryUsage = std::max(data.peakMemoryUsage,
+                    processTreeResidentSetSize(data.pid, data.reportReadFd != -1));
+        }
+    }
+#endif
+}
+
+} // namespace Internal
+} // namespace qbs
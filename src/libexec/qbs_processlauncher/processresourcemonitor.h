@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_PROCESSRESOURCEMONITOR_H
+#define QBS_PROCESSRESOURCEMONITOR_H
+
+#include <processresourceusage.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qobject.h>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+
+// Keeps track of the resources used by the processes started by the launcher.
+// The data is assembled from what the respective platform offers:
+//   - On Windows, the process is queried via a handle that we keep open, so the values
+//     are exact, but do not include child processes.
+//   - On Unix, QProcess reaps its children itself, and depending on the platform it might
+//     reap several of them at once, so neither wait4() nor the RUSAGE_CHILDREN counters can
+//     be used in the launcher. Instead, the child process forks once more in
+//     setUpChildProcess(): The actual command runs in the new process, while the original one
+//     waits for it with wait4(), writes the result into a pipe and then exits the same way
+//     the command did. The values cover the command and all of its child processes that
+//     were waited for. The peak memory usage is the one of the largest of these processes.
+//   - On Linux additionally, the resident set size of the process tree is sampled periodically,
+//     which catches child processes running in parallel.
+class ProcessResourceMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ProcessResourceMonitor(QObject *parent = nullptr);
+    ~ProcessResourceMonitor() override;
+
+    // Must be called right before the process is started. The return value is the file
+    // descriptor that has to be passed to setUpChildProcess(), or -1.
+    int prepareProcessStart(quintptr token);
+
+    // Must be called right after the attempt to start the process.
+    void processStartAttempted(quintptr token);
+
+    // Must be called in the child process between fork() and exec().
+    static void setUpChildProcess(int reportFd);
+
+    void processStarted(quintptr token, qint64 pid);
+
+    // Must be called right after the process has finished.
+    ProcessResourceUsage processFinished(quintptr token);
+
+    void forgetProcess(quintptr token);
+
+private:
+    struct ProcessData
+    {
+        qint64 pid = 0;
+        qint64 peakMemoryUsage = -1;
+        void *handle = nullptr;
+        int reportReadFd = -1;
+        int reportWriteFd = -1;
+    };
+
+    void sample();
+
+    QHash<quintptr, ProcessData> m_processes;
+    QTimer * const m_sampleTimer;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // Include guard
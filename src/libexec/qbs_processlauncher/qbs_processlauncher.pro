@@ -12,10 +12,13 @@ INCLUDEPATH += $$TOOLS_DIR
 HEADERS += \
     launcherlogging.h \
     launchersockethandler.h \
-    $$TOOLS_DIR/launcherpackets.h
+    processresourcemonitor.h \
+    $$TOOLS_DIR/launcherpackets.h \
+    $$TOOLS_DIR/processresourceusage.h
 
 SOURCES += \
     launcherlogging.cpp \
     launchersockethandler.cpp \
     processlauncher-main.cpp \
+    processresourcemonitor.cpp \
     $$TOOLS_DIR/launcherpackets.cpp
@@ -42,6 +42,7 @@
 #include <tools/stlutils.h>
 #include <tools/version.h>
 
+#include <QtCore/qcborvalue.h>
 #include <QtCore/qdebug.h>
 #include <QtCore/qelapsedtimer.h>
 #include <QtCore/qjsonarray.h>
@@ -50,6 +51,7 @@
 #include <QtCore/qjsonvalue.h>
 #include <QtCore/qlocale.h>
 #include <QtCore/qregularexpression.h>
+#include <QtCore/qscopeguard.h>
 #include <QtCore/qsettings.h>
 #include <QtCore/qtemporarydir.h>
 #include <QtCore/qtemporaryfile.h>
@@ -741,6 +743,62 @@ void TestBlackbox::buildEnvChange()
     QVERIFY(runQbs(params) != 0);
 }
 
+void TestBlackbox::buildGraphQuery()
+{
+    QDir::setCurrent(testDataDir + "/build-graph-query");
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("consuming input.copy"), m_qbsStdout.constData());
+    const QString copiedFilePath = relativeProductBuildDir("producer") + "/input.copy";
+    const QString consumedFilePath = relativeProductBuildDir("consumer") + "/input.consumed";
+
+    QbsRunParameters params("query", {"reverse-dependencies", "input.txt"});
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("input.copy"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("input.consumed"), m_qbsStdout.constData());
+
+    params.arguments = QStringList{"dependency-path", consumedFilePath, "input.txt"};
+    QCOMPARE(runQbs(params), 0);
+    const int consumedIndex = m_qbsStdout.indexOf("input.consumed");
+    const int copiedIndex = m_qbsStdout.indexOf("input.copy");
+    const int sourceIndex = m_qbsStdout.indexOf("input.txt");
+    QVERIFY2(consumedIndex != -1 && consumedIndex < copiedIndex && copiedIndex < sourceIndex,
+             m_qbsStdout.constData());
+
+    params.arguments = QStringList{"out-of-date-reasons", consumedFilePath};
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("No results."), m_qbsStdout.constData());
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("input.txt");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("The input '") && m_qbsStdout.contains("input.copy' is out of "
+                                                                          "date."),
+             m_qbsStdout.constData());
+    params.arguments = QStringList{"out-of-date-reasons", copiedFilePath};
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("input.txt' has changed."), m_qbsStdout.constData());
+
+    params.arguments = QStringList{"property-users", "product.copyTag"};
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("input.copy"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("input.consumed"), m_qbsStdout.constData());
+
+    // The prepare script uses the changed property, but the commands might not change.
+    QCOMPARE(runQbs(QbsRunParameters("resolve", {"products.producer.copyTag:other"})), 0);
+    params.arguments = QStringList{"out-of-date-reasons", copiedFilePath};
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("input.copy' may need re-generation: Values used by the "
+                                  "prepare script"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("commands generating"), m_qbsStdout.constData());
+
+    params.arguments = QStringList{"reverse-dependencies", "nosuchfile.txt"};
+    params.expectFailure = true;
+    QVERIFY(runQbs(params) != 0);
+    QVERIFY2(m_qbsStderr.contains("is not part of the build graph"), m_qbsStderr.constData());
+    params.arguments = QStringList{"nosuchquery"};
+    QVERIFY(runQbs(params) != 0);
+    QVERIFY2(m_qbsStderr.contains("Unknown build graph query"), m_qbsStderr.constData());
+}
+
 void TestBlackbox::buildGraphVersions()
 {
     QDir::setCurrent(testDataDir + "/build-graph-versions");
@@ -1727,6 +1785,43 @@ void TestBlackbox::clean()
         QVERIFY2(symlinkExists(symLink), qPrintable(symLink));
 }
 
+void TestBlackbox::compressedBuildGraph()
+{
+    QDir::setCurrent(testDataDir + "/compressed-build-graph");
+    qbs::Settings settings(QDir::currentPath() + "/settings-dir");
+    settings.setValue("preferences.compressBuildGraph", true);
+    settings.sync();
+    QbsRunParameters params(QStringList("--log-time"));
+    params.settingsDir = settings.baseDirectory();
+    params.profile = "none";
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("consuming input.copy"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("Compressing"), m_qbsStdout.constData());
+
+    // The links between the products must survive the round trip.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("input.txt");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("Decompressing"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("copying input.txt"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("consuming input.copy"), m_qbsStdout.constData());
+
+    // A compressed build graph can still be loaded after compression has been switched off.
+    settings.setValue("preferences.compressBuildGraph", false);
+    settings.sync();
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("input.txt");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("Decompressing"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("uncompressed build graph data"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("consuming input.copy"), m_qbsStdout.constData());
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("input.txt");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(!m_qbsStdout.contains("Decompressing"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("consuming input.copy"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::concurrentExecutor()
 {
     QDir::setCurrent(testDataDir + "/concurrent-executor");
@@ -2431,6 +2526,28 @@ void TestBlackbox::recursiveWildcards()
     QCOMPARE(outputFile.readAll(), QByteArray("file1.txtfile2.txt"));
 }
 
+void TestBlackbox::recursiveWildcardsNewSubdirMatch()
+{
+    QDir::setCurrent(testDataDir + "/recursive-wildcards-new-subdir-match");
+    QCOMPARE(runQbs(QbsRunParameters("install")), 0);
+    QVERIFY(QFileInfo(defaultInstallRoot + "/a.txt").exists());
+    QVERIFY(!QFileInfo(defaultInstallRoot + "/sub/ignored.dat").exists());
+
+    // The first match in a directory that did not contain any matches before
+    // must trigger a re-expansion of the wildcards.
+    WAIT_FOR_NEW_TIMESTAMP();
+    QFile newFile("src/sub/b.txt");
+    QVERIFY2(newFile.open(QIODevice::WriteOnly), qPrintable(newFile.errorString()));
+    newFile.close();
+    QCOMPARE(runQbs(QbsRunParameters("install")), 0);
+    QVERIFY2(m_qbsStdout.contains("Resolving"), m_qbsStdout.constData());
+    QVERIFY(QFileInfo(defaultInstallRoot + "/sub/b.txt").exists());
+
+    // Nothing changed, so the project must not get re-resolved.
+    QCOMPARE(runQbs(QbsRunParameters("install")), 0);
+    QVERIFY2(!m_qbsStdout.contains("Resolving"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::referenceErrorInExport()
 {
     QDir::setCurrent(testDataDir + "/referenceErrorInExport");
@@ -2505,6 +2622,52 @@ void TestBlackbox::reproducibleBuild_data()
     QTest::newRow("reproducible build") << true;
 }
 
+void TestBlackbox::resourceUsage()
+{
+    QDir::setCurrent(testDataDir + "/resource-usage");
+    QCOMPARE(runQbs({"resolve"}), 0);
+    if (m_qbsStdout.contains("targetPlatform differs from hostPlatform"))
+        QSKIP("Cannot run binaries in cross-compiled build");
+
+    // The commands run in parallel, so none of them must get charged for what the others used.
+    QCOMPARE(runQbs(QbsRunParameters(QStringList{"-j", "4"})), 0);
+    QVERIFY2(m_qbsStdout.contains("running busy"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("running idle1"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("running idle2"), m_qbsStdout.constData());
+
+    QCOMPARE(runQbs(QbsRunParameters("resource-usage")), 0);
+    static const QRegularExpression lineRegExp(
+                R"(^\s*(\S+(?: s)?)\s+(\S+(?: MiB)?)\s+(\S+(?: MiB)?)\s+(\S+(?: MiB)?)\s+)"
+                R"(\[runner\] running (\w+)\s*$)");
+    struct Usage { double cpuTime = -1; double peakMemory = -1; };
+    QHash<QString, Usage> usages;
+    const QList<QByteArray> lines = m_qbsStdout.split('\n');
+    for (const QByteArray &line : lines) {
+        const QRegularExpressionMatch match = lineRegExp.match(QString::fromLocal8Bit(line));
+        if (!match.hasMatch())
+            continue;
+        const auto value = [&match](int column) {
+            const QString text = match.captured(column);
+            return text == "-" ? -1.0 : text.split(' ').first().toDouble();
+        };
+        usages.insert(match.captured(5), Usage{value(1), value(2)});
+    }
+    QCOMPARE(usages.size(), 3);
+    const Usage busy = usages.value("busy");
+    QVERIFY2(busy.cpuTime >= 0.4, m_qbsStdout.constData());
+    QVERIFY2(busy.peakMemory >= 60, m_qbsStdout.constData());
+    for (const QString &idle : {QStringLiteral("idle1"), QStringLiteral("idle2")}) {
+        const Usage usage = usages.value(idle);
+        QVERIFY2(usage.cpuTime >= 0 && usage.cpuTime < 0.2, m_qbsStdout.constData());
+        QVERIFY2(usage.peakMemory < 32, m_qbsStdout.constData());
+    }
+
+    // The busy command comes first.
+    QCOMPARE(runQbs(QbsRunParameters("resource-usage", QStringList{"--top", "1"})), 0);
+    QVERIFY2(m_qbsStdout.contains("[runner] running busy"), m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("running idle"), m_qbsStdout.constData());
+}
+
 void TestBlackbox::responseFiles()
 {
     QDir::setCurrent(testDataDir + "/response-files");
@@ -4283,6 +4446,61 @@ void TestBlackbox::inputsFromDependencies()
              m_qbsStdout.constData());
 }
 
+void TestBlackbox::installManifest()
+{
+    QDir::setCurrent(testDataDir + "/install-manifest");
+    const QString installDir = defaultInstallRoot + "/content/";
+    const QString firstFile = installDir + "first.txt";
+    const QString secondFile = installDir + "second.txt";
+    const QString foreignFile = installDir + "foreign.txt";
+
+    QCOMPARE(runQbs(QbsRunParameters("install")), 0);
+    QVERIFY(regularFileExists(firstFile));
+    QVERIFY(regularFileExists(secondFile));
+    const QDateTime firstFileTime = QFileInfo(firstFile).lastModified();
+
+    // Unchanged files do not get copied again.
+    WAIT_FOR_NEW_TIMESTAMP();
+    QCOMPARE(runQbs(QbsRunParameters("install")), 0);
+    QCOMPARE(QFileInfo(firstFile).lastModified(), firstFileTime);
+
+    // Changed files do.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("first.txt", "first", "changed first");
+    QCOMPARE(runQbs(QbsRunParameters("install")), 0);
+    QVERIFY(QFileInfo(firstFile).lastModified() > firstFileTime);
+    QFile installedFirstFile(firstFile);
+    QVERIFY2(installedFirstFile.open(QIODevice::ReadOnly),
+             qPrintable(installedFirstFile.errorString()));
+    QVERIFY(installedFirstFile.readAll().contains("changed first"));
+    installedFirstFile.close();
+    REPLACE_IN_FILE("first.txt", "changed first", "first");
+
+    // Files that are no longer installed get removed, foreign files are left alone.
+    QFile foreign(foreignFile);
+    QVERIFY2(foreign.open(QIODevice::WriteOnly), qPrintable(foreign.errorString()));
+    foreign.close();
+    QCOMPARE(runQbs(QbsRunParameters("install",
+                                     QStringList("products.p.installSecond:false"))), 0);
+    QVERIFY(regularFileExists(firstFile));
+    QVERIFY(!QFile::exists(secondFile));
+    QVERIFY(regularFileExists(foreignFile));
+
+    // The same happens when installing as part of a build.
+    QCOMPARE(runQbs(QbsRunParameters("build",
+                                     QStringList("products.p.installSecond:true"))), 0);
+    QVERIFY(regularFileExists(secondFile));
+    QCOMPARE(runQbs(QbsRunParameters("build",
+                                     QStringList("products.p.installSecond:false"))), 0);
+    QVERIFY(regularFileExists(firstFile));
+    QVERIFY(!QFile::exists(secondFile));
+
+    // Uninstalling removes exactly what was installed.
+    QCOMPARE(runQbs(QbsRunParameters("install", QStringList("--uninstall"))), 0);
+    QVERIFY(!QFile::exists(firstFile));
+    QVERIFY(regularFileExists(foreignFile));
+}
+
 void TestBlackbox::installPackage()
 {
     if (HostOsInfo::hostOs() == HostOsInfo::HostOsWindows)
@@ -4675,6 +4893,26 @@ void TestBlackbox::jsExtensionsBinaryFile()
     QCOMPARE(data.at(5), char(0x05));
     QCOMPARE(data.at(6), char(0x06));
     QCOMPARE(data.at(7), char(0xFF));
+
+    QFile bytesDestination("bytes-destination.dat");
+    QVERIFY(bytesDestination.open(QIODevice::ReadOnly));
+    QCOMPARE(bytesDestination.readAll(), QByteArray::fromHex("0206ff121309ab0914"));
+}
+
+void TestBlackbox::jsExtensionsUtilitiesFileHash()
+{
+    QDir::setCurrent(testDataDir + "/jsextensions-utilities-filehash");
+    QbsRunParameters params(QStringList() << "-f" << "filehash.qbs");
+    QCOMPARE(runQbs(params), 0);
+    QVERIFY2(m_qbsStdout.contains("sha256: ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff"
+                                  "61f20015ad"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("md5: 900150983cd24fb0d6963f7d28e17f72"),
+             m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("sha1: a9993e364706816aba3e25717850c26c9cd0d89d "
+                                  "a9993e364706816aba3e25717850c26c9cd0d89d"),
+             m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("invalid algorithm rejected"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("missing file rejected"), m_qbsStdout.constData());
 }
 
 void TestBlackbox::lastModuleCandidateBroken()
@@ -6019,12 +6257,14 @@ void TestBlackbox::qbsConfigAddProfile_data()
                                     << QString("Profile properties must be key/value pairs");
 }
 
-static QJsonObject getNextSessionPacket(QProcess &session, QByteArray &data)
+static QJsonObject getNextSessionPacket(QProcess &session, QByteArray &data,
+                                        bool *isCbor = nullptr)
 {
     int totalSize = -1;
     QElapsedTimer timer;
     timer.start();
     QByteArray msg;
+    bool cbor = false;
     while (totalSize == -1 || msg.size() < totalSize) {
         if (data.isEmpty())
             session.waitForReadyRead(1000);
@@ -6032,11 +6272,18 @@ static QJsonObject getNextSessionPacket(QProcess &session, QByteArray &data)
             return QJsonObject();
         data += session.readAllStandardOutput();
         if (totalSize == -1) {
-            static const QByteArray magicString = "qbsmsg:";
-            const int magicStringOffset = data.indexOf(magicString);
+            static const QByteArray jsonMagicString = "qbsmsg:";
+            static const QByteArray cborMagicString = "qbscbor:";
+            int magicStringOffset = data.indexOf(jsonMagicString);
+            const int cborMagicStringOffset = data.indexOf(cborMagicString);
+            cbor = cborMagicStringOffset != -1
+                    && (magicStringOffset == -1 || cborMagicStringOffset < magicStringOffset);
+            if (cbor)
+                magicStringOffset = cborMagicStringOffset;
             if (magicStringOffset == -1)
                 continue;
-            const int sizeOffset = magicStringOffset + magicString.length();
+            const int sizeOffset = magicStringOffset
+                    + (cbor ? cborMagicString : jsonMagicString).length();
             const int newlineOffset = data.indexOf('\n', sizeOffset);
             if (newlineOffset == -1)
                 continue;
@@ -6052,9 +6299,70 @@ static QJsonObject getNextSessionPacket(QProcess &session, QByteArray &data)
         msg += data.left(bytesToTake);
         data = data.mid(bytesToTake);
     }
+    if (isCbor)
+        *isCbor = cbor;
+    if (cbor)
+        return QCborValue::fromCbor(msg).toMap().toJsonObject();
     return QJsonDocument::fromJson(QByteArray::fromBase64(msg)).object();
 }
 
+static void sendSessionPacket(QProcess &session, const QJsonObject &message, bool cbor = false)
+{
+    const QByteArray data = cbor ? QCborValue::fromJsonValue(message).toCbor()
+                                 : QJsonDocument(message).toJson().toBase64();
+    session.write(cbor ? "qbscbor:" : "qbsmsg:");
+    session.write(QByteArray::number(data.length()));
+    session.write("\n");
+    session.write(data);
+}
+
+// Skips all messages up to the next one of the given type, passing them to the handler.
+static QJsonObject getSessionReply(QProcess &session, QByteArray &data, const QString &replyType,
+        const std::function<void(const QJsonObject &)> &otherMessageHandler = {},
+        bool *isCbor = nullptr)
+{
+    while (true) {
+        const QJsonObject message = getNextSessionPacket(session, data, isCbor);
+        if (message.isEmpty() || message.value("type").toString() == replyType)
+            return message;
+        if (otherMessageHandler)
+            otherMessageHandler(message);
+    }
+}
+
+static QJsonObject sessionResolveRequest(const QString &projectFilePath, const QString &profile,
+                                         const QString &settingsDir)
+{
+    QJsonObject environment;
+    const QProcessEnvironment env = QbsRunParameters::defaultEnvironment();
+    for (const QString &key : env.keys())
+        environment.insert(key, env.value(key));
+    QJsonObject request;
+    request.insert("type", "resolve-project");
+    request.insert("top-level-profile", profile);
+    request.insert("configuration-name", "default");
+    request.insert("project-file-path", projectFilePath);
+    request.insert("build-root", QDir::currentPath());
+    request.insert("settings-directory", settingsDir);
+    request.insert("environment", environment);
+    return request;
+}
+
+static bool startSession(QProcess &session, QByteArray &incomingData,
+                         const QString &qbsExecutableFilePath)
+{
+    session.start(qbsExecutableFilePath, QStringList("session"));
+    if (!session.waitForStarted())
+        return false;
+    return getNextSessionPacket(session, incomingData).value("type").toString() == "hello";
+}
+
+static void quitSession(QProcess &session)
+{
+    sendSessionPacket(session, QJsonObject{qMakePair(QString("type"), QJsonValue("quit"))});
+    session.waitForFinished(3000);
+}
+
 void TestBlackbox::qbsSession()
 {
     QDir::setCurrent(testDataDir + "/qbs-session");
@@ -6683,6 +6991,55 @@ void TestBlackbox::qbsSession()
     }
     QVERIFY(receivedReply);
 
+    // Delta against the data sent above.
+    loadProjectMessage.insert("data-mode", "delta");
+    sendPacket(loadProjectMessage);
+    receivedReply = false;
+    while (!receivedReply) {
+        receivedMessage = getNextSessionPacket(sessionProc, incomingData);
+        if (receivedMessage.value("type") != "project-resolved")
+            continue;
+        receivedReply = true;
+        QVERIFY(receivedMessage.value("error").toObject().isEmpty());
+        QVERIFY2(!receivedMessage.contains("project-data-delta"),
+                 qPrintable(QJsonDocument(receivedMessage).toJson()));
+        QVERIFY(!receivedMessage.contains("project-data"));
+    }
+    QVERIFY(receivedReply);
+
+    // After releasing the project, the delta contains everything.
+    sendPacket(releaseRequest);
+    receivedReply = false;
+    while (!receivedReply) {
+        receivedMessage = getNextSessionPacket(sessionProc, incomingData);
+        QCOMPARE(receivedMessage.value("type").toString(), QString("project-released"));
+        receivedReply = true;
+    }
+    sendPacket(loadProjectMessage);
+    receivedReply = false;
+    while (!receivedReply) {
+        receivedMessage = getNextSessionPacket(sessionProc, incomingData);
+        if (receivedMessage.value("type") != "project-resolved")
+            continue;
+        receivedReply = true;
+        QVERIFY(receivedMessage.value("error").toObject().isEmpty());
+        const QJsonObject delta = receivedMessage.value("project-data-delta").toObject();
+        const QJsonObject project = delta.value("project").toObject();
+        QCOMPARE(project.value("build-graph-file-path").toString(),
+                 QDir::currentPath() + '/' + relativeBuildGraphFilePath("my-config"));
+        const QJsonArray productIds = project.value("products").toArray();
+        QCOMPARE(productIds.size(), 2);
+        QVERIFY(productIds.contains("theLib"));
+        QVERIFY(productIds.contains("theApp"));
+        const QJsonArray addedProducts = delta.value("added-products").toArray();
+        QCOMPARE(addedProducts.size(), 2);
+        for (const QJsonValue &p : addedProducts)
+            QVERIFY(productIds.contains(p.toObject().value("full-display-name")));
+        QVERIFY(!delta.contains("changed-products"));
+        QVERIFY(!delta.contains("removed-products"));
+    }
+    QVERIFY(receivedReply);
+
     // Send unknown request.
     const QJsonObject unknownRequest({qMakePair(QString("type"), QJsonValue("blubb"))});
     sendPacket(unknownRequest);
@@ -6694,12 +7051,332 @@ void TestBlackbox::qbsSession()
     }
     QVERIFY(receivedReply);
 
+    // The reply to a CBOR-encoded request is CBOR-encoded as well.
+    const QByteArray cborData = QCborValue::fromJsonValue(unknownRequest).toCbor();
+    sessionProc.write("qbscbor:");
+    sessionProc.write(QByteArray::number(cborData.length()));
+    sessionProc.write("\n");
+    sessionProc.write(cborData);
+    bool isCbor = false;
+    receivedMessage = getNextSessionPacket(sessionProc, incomingData, &isCbor);
+    QCOMPARE(receivedMessage.value("type").toString(), QString("protocol-error"));
+    QVERIFY(isCbor);
+
     QJsonObject quitRequest;
     quitRequest.insert("type", "quit");
     sendPacket(quitRequest);
     QVERIFY(sessionProc.waitForFinished(3000));
 }
 
+void TestBlackbox::qbsSessionCbor()
+{
+    QDir::setCurrent(testDataDir + "/qbs-session-delta");
+    QProcess session;
+    QByteArray incomingData;
+    QVERIFY(startSession(session, incomingData, qbsExecutableFilePath));
+
+    // Nested containers and non-ASCII strings survive the round trip.
+    QJsonObject resolveRequest = sessionResolveRequest(
+                QDir::currentPath() + "/qbs-session-delta.qbs", profileName(),
+                settings()->baseDirectory());
+    const QJsonObject overriddenValues{qMakePair(QString("products.p2.version"),
+                                                 QJsonValue(QString::fromUtf8("1.0-\xc3\xa4")))};
+    resolveRequest.insert("overridden-properties", overriddenValues);
+    resolveRequest.insert("module-properties", QJsonArray({"qbs.architecture"}));
+    resolveRequest.insert("data-mode", "always");
+    sendSessionPacket(session, resolveRequest, true);
+    bool isCbor = false;
+    QJsonObject reply = getSessionReply(session, incomingData, "project-resolved", {}, &isCbor);
+    QVERIFY(!reply.isEmpty());
+    QVERIFY(isCbor);
+    QVERIFY2(reply.value("error").toObject().isEmpty(), qPrintable(QJsonDocument(reply).toJson()));
+    const QJsonObject projectData = reply.value("project-data").toObject();
+    QCOMPARE(projectData.value("name").toString(), QString("qbs-session-delta"));
+    QCOMPARE(projectData.value("overridden-properties").toObject(), overriddenValues);
+    bool foundProduct = false;
+    for (const QJsonValue &v : projectData.value("products").toArray()) {
+        const QJsonObject product = v.toObject();
+        if (product.value("name").toString() != "p2")
+            continue;
+        foundProduct = true;
+        QCOMPARE(product.value("version").toString(), QString::fromUtf8("1.0-\xc3\xa4"));
+        QCOMPARE(product.value("type").toArray(), QJsonArray({"old"}));
+    }
+    QVERIFY(foundProduct);
+
+    // The reply to a JSON request is JSON again.
+    QJsonObject buildRequest;
+    buildRequest.insert("type", "build-project");
+    sendSessionPacket(session, buildRequest);
+    reply = getSessionReply(session, incomingData, "project-built", {}, &isCbor);
+    QVERIFY(!reply.isEmpty());
+    QVERIFY(!isCbor);
+    QVERIFY(reply.value("error").toObject().isEmpty());
+
+    sendSessionPacket(session, buildRequest, true);
+    reply = getSessionReply(session, incomingData, "project-built", {}, &isCbor);
+    QVERIFY(!reply.isEmpty());
+    QVERIFY(isCbor);
+    QVERIFY(reply.value("error").toObject().isEmpty());
+
+    quitSession(session);
+}
+
+void TestBlackbox::qbsSessionDelta()
+{
+    QDir::setCurrent(testDataDir + "/qbs-session-delta");
+    QProcess session;
+    QByteArray incomingData;
+    QVERIFY(startSession(session, incomingData, qbsExecutableFilePath));
+    QJsonObject resolveRequest = sessionResolveRequest(
+                QDir::currentPath() + "/qbs-session-delta.qbs", profileName(),
+                settings()->baseDirectory());
+    resolveRequest.insert("data-mode", "delta");
+    const auto resolve = [&] {
+        sendSessionPacket(session, resolveRequest);
+        const QJsonObject reply = getSessionReply(session, incomingData, "project-resolved");
+        const QJsonObject error = reply.value("error").toObject();
+        if (!error.isEmpty())
+            qDebug() << error;
+        return reply;
+    };
+    const auto ids = [](const QJsonValue &list, const QString &idKey) {
+        QStringList result;
+        for (const QJsonValue &v : list.toArray())
+            result << (v.isString() ? v.toString() : v.toObject().value(idKey).toString());
+        return result;
+    };
+
+    // Initially, everything is new. The products are sorted by name.
+    QJsonObject reply = resolve();
+    QVERIFY(!reply.isEmpty());
+    QJsonObject delta = reply.value("project-data-delta").toObject();
+    QVERIFY(delta.contains("project"));
+    QCOMPARE(ids(delta.value("added-products"), "full-display-name"),
+             QStringList({"p1", "p2", "p3", "p4", "p5", "p6"}));
+
+    // A changed product property and added and removed groups.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("qbs-session-delta.qbs", "type: [\"old\"]", "type: [\"new\"]");
+    REPLACE_IN_FILE("qbs-session-delta.qbs", "// Group { name: \"added\"",
+                    "Group { name: \"added\"");
+    REPLACE_IN_FILE("qbs-session-delta.qbs", "Group { name: \"removed\"",
+                    "// Group { name: \"removed\"");
+    reply = resolve();
+    QVERIFY(!reply.isEmpty());
+    delta = reply.value("project-data-delta").toObject();
+    QVERIFY2(!delta.contains("project"), qPrintable(QJsonDocument(delta).toJson()));
+    QVERIFY(!delta.contains("added-products"));
+    QVERIFY(!delta.contains("removed-products"));
+    const QJsonArray changedProducts = delta.value("changed-products").toArray();
+    QCOMPARE(ids(changedProducts, "full-display-name"), QStringList({"p2", "p3", "p4"}));
+    const QJsonObject p2 = changedProducts.at(0).toObject();
+    QCOMPARE(p2.value("type").toArray(), QJsonArray({"new"}));
+    QVERIFY(!p2.contains("added-groups"));
+    const QJsonObject p3 = changedProducts.at(1).toObject();
+    QCOMPARE(ids(p3.value("added-groups"), "name"), QStringList("added"));
+    QVERIFY(!p3.contains("changed-groups"));
+    QVERIFY(!p3.contains("removed-groups"));
+    QVERIFY(!p3.contains("type"));
+    const QJsonObject p4 = changedProducts.at(2).toObject();
+    QCOMPARE(ids(p4.value("removed-groups"), "name"), QStringList("removed"));
+    QVERIFY(!p4.contains("added-groups"));
+
+    // Nothing has changed.
+    reply = resolve();
+    QVERIFY(!reply.isEmpty());
+    QVERIFY(!reply.contains("project-data-delta"));
+
+    // Removed products are sorted as well.
+    WAIT_FOR_NEW_TIMESTAMP();
+    REPLACE_IN_FILE("qbs-session-delta.qbs", "Product { name: \"p6\" }", "");
+    REPLACE_IN_FILE("qbs-session-delta.qbs", "Product { name: \"p1\" }", "");
+    reply = resolve();
+    QVERIFY(!reply.isEmpty());
+    delta = reply.value("project-data-delta").toObject();
+    QVERIFY(delta.contains("project"));
+    QCOMPARE(ids(delta.value("removed-products"), "full-display-name"),
+             QStringList({"p1", "p6"}));
+
+    // Project data that is sent in full without the top-level data serves as the base
+    // for the next delta, which must not report the top-level data as changed.
+    resolveRequest.insert("data-mode", "only-if-changed");
+    reply = resolve();
+    QVERIFY(!reply.isEmpty());
+    QJsonObject addFilesRequest;
+    addFilesRequest.insert("type", "add-files");
+    addFilesRequest.insert("product", "p5");
+    addFilesRequest.insert("group", "g");
+    addFilesRequest.insert("files", QJsonArray({QDir::currentPath() + "/f3.txt"}));
+    sendSessionPacket(session, addFilesRequest);
+    reply = getSessionReply(session, incomingData, "files-added");
+    const QJsonObject error = reply.value("error").toObject();
+    if (!error.isEmpty()) {
+        for (const auto item: error[QStringLiteral("items")].toArray()) {
+            const auto description = QStringLiteral("Project file updates are not enabled");
+            if (item.toObject()[QStringLiteral("description")].toString().contains(description))
+                QSKIP("File updates are disabled");
+        }
+        qDebug() << error;
+    }
+    QVERIFY(error.isEmpty());
+    QVERIFY(reply.contains("project-data"));
+    resolveRequest.insert("data-mode", "delta");
+    reply = resolve();
+    QVERIFY(!reply.isEmpty());
+    delta = reply.value("project-data-delta").toObject();
+    QVERIFY2(!delta.contains("project"), qPrintable(QJsonDocument(delta).toJson()));
+
+    quitSession(session);
+}
+
+void TestBlackbox::qbsSessionSourceFileWatcher()
+{
+    QDir::setCurrent(testDataDir + "/qbs-session-source-file-watcher");
+    QProcess session;
+    QByteArray incomingData;
+    QJsonObject resolveRequest = sessionResolveRequest(
+                QDir::currentPath() + "/qbs-session-source-file-watcher.qbs", profileName(),
+                settings()->baseDirectory());
+    resolveRequest.insert("watch-source-files", true);
+    const auto resolve = [&] {
+        sendSessionPacket(session, resolveRequest);
+        const QJsonObject reply = getSessionReply(session, incomingData, "project-resolved");
+        return !reply.isEmpty() && reply.value("error").toObject().isEmpty();
+    };
+    const auto build = [&] {
+        QJsonObject buildRequest;
+        buildRequest.insert("type", "build-project");
+        sendSessionPacket(session, buildRequest);
+        QStringList createdFiles;
+        const QJsonObject reply = getSessionReply(session, incomingData, "project-built",
+                [&createdFiles](const QJsonObject &message) {
+            if (message.value("type").toString() == "command-description")
+                createdFiles << message.value("message").toString().remove("creating ");
+        });
+        if (reply.isEmpty())
+            return QStringList("no reply");
+        if (!reply.value("error").toObject().isEmpty())
+            return QStringList(QString::fromUtf8(QJsonDocument(reply).toJson()));
+        createdFiles.sort();
+        return createdFiles;
+    };
+    const auto appendToFile = [](const QString &fileName) {
+        QFile file(fileName);
+        return file.open(QIODevice::WriteOnly | QIODevice::Append) && file.write("x\n") == 2;
+    };
+    // Gives the session a chance to see the change before the next request comes in.
+    const auto waitForWatcher = [] { QTest::qWait(1000); };
+
+    // The first build checks all files. After that, only what the watcher reported is rebuilt.
+    QVERIFY(startSession(session, incomingData, qbsExecutableFilePath));
+    QVERIFY(resolve());
+    QCOMPARE(build(), QStringList({"a.txt.out", "b.txt.out", "c.txt.out"}));
+    QCOMPARE(build(), QStringList());
+    WAIT_FOR_NEW_TIMESTAMP();
+    QVERIFY(appendToFile("a.txt"));
+    waitForWatcher();
+    QCOMPARE(build(), QStringList("a.txt.out"));
+    QCOMPARE(build(), QStringList());
+    quitSession(session);
+
+    // A change made while no session was watching is found by the first build of the next one.
+    WAIT_FOR_NEW_TIMESTAMP();
+    QVERIFY(appendToFile("b.txt"));
+    QVERIFY(startSession(session, incomingData, qbsExecutableFilePath));
+    QVERIFY(resolve());
+    QCOMPARE(build(), QStringList("b.txt.out"));
+    QCOMPARE(build(), QStringList());
+    quitSession(session);
+
+    // A file that cannot be watched makes the change list incomplete, so all timestamps
+    // get checked on every build.
+    const QFile::Permissions permissions = QFile::permissions("c.txt");
+    QVERIFY(QFile::setPermissions("c.txt", QFile::WriteOwner));
+    const auto restorePermissions = qScopeGuard([permissions] {
+        QFile::setPermissions("c.txt", permissions);
+    });
+    if (QFile("c.txt").open(QIODevice::ReadOnly))
+        QSKIP("File permissions are not enforced for this user");
+    QVERIFY(startSession(session, incomingData, qbsExecutableFilePath));
+    QVERIFY(resolve());
+    QVERIFY(!build().contains("a.txt.out")); // c.txt.out is rebuilt due to the status change.
+    WAIT_FOR_NEW_TIMESTAMP();
+    QVERIFY(appendToFile("c.txt"));
+    waitForWatcher();
+    QCOMPARE(build(), QStringList("c.txt.out"));
+    QCOMPARE(build(), QStringList());
+    quitSession(session);
+}
+
+void TestBlackbox::streamedProcessOutput()
+{
+    QDir::setCurrent(testDataDir + "/streamed-process-output");
+    const QByteArray longLine(200000, 'x');
+
+    // Without streaming, the output is collected, even though it exceeds the amount of data
+    // that is kept in memory.
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("this is output line number 0\n"), m_qbsStdout.left(1000));
+    QVERIFY2(m_qbsStdout.contains("this is output line number 149999\n"),
+             m_qbsStdout.right(1000));
+    QVERIFY(m_qbsStdout.contains(longLine + '\n'));
+    QVERIFY(m_qbsStdout.contains("last line"));
+
+    // With streaming, the output arrives while the process is running, and overly long
+    // lines are split into pieces.
+    rmDirR(relativeBuildDir());
+    QProcess session;
+    QByteArray incomingData;
+    QVERIFY(startSession(session, incomingData, qbsExecutableFilePath));
+    sendSessionPacket(session, sessionResolveRequest(
+                          QDir::currentPath() + "/streamed-process-output.qbs", profileName(),
+                          settings()->baseDirectory()));
+    QJsonObject reply = getSessionReply(session, incomingData, "project-resolved");
+    QVERIFY(!reply.isEmpty());
+    QVERIFY2(reply.value("error").toObject().isEmpty(), qPrintable(QJsonDocument(reply).toJson()));
+
+    QJsonObject buildRequest;
+    buildRequest.insert("type", "build-project");
+    buildRequest.insert("stream-process-output", true);
+    sendSessionPacket(session, buildRequest);
+    int outputMessages = 0;
+    int regularLines = 0;
+    int longLineLength = 0;
+    int maxPieceLength = 0;
+    bool receivedLastLine = false;
+    const auto countLines = [&](const QJsonObject &message) {
+        const QJsonArray lines = message.value("stdout").toArray();
+        for (const QJsonValue &v : lines) {
+            const QString line = v.toString();
+            if (line.startsWith("this is output line number ")) {
+                ++regularLines;
+            } else if (line.startsWith('x')) {
+                longLineLength += line.length();
+                maxPieceLength = std::max(maxPieceLength, int(line.length()));
+            } else if (line == "last line") {
+                receivedLastLine = true;
+            }
+        }
+    };
+    reply = getSessionReply(session, incomingData, "project-built",
+                            [&](const QJsonObject &message) {
+        const QString type = message.value("type").toString();
+        if (type == "process-output")
+            ++outputMessages;
+        if (type == "process-output" || type == "process-result")
+            countLines(message);
+    });
+    QVERIFY(!reply.isEmpty());
+    QVERIFY2(reply.value("error").toObject().isEmpty(), qPrintable(QJsonDocument(reply).toJson()));
+    QVERIFY2(outputMessages > 1, qPrintable(QString::number(outputMessages)));
+    QCOMPARE(regularLines, 150000);
+    QCOMPARE(longLineLength, longLine.size());
+    QVERIFY2(maxPieceLength <= 64 * 1024, qPrintable(QString::number(maxPieceLength)));
+    QVERIFY(receivedLastLine);
+    quitSession(session);
+}
+
 void TestBlackbox::radAfterIncompleteBuild_data()
 {
     QTest::addColumn<QString>("projectFileName");
@@ -7715,6 +8392,66 @@ void TestBlackbox::maximumCxxLanguageVersion()
              m_qbsStdout.constData());
 }
 
+static int maxConcurrentJobs(const QString &logFilePath)
+{
+    QFile logFile(logFilePath);
+    if (!logFile.open(QIODevice::ReadOnly))
+        return -1;
+    int running = 0;
+    int maxRunning = 0;
+    for (const QByteArray &line : logFile.readAll().split('\n')) {
+        if (line == "start")
+            maxRunning = std::max(maxRunning, ++running);
+        else if (line == "end")
+            --running;
+    }
+    return maxRunning;
+}
+
+void TestBlackbox::memoryBudget()
+{
+    QDir::setCurrent(testDataDir + "/memory-budget");
+    QCOMPARE(runQbs({"resolve"}), 0);
+    if (m_qbsStdout.contains("targetPlatform differs from hostPlatform"))
+        QSKIP("Cannot run binaries in cross-compiled build");
+    const QString logFilePath = relativeProductBuildDir("runner") + "/jobs.log";
+    const QStringList jobFiles{"job1.txt", "job2.txt", "job3.txt", "job4.txt"};
+
+    // The first build records how much memory the jobs need. Nothing is restricted yet.
+    QCOMPARE(runQbs(QbsRunParameters(QStringList{"-j", "4", "--memory-budget", "100"})), 0);
+    QCOMPARE(m_qbsStdout.count("running job"), 4);
+    QVERIFY2(maxConcurrentJobs(logFilePath) > 1, qPrintable(QString::number(
+                                                                maxConcurrentJobs(logFilePath))));
+
+    // Two of the jobs do not fit into the budget together, so they run one after the other.
+    // Each one gets started as soon as the previous one has finished.
+    QVERIFY(QFile::remove(logFilePath));
+    WAIT_FOR_NEW_TIMESTAMP();
+    for (const QString &jobFile : jobFiles)
+        touch(jobFile);
+    QCOMPARE(runQbs(QbsRunParameters(QStringList{"-j", "4", "--memory-budget", "100"})), 0);
+    QCOMPARE(m_qbsStdout.count("running job"), 4);
+    QCOMPARE(maxConcurrentJobs(logFilePath), 1);
+
+    // A job that exceeds the budget on its own still runs if nothing else does.
+    QVERIFY(QFile::remove(logFilePath));
+    WAIT_FOR_NEW_TIMESTAMP();
+    for (const QString &jobFile : jobFiles)
+        touch(jobFile);
+    QCOMPARE(runQbs(QbsRunParameters(QStringList{"-j", "4", "--memory-budget", "10"})), 0);
+    QCOMPARE(m_qbsStdout.count("running job"), 4);
+    QCOMPARE(maxConcurrentJobs(logFilePath), 1);
+
+    // Without a budget, the jobs run in parallel again.
+    QVERIFY(QFile::remove(logFilePath));
+    WAIT_FOR_NEW_TIMESTAMP();
+    for (const QString &jobFile : jobFiles)
+        touch(jobFile);
+    QCOMPARE(runQbs(QbsRunParameters(QStringList{"-j", "4"})), 0);
+    QCOMPARE(m_qbsStdout.count("running job"), 4);
+    QVERIFY(maxConcurrentJobs(logFilePath) > 1);
+}
+
 void TestBlackbox::moduleProviders()
 {
     QDir::setCurrent(testDataDir + "/module-providers");
@@ -7936,7 +8673,8 @@ void TestBlackbox::missingBuildGraph()
     QVERIFY(tmpDir.isValid());
     QDir::setCurrent(tmpDir.path());
     QFETCH(QString, configName);
-    const QStringList commands({"clean", "dump-nodes-tree", "status", "update-timestamps"});
+    const QStringList commands({"clean", "dump-nodes-tree", "resource-usage", "status",
+                                 "update-timestamps"});
     const QString actualConfigName = configName.isEmpty() ? QString("default") : configName;
     QbsRunParameters params;
     params.expectFailure = true;
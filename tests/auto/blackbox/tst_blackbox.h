@@ -61,6 +61,7 @@ private slots:
     void buildDataOfDisabledProduct();
     void buildDirectories();
     void buildEnvChange();
+    void buildGraphQuery();
     void buildGraphVersions();
     void buildVariantDefaults_data();
     void buildVariantDefaults();
@@ -82,6 +83,7 @@ private slots:
     void combinedSources();
     void commandFile();
     void compilerDefinesByLanguage();
+    void compressedBuildGraph();
     void concurrentExecutor();
     void conditionalExport();
     void conditionalFileTagger();
@@ -155,6 +157,7 @@ private slots:
     void installedTransformerOutput();
     void installLocations_data();
     void installLocations();
+    void installManifest();
     void installPackage();
     void installRootFromProjectFile();
     void installTree();
@@ -172,6 +175,7 @@ private slots:
     void jsExtensionsTemporaryDir();
     void jsExtensionsTextFile();
     void jsExtensionsBinaryFile();
+    void jsExtensionsUtilitiesFileHash();
     void lastModuleCandidateBroken();
     void ld();
     void linkerMode();
@@ -192,6 +196,7 @@ private slots:
     void makefileGenerator();
     void maximumCLanguageVersion();
     void maximumCxxLanguageVersion();
+    void memoryBudget();
     void moduleProviders();
     void fallbackModuleProvider_data();
     void fallbackModuleProvider();
@@ -259,12 +264,16 @@ private slots:
     void qbsConfigAddProfile();
     void qbsConfigAddProfile_data();
     void qbsSession();
+    void qbsSessionCbor();
+    void qbsSessionDelta();
+    void qbsSessionSourceFileWatcher();
     void qbsVersion();
     void qtBug51237();
     void radAfterIncompleteBuild();
     void radAfterIncompleteBuild_data();
     void recursiveRenaming();
     void recursiveWildcards();
+    void recursiveWildcardsNewSubdirMatch();
     void referenceErrorInExport();
     void removeDuplicateLibraries_data();
     void removeDuplicateLibraries();
@@ -273,6 +282,7 @@ private slots:
     void require();
     void requireDeprecated();
     void rescueTransformerData();
+    void resourceUsage();
     void responseFiles();
     void retaggedOutputArtifact();
     void ruleConditions();
@@ -301,6 +311,7 @@ private slots:
     void sevenZip();
     void sourceArtifactInInputsFromDependencies();
     void staticLibWithoutSources();
+    void streamedProcessOutput();
     void suspiciousCalls();
     void suspiciousCalls_data();
     void systemIncludePaths();
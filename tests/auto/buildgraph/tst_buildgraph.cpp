@@ -45,12 +45,18 @@
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/projectbuilddata.h>
 #include <language/language.h>
+#include <language/propertymapinternal.h>
 #include <logging/logger.h>
 #include <tools/error.h>
+#include <tools/persistence.h>
+
+#include <QtCore/qtemporarydir.h>
 
 #include <QtTest/qtest.h>
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace qbs;
 using namespace qbs::Internal;
@@ -81,6 +87,16 @@ bool TestBuildGraph::cycleDetected(const ResolvedProductConstPtr &product)
     }
 }
 
+bool TestBuildGraph::cycleDetected(const std::vector<ResolvedProductPtr> &products)
+{
+    try {
+        CycleDetector(Logger(m_logSink)).visitProducts(products);
+        return false;
+    } catch (const ErrorInfo &) {
+        return true;
+    }
+}
+
 ResolvedProductConstPtr TestBuildGraph::productWithDirectCycle()
 {
     const ResolvedProductPtr product = ResolvedProduct::create();
@@ -137,6 +153,37 @@ ResolvedProductConstPtr TestBuildGraph::productWithNoCycle()
     return product;
 }
 
+// Layers of artifacts, where each artifact depends on two artifacts of the next layer.
+ResolvedProductConstPtr TestBuildGraph::productWithLargeGraph()
+{
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->project = project;
+    product->buildData = std::make_unique<ProductBuildData>();
+    const int layerCount = 50;
+    const int layerSize = 400;
+    std::vector<Artifact *> previousLayer;
+    for (int layer = 0; layer < layerCount; ++layer) {
+        std::vector<Artifact *> currentLayer;
+        for (int i = 0; i < layerSize; ++i) {
+            const auto artifact = new Artifact;
+            artifact->product = product;
+            artifact->setFilePath(QStringLiteral("/layer%1/file%2").arg(layer).arg(i));
+            product->buildData->addNode(artifact);
+            if (layer == 0)
+                product->buildData->addRootNode(artifact);
+            currentLayer.push_back(artifact);
+        }
+        if (!previousLayer.empty()) {
+            for (int i = 0; i < layerSize; ++i) {
+                qbs::Internal::connect(previousLayer.at(i), currentLayer.at(i));
+                qbs::Internal::connect(previousLayer.at(i), currentLayer.at((i + 1) % layerSize));
+            }
+        }
+        previousLayer = std::move(currentLayer);
+    }
+    return product;
+}
+
 void TestBuildGraph::testCycle()
 {
     QVERIFY(cycleDetected(productWithDirectCycle()));
@@ -144,6 +191,260 @@ void TestBuildGraph::testCycle()
     QVERIFY(!cycleDetected(productWithNoCycle()));
 }
 
+void TestBuildGraph::testCrossProductCycle()
+{
+    std::vector<ResolvedProductPtr> products;
+    std::vector<Artifact *> artifacts;
+    for (int i = 0; i < 3; ++i) {
+        const ResolvedProductPtr product = ResolvedProduct::create();
+        product->project = project;
+        product->buildData = std::make_unique<ProductBuildData>();
+        const auto artifact = new Artifact;
+        artifact->product = product;
+        product->buildData->addRootNode(artifact);
+        product->buildData->addNode(artifact);
+        products.push_back(product);
+        artifacts.push_back(artifact);
+    }
+
+    // The first two products depend on each other via different artifacts.
+    const auto otherArtifact = new Artifact;
+    otherArtifact->product = products.front();
+    products.front()->buildData->addNode(otherArtifact);
+    qbs::Internal::connect(artifacts.at(0), artifacts.at(1));
+    qbs::Internal::connect(artifacts.at(1), otherArtifact);
+    qbs::Internal::connect(artifacts.at(2), artifacts.at(0));
+    QVERIFY(!cycleDetected(products));
+
+    qbs::Internal::connect(otherArtifact, artifacts.at(0));
+    QVERIFY(cycleDetected(products));
+}
+
+void TestBuildGraph::testSharedVariantMaps()
+{
+    // The module maps of a product and its group share their data, unless the group
+    // sets one of the module's properties. Such a map stays distinct even if it is equal.
+    const QVariantMap cppProperties{{"defines", QStringList{"A", "B"}},
+                                    {"optimization", "fast"}};
+    const QVariantMap qbsProperties{{"architecture", "x86_64"}};
+    const QVariantMap qbsGroupProperties{{"architecture", "x86_64"}};
+    const PropertyMapPtr productMap = PropertyMapInternal::create();
+    productMap->setValue({{"cpp", cppProperties}, {"qbs", qbsProperties},
+                          {"name", "app"}});
+    const PropertyMapPtr groupMap = PropertyMapInternal::create();
+    groupMap->setValue({{"cpp", cppProperties}, {"qbs", qbsGroupProperties},
+                        {"empty", QVariantMap()}});
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("maps.bg"));
+    Logger logger(m_logSink);
+    {
+        PersistentPool pool(logger);
+        pool.setupWriteStream(filePath);
+        productMap->store(pool);
+        groupMap->store(pool);
+        pool.storeSharedVariantMap(QVariantMap());
+        pool.storeSharedVariantMap(cppProperties);
+        pool.finalizeWriteStream();
+    }
+    PersistentPool pool(logger);
+    pool.load(filePath);
+    const PropertyMapPtr loadedProductMap = PropertyMapInternal::create();
+    loadedProductMap->load(pool);
+    const PropertyMapPtr loadedGroupMap = PropertyMapInternal::create();
+    loadedGroupMap->load(pool);
+    const QVariantMap loadedEmptyMap = pool.loadSharedVariantMap();
+    const QVariantMap loadedCppProperties = pool.loadSharedVariantMap();
+
+    QCOMPARE(loadedProductMap->value(), productMap->value());
+    QCOMPARE(loadedGroupMap->value(), groupMap->value());
+    QVERIFY(loadedEmptyMap.isEmpty());
+    QCOMPARE(loadedCppProperties, cppProperties);
+    const QVariant loadedEmptyValue = loadedGroupMap->value().value("empty");
+    QCOMPARE(loadedEmptyValue.userType(), int(QMetaType::QVariantMap));
+    QVERIFY(loadedEmptyValue.toMap().isEmpty());
+
+    const QVariantMap productCpp = loadedProductMap->value().value("cpp").toMap();
+    const QVariantMap groupCpp = loadedGroupMap->value().value("cpp").toMap();
+    QVERIFY(productCpp.isSharedWith(groupCpp));
+    QVERIFY(productCpp.isSharedWith(loadedCppProperties));
+    const QVariantMap productQbs = loadedProductMap->value().value("qbs").toMap();
+    const QVariantMap groupQbs = loadedGroupMap->value().value("qbs").toMap();
+    QCOMPARE(productQbs, groupQbs);
+    QVERIFY(!productQbs.isSharedWith(groupQbs));
+}
+
+void TestBuildGraph::testSharedProductData()
+{
+    // Objects that the resolver shares between products must still be shared after loading.
+    const ResolvedFileContextPtr fileContext = ResolvedFileContext::create();
+    fileContext->setFilePath(QStringLiteral("/modules/m/m.qbs"));
+    const ScriptFunctionPtr buildEnvScript = ScriptFunction::create();
+    buildEnvScript->sourceCode = QStringLiteral("(function() {})");
+    buildEnvScript->fileContext = fileContext;
+    const ScriptFunctionPtr runEnvScript = ScriptFunction::create();
+    runEnvScript->sourceCode = QStringLiteral("(function() { return 1; })");
+    runEnvScript->fileContext = fileContext;
+    const ProbeConstPtr probe = Probe::create(QStringLiteral("probe"), CodeLocation(), true,
+                                              QStringLiteral("found = true;"),
+                                              {{"found", true}}, {{"found", false}}, {});
+
+    const TopLevelProjectPtr storedProject = TopLevelProject::create();
+    storedProject->buildData = std::make_unique<ProjectBuildData>();
+    storedProject->probes.push_back(probe);
+    for (int i = 0; i < 2; ++i) {
+        const ResolvedProductPtr product = ResolvedProduct::create();
+        product->name = QStringLiteral("product%1").arg(i);
+        product->buildData = std::make_unique<ProductBuildData>();
+        const ResolvedModulePtr module = ResolvedModule::create();
+        module->name = QStringLiteral("m");
+        module->setupBuildEnvironmentScript.initialize(buildEnvScript);
+        module->setupRunEnvironmentScript.initialize(runEnvScript);
+        product->modules.push_back(module);
+        product->probes.push_back(probe);
+        storedProject->products.push_back(product);
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("project.bg"));
+    Logger logger(m_logSink);
+    {
+        PersistentPool pool(logger);
+        pool.setupWriteStream(filePath);
+        static_cast<ResolvedProject &>(*storedProject).store(pool);
+        pool.finalizeWriteStream();
+    }
+    PersistentPool pool(logger);
+    pool.load(filePath);
+    const TopLevelProjectPtr loadedProject = TopLevelProject::create();
+    static_cast<ResolvedProject &>(*loadedProject).load(pool);
+
+    QCOMPARE(loadedProject->products.size(), size_t(2));
+    const ResolvedProductPtr &product0 = loadedProject->products.front();
+    const ResolvedProductPtr &product1 = loadedProject->products.back();
+    QCOMPARE(product1->name, QStringLiteral("product1"));
+    QCOMPARE(product0->modules.size(), size_t(1));
+    QCOMPARE(product1->modules.size(), size_t(1));
+    const ResolvedModuleConstPtr &module0 = product0->modules.front();
+    const ResolvedModuleConstPtr &module1 = product1->modules.front();
+    QVERIFY(module0 != module1);
+    QCOMPARE(module0->setupBuildEnvironmentScript.sourceCode(), buildEnvScript->sourceCode);
+    QCOMPARE(module0->setupRunEnvironmentScript.sourceCode(), runEnvScript->sourceCode);
+    QVERIFY(module0->setupBuildEnvironmentScript.sharedData()
+            == module1->setupBuildEnvironmentScript.sharedData());
+    QVERIFY(module0->setupRunEnvironmentScript.sharedData()
+            == module1->setupRunEnvironmentScript.sharedData());
+    QVERIFY(module0->setupBuildEnvironmentScript.sharedData()
+            != module0->setupRunEnvironmentScript.sharedData());
+    const ResolvedFileContextConstPtr &loadedFileContext
+            = module0->setupBuildEnvironmentScript.fileContext();
+    QVERIFY(loadedFileContext);
+    QCOMPARE(loadedFileContext->filePath(), fileContext->filePath());
+    QVERIFY(module0->setupRunEnvironmentScript.fileContext() == loadedFileContext);
+
+    QCOMPARE(loadedProject->probes.size(), size_t(1));
+    const ProbeConstPtr &loadedProbe = loadedProject->probes.front();
+    QCOMPARE(loadedProbe->globalId(), probe->globalId());
+    QCOMPARE(loadedProbe->configureScript(), probe->configureScript());
+    QCOMPARE(loadedProbe->properties(), probe->properties());
+    QCOMPARE(loadedProbe->initialProperties(), probe->initialProperties());
+    QCOMPARE(product0->probes.size(), size_t(1));
+    QVERIFY(product0->probes.front() == loadedProbe);
+    QCOMPARE(product1->probes.size(), size_t(1));
+    QVERIFY(product1->probes.front() == loadedProbe);
+}
+
+void TestBuildGraph::testStringListDeltas()
+{
+    const std::vector<std::pair<QString, QStringList>> lists{
+        {QStringLiteral("cc"), {"-c", "-O2", "a.cpp", "-o", "a.o"}},
+        {QStringLiteral("cc"), {"-c", "-O2", "b.cpp", "-o", "b.o"}},
+        {QStringLiteral("ld"), {"a.o", "b.o", "-o", "app"}},
+        {QStringLiteral("cc"), {"-c", "-O2", "b.cpp", "-o", "b.o"}},
+        {QStringLiteral("cc"), {"-c", "-O2", "-g", "b.cpp", "-o", "b.o"}},
+        {QStringLiteral("cc"), {"-c"}},
+        {QStringLiteral("cc"), {}},
+        {QStringLiteral("ld"), {"a.o", "-o", "app"}},
+        {QStringLiteral("ld"), {"a.o", "a.o", "-o", "app"}},
+    };
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("deltas.bg"));
+    Logger logger(m_logSink);
+    {
+        PersistentPool pool(logger);
+        pool.setupWriteStream(filePath);
+        for (const auto &list : lists)
+            pool.storeStringListDelta(list.first, list.second);
+        pool.finalizeWriteStream();
+    }
+    PersistentPool pool(logger);
+    pool.load(filePath);
+    for (const auto &list : lists)
+        QCOMPARE(pool.loadStringListDelta(list.first), list.second);
+}
+
+void TestBuildGraph::traversalBenchmark()
+{
+    const ResolvedProductConstPtr product = productWithLargeGraph();
+    QBENCHMARK {
+        QVERIFY(!cycleDetected(product));
+    }
+}
+
+void TestBuildGraph::connectBenchmark_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::newRow("one by one") << false;
+    QTest::newRow("batched") << true;
+}
+
+// One artifact with many parents and one artifact with many children, as for a widely
+// included generated header or a rule node with many inputs.
+void TestBuildGraph::connectBenchmark()
+{
+    QFETCH(bool, batched);
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->project = project;
+    product->buildData = std::make_unique<ProductBuildData>();
+    const int nodeCount = 10000;
+    QBENCHMARK {
+        auto hub = std::make_unique<Artifact>();
+        hub->product = product;
+        hub->setFilePath(QStringLiteral("/hub"));
+        std::vector<std::unique_ptr<Artifact>> artifacts;
+        std::vector<BuildGraphNode *> nodes;
+        for (int i = 0; i < nodeCount; ++i) {
+            auto artifact = std::make_unique<Artifact>();
+            artifact->product = product;
+            artifact->setFilePath(QStringLiteral("/file%1").arg(i));
+            nodes.push_back(artifact.get());
+            artifacts.push_back(std::move(artifact));
+        }
+        auto leaf = std::make_unique<Artifact>();
+        leaf->product = product;
+        leaf->setFilePath(QStringLiteral("/leaf"));
+        if (batched) {
+            qbs::Internal::connect(hub.get(), nodes);
+            qbs::Internal::connect(nodes, leaf.get());
+        } else {
+            for (BuildGraphNode * const node : nodes) {
+                qbs::Internal::connect(hub.get(), node);
+                qbs::Internal::connect(node, leaf.get());
+            }
+        }
+        QCOMPARE(hub->children.size(), size_t(nodeCount));
+        QCOMPARE(leaf->parents.size(), size_t(nodeCount));
+
+        // Destroy the nodes with many edges first, so the other nodes do not have to remove
+        // themselves from large sets one by one.
+        hub.reset();
+        leaf.reset();
+    }
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
@@ -46,6 +46,8 @@
 #include <QtCore/qlist.h>
 #include <QtCore/qobject.h>
 
+#include <vector>
+
 class TestBuildGraph : public QObject
 {
     Q_OBJECT
@@ -56,12 +58,21 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void testCycle();
+    void testCrossProductCycle();
+    void testSharedVariantMaps();
+    void testSharedProductData();
+    void testStringListDeltas();
+    void traversalBenchmark();
+    void connectBenchmark_data();
+    void connectBenchmark();
 
 private:
     qbs::Internal::ResolvedProductConstPtr productWithDirectCycle();
     qbs::Internal::ResolvedProductConstPtr productWithLessDirectCycle();
     qbs::Internal::ResolvedProductConstPtr productWithNoCycle();
+    qbs::Internal::ResolvedProductConstPtr productWithLargeGraph();
     bool cycleDetected(const qbs::Internal::ResolvedProductConstPtr &product);
+    bool cycleDetected(const std::vector<qbs::Internal::ResolvedProductPtr> &products);
 
     qbs::ILogSink * const m_logSink;
 };
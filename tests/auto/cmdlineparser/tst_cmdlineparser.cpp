@@ -169,6 +169,20 @@ private slots:
 
         QVERIFY(parser.parseCommandLine(QStringList{"run", "--setup-run-env-config", "x,y,z"}));
         QCOMPARE(parser.runEnvConfig(), QStringList({"x", "y", "z"}));
+
+        QVERIFY(parser.parseCommandLine(QStringList("resource-usage")));
+        QCOMPARE(parser.command(), ResourceUsageCommandType);
+        QCOMPARE(parser.topCount(), 10);
+        QVERIFY(parser.parseCommandLine(QStringList{"resource-usage", "--top", "3"}));
+        QCOMPARE(parser.topCount(), 3);
+
+        QVERIFY(parser.parseCommandLine(QStringList{"query", "property-users", "cpp.defines"}));
+        QCOMPARE(parser.command(), QueryCommandType);
+        QCOMPARE(parser.queryName(), QString("property-users"));
+        QCOMPARE(parser.queryArguments(), QStringList("cpp.defines"));
+        QVERIFY(parser.parseCommandLine(QStringList{"query", "dependency-path", "a.o", "a.cpp"}));
+        QCOMPARE(parser.queryArguments(), QStringList({QDir::current().absoluteFilePath("a.o"),
+                                                       QDir::current().absoluteFilePath("a.cpp")}));
     }
 
     void testInvalidCommandLine()
@@ -197,6 +211,10 @@ private slots:
         QTest::newRow("Property assignment for clean") << (QStringList("clean") << "profile:x");
         QTest::newRow("Property assignment for dump-nodes-tree")
                 << (QStringList("dump-nodes-tree") << "profile:x");
+        QTest::newRow("Property assignment for resource-usage")
+                << (QStringList("resource-usage") << "profile:x");
+        QTest::newRow("Invalid top count") << (QStringList("resource-usage") << "--top" << "0");
+        QTest::newRow("Missing query") << QStringList("query");
         QTest::newRow("Property assignment for status") << (QStringList("status") << "profile:x");
         QTest::newRow("Property assignment for update-timestamps")
                 << (QStringList("update-timestamps") << "profile:x");
@@ -51,6 +51,7 @@
 #include <language/itempool.h>
 #include <language/language.h>
 #include <language/propertymapinternal.h>
+#include <language/scriptbackend.h>
 #include <language/scriptengine.h>
 #include <language/value.h>
 #include <parser/qmljslexer_p.h>
@@ -68,6 +69,7 @@
 #include <QtCore/qprocess.h>
 
 #include <algorithm>
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
@@ -2904,6 +2906,47 @@ void TestLanguage::requiredAndNonRequiredDependencies_data()
                                                       << false;
 }
 
+void TestLanguage::scriptBackend()
+{
+    class AnswerClass : public ScriptClass
+    {
+    public:
+        bool hasProperty(const ScriptValue &, const QString &name) override
+        {
+            return name == "answer";
+        }
+        ScriptValue property(const ScriptValue &, const QString &) override { return answer; }
+
+        ScriptValue answer;
+    };
+
+    const std::unique_ptr<ScriptBackend> backend
+            = ScriptBackend::create(m_logger, EvalContext::PropertyEvaluation);
+    const auto evaluate = [&backend](const QString &sourceCode) {
+        return backend->evaluate(backend->compile(sourceCode, CodeLocation())).toVariant();
+    };
+    QCOMPARE(evaluate("1 + 2").toInt(), 3);
+
+    ScriptValue scope = backend->newObject();
+    scope.setProperty("x", backend->toScriptValue(5));
+    backend->pushScope(scope);
+    QCOMPARE(evaluate("x * 2").toInt(), 10);
+    backend->popScope();
+
+    AnswerClass answerClass;
+    answerClass.answer = backend->toScriptValue(42);
+    ScriptValue globalObject = backend->globalObject();
+    globalObject.setProperty("o", backend->newObject(&answerClass));
+    QCOMPARE(evaluate("o.answer").toInt(), 42);
+    QVERIFY(evaluate("o.question === undefined").toBool());
+    QCOMPARE(evaluate("[1, 2].concat(o.answer).length").toInt(), 3);
+
+    QVERIFY(!backend->hasUncaughtException());
+    evaluate("throw 'oops'");
+    QVERIFY(backend->hasUncaughtException());
+    QCOMPARE(backend->uncaughtException().toString(), QString("oops"));
+}
+
 void TestLanguage::suppressedAndNonSuppressedErrors()
 {
     try {
@@ -3006,6 +3049,8 @@ void TestLanguage::fileTags_data()
     QTest::newRow("override_file_tag_via_group") << size_t(2) << (QStringList() << "c++");
     QTest::newRow("add_file_tag_via_group") << size_t(2) << (QStringList() << "cpp" << "zzz");
     QTest::newRow("prioritized_filetagger") << size_t(1) << (QStringList() << "cpp1" << "cpp2");
+    QTest::newRow("filetagger_pattern_kinds") << size_t(1)
+            << (QStringList() << "literal" << "suffix" << "wildcard");
     QTest::newRow("cleanup") << size_t(0) << QStringList();
 }
 
@@ -169,6 +169,7 @@ private slots:
     void relaxedErrorMode_data();
     void requiredAndNonRequiredDependencies();
     void requiredAndNonRequiredDependencies_data();
+    void scriptBackend();
     void suppressedAndNonSuppressedErrors();
     void throwingProbe();
     void throwingProbe_data();
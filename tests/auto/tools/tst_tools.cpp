@@ -47,7 +47,9 @@
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/filesaver.h>
+#include <tools/filesystemcache.h>
 #include <tools/hostosinfo.h>
+#include <tools/processoutputbuffer.h>
 #include <tools/processutils.h>
 #include <tools/profile.h>
 #include <tools/set.h>
@@ -65,6 +67,10 @@
 
 #include <QtTest/qtest.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace qbs;
 using namespace qbs::Internal;
 
@@ -240,6 +246,10 @@ void TestTools::testFileInfo()
         QCOMPARE(FileInfo::resolvePath("C:/share", "D:/"), QString("D:/"));
         QCOMPARE(FileInfo::resolvePath("C:/share", "D:"), QString()); // should soft-assert
     }
+    QCOMPARE(FileInfo::joinPaths({"/abc/", "/def", "ghi"}), QString("/abc/def/ghi"));
+    QCOMPARE(FileInfo::joinPaths({"", "abc", ""}), QString("abc"));
+    QCOMPARE(FileInfo::joinPaths({"abc//", ""}), QString("abc/"));
+    QCOMPARE(FileInfo::joinPaths({}), QString());
     QCOMPARE(FileInfo("/does/not/exist").lastModified(), FileTime());
 }
 
@@ -259,6 +269,87 @@ void TestTools::fileCaseCheck()
         QVERIFY(!FileInfo::isFileCaseCorrect(upperFilePath));
 }
 
+void TestTools::fileSystemCache()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filePath = tempDir.path() + "/file.txt";
+    const QDir::Filters filters = QDir::Files;
+    FileSystemCache &cache = FileSystemCache::instance();
+
+    // Without a scope, nothing is cached.
+    QVERIFY(!cache.exists(filePath));
+    QFile file(filePath);
+    QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+    file.close();
+    QVERIFY(cache.exists(filePath));
+    QCOMPARE(cache.directoryEntries(tempDir.path(), filters), QStringList("file.txt"));
+
+    {
+        const FileSystemCache::Scope scope;
+        QVERIFY(cache.exists(filePath));
+        QCOMPARE(cache.directoryEntries(tempDir.path(), filters), QStringList("file.txt"));
+        QVERIFY(file.remove());
+        QVERIFY(cache.exists(filePath));
+        QCOMPARE(cache.directoryEntries(tempDir.path(), filters), QStringList("file.txt"));
+        {
+            // Nested scopes share the cache.
+            const FileSystemCache::Scope nestedScope;
+            QVERIFY(cache.exists(filePath));
+        }
+        QVERIFY(cache.exists(filePath));
+        cache.invalidate(filePath);
+        QVERIFY(!cache.exists(filePath));
+        QCOMPARE(cache.directoryEntries(tempDir.path(), filters), QStringList());
+        QVERIFY2(file.open(QIODevice::WriteOnly), qPrintable(file.errorString()));
+        file.close();
+        QVERIFY(!cache.exists(filePath));
+    }
+
+    // The cache is cleared when the last scope ends.
+    QVERIFY(cache.exists(filePath));
+    QCOMPARE(cache.directoryEntries(tempDir.path(), filters), QStringList("file.txt"));
+
+    // A scope does not affect other threads.
+    {
+        const FileSystemCache::Scope scope;
+        QVERIFY(cache.exists(filePath));
+        QVERIFY(file.remove());
+        bool existsInOtherThread = true;
+        std::thread([&] {
+            existsInOtherThread = FileSystemCache::instance().exists(filePath);
+        }).join();
+        QVERIFY(!existsInOtherThread);
+        QVERIFY(cache.exists(filePath));
+
+        // Different spellings of a path refer to the same entry.
+        cache.invalidate(tempDir.path() + "/subdir/../file.txt");
+        QVERIFY(!cache.exists(filePath));
+    }
+
+    // Invalidating a directory invalidates everything below it, as well as the listing
+    // of its parent directory.
+    const QString dirPath = tempDir.path() + "/dir";
+    const QString nestedFilePath = dirPath + "/nested/file.txt";
+    const QDir::Filters dirFilters = QDir::Dirs | QDir::NoDotAndDotDot;
+    QVERIFY(QDir().mkpath(dirPath + "/nested"));
+    QFile nestedFile(nestedFilePath);
+    QVERIFY2(nestedFile.open(QIODevice::WriteOnly), qPrintable(nestedFile.errorString()));
+    nestedFile.close();
+    {
+        const FileSystemCache::Scope scope;
+        QVERIFY(cache.exists(nestedFilePath));
+        QCOMPARE(cache.directoryEntries(dirPath + "/nested", filters), QStringList("file.txt"));
+        QCOMPARE(cache.directoryEntries(tempDir.path(), dirFilters), QStringList("dir"));
+        QVERIFY(QDir(dirPath).removeRecursively());
+        QVERIFY(cache.exists(nestedFilePath));
+        cache.invalidate(dirPath);
+        QVERIFY(!cache.exists(nestedFilePath));
+        QCOMPARE(cache.directoryEntries(dirPath + "/nested", filters), QStringList());
+        QCOMPARE(cache.directoryEntries(tempDir.path(), dirFilters), QStringList());
+    }
+}
+
 void TestTools::testProfiles()
 {
     TemporaryProfile tpp("parent", m_settings);
@@ -435,6 +526,40 @@ void TestTools::testProcessNameByPid()
     QCOMPARE(qAppName(), processNameByPid(QCoreApplication::applicationPid()));
 }
 
+void TestTools::testProcessOutputBuffer()
+{
+    ProcessOutputBuffer buffer(10);
+    QVERIFY(buffer.isEmpty());
+    buffer.append("12345");
+    QVERIFY(!buffer.isSpilled());
+    buffer.append("67890");
+    QVERIFY(!buffer.isSpilled());
+    buffer.append("abc");
+    QVERIFY(buffer.isSpilled());
+    buffer.append("def");
+    QCOMPARE(buffer.size(), qint64(16));
+    QCOMPARE(buffer.readAll(), QByteArray("1234567890abcdef"));
+    QByteArrayList chunks;
+    QVERIFY(buffer.readChunks([&chunks](const QByteArray &chunk) { chunks << chunk; }, 4));
+    QCOMPARE(chunks, QByteArrayList({"1234", "5678", "90ab", "cdef"}));
+
+    const QString filePath = testDataDir + QLatin1String("/processoutput.txt");
+    QVERIFY(buffer.saveToFile(filePath));
+    QFile f(filePath);
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    QCOMPARE(f.readAll(), QByteArray("1234567890abcdef"));
+    f.close();
+
+    buffer.clear();
+    QVERIFY(buffer.isEmpty());
+    QVERIFY(!buffer.isSpilled());
+    QCOMPARE(buffer.readAll(), QByteArray());
+    buffer.append("xyz");
+    QVERIFY(buffer.saveToFile(filePath));
+    QVERIFY(f.open(QIODevice::ReadOnly));
+    QCOMPARE(f.readAll(), QByteArray("xyz"));
+}
+
 
 int toNumber(const QString &str)
 {
@@ -1121,6 +1246,48 @@ void TestTools::set_intersects()
     QVERIFY(s1.intersects(s3));
 }
 
+void TestTools::set_bulkOperations()
+{
+    Set<int> s;
+    for (int i = 0; i < 100; i += 2)
+        s << i;
+    const std::vector<int> values{99, 1, 3, 50, 3, 200, 0};
+    s.insert(values.cbegin(), values.cend());
+    QCOMPARE(s.size(), size_t(54));
+    QVERIFY(std::is_sorted(s.cbegin(), s.cend()));
+    QVERIFY(std::adjacent_find(s.cbegin(), s.cend()) == s.cend());
+    QVERIFY(s.contains(1) && s.contains(3) && s.contains(99) && s.contains(200));
+
+    // Large enough for merging.
+    Set<int> odd;
+    for (int i = 1; i < 100; i += 2)
+        odd << i;
+    Set<int> united = s;
+    united.unite(odd);
+    QCOMPARE(united.size(), size_t(101));
+    QVERIFY(std::is_sorted(united.cbegin(), united.cend()));
+    QVERIFY(united.contains(200));
+
+    united.subtract(odd);
+    QCOMPARE(united.size(), size_t(51));
+    QVERIFY(!united.contains(1));
+    QVERIFY(united.contains(0) && united.contains(98) && united.contains(200));
+}
+
+// Mimics many parents getting connected to one child, as happens with widely used headers.
+void TestTools::set_wideFanInBenchmark()
+{
+    const int parentCount = 20000;
+    std::vector<int> parents(parentCount);
+    for (int i = 0; i < parentCount; ++i)
+        parents[i] = (i * 7919) % parentCount;
+    QBENCHMARK {
+        Set<int> set;
+        set.insert(parents.cbegin(), parents.cend());
+        QCOMPARE(set.size(), size_t(parentCount));
+    }
+}
+
 void TestTools::stringutils_join()
 {
     QFETCH(std::vector<std::string>, input);
@@ -63,9 +63,11 @@ private slots:
     void fileSaver();
 
     void fileCaseCheck();
+    void fileSystemCache();
     void testBuildConfigMerging();
     void testFileInfo();
     void testProcessNameByPid();
+    void testProcessOutputBuffer();
     void testProfiles();
     void testSettingsMigration();
     void testSettingsMigration_data();
@@ -90,6 +92,8 @@ private slots:
     void set_makeSureTheComfortFunctionsCompile();
     void set_initializerList();
     void set_intersects();
+    void set_bulkOperations();
+    void set_wideFanInBenchmark();
 
     void stringutils_join();
     void stringutils_join_data();
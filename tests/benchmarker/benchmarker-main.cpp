@@ -115,7 +115,8 @@ int main(int argc, char *argv[])
     }
 
     Benchmarker benchmarker(clParser.activies(), clParser.oldCommit(), clParser.newCommit(),
-                            clParser.testProjectFilePath(), clParser.qbsRepoDirPath());
+                            clParser.testProjectFilePath(), clParser.qbsRepoDirPath(),
+                            clParser.oldBuildProperties(), clParser.newBuildProperties());
     try {
         benchmarker.benchmark();
         printResults(clParser.activies(), benchmarker.results(), clParser.regressionThreshold());
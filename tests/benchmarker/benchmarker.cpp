@@ -40,12 +40,15 @@
 namespace qbsBenchmarker {
 
 Benchmarker::Benchmarker(Activities activities, QString oldCommit, QString newCommit,
-                         QString testProject, QString qbsRepo)
+                         QString testProject, QString qbsRepo, QStringList oldBuildProperties,
+                         QStringList newBuildProperties)
     : m_activities(activities)
     , m_oldCommit(std::move(oldCommit))
     , m_newCommit(std::move(newCommit))
     , m_testProject(std::move(testProject))
     , m_qbsRepo(std::move(qbsRepo))
+    , m_oldBuildProperties(std::move(oldBuildProperties))
+    , m_newBuildProperties(std::move(newBuildProperties))
 {
 }
 
@@ -65,19 +68,23 @@ void Benchmarker::benchmark()
 {
     rememberCurrentRepoState();
     runProcess(QStringList() << "git" << "checkout" << m_oldCommit, m_qbsRepo);
-    const QString oldQbsBuildDir = m_baseOutputDir.path() + "/qbs-build." + m_oldCommit;
+    // The commits can be the same if only the build properties differ, so the
+    // directory names must not be derived from the commits alone.
+    const QString oldQbsBuildDir = m_baseOutputDir.path() + "/qbs-build.old." + m_oldCommit;
     std::cout << "Building from old repo state..." << std::endl;
-    buildQbs(oldQbsBuildDir);
+    buildQbs(oldQbsBuildDir, m_oldBuildProperties);
     runProcess(QStringList() << "git" << "checkout" << m_newCommit, m_qbsRepo);
-    const QString newQbsBuildDir = m_baseOutputDir.path() + "/qbs-build." + m_newCommit;
+    const QString newQbsBuildDir = m_baseOutputDir.path() + "/qbs-build.new." + m_newCommit;
     std::cout << "Building from new repo state..." << std::endl;
-    buildQbs(newQbsBuildDir);
+    buildQbs(newQbsBuildDir, m_newBuildProperties);
     std::cout << "Now running valgrind. This can take a while." << std::endl;
 
     ValgrindRunner oldDataRetriever(m_activities, m_testProject, oldQbsBuildDir,
-                                    m_baseOutputDir.path() + "/benchmark-data." + m_oldCommit);
+                                    m_baseOutputDir.path() + "/benchmark-data.old."
+                                    + m_oldCommit);
     ValgrindRunner newDataRetriever(m_activities, m_testProject, newQbsBuildDir,
-                                    m_baseOutputDir.path() + "/benchmark-data." + m_newCommit);
+                                    m_baseOutputDir.path() + "/benchmark-data.new."
+                                    + m_newCommit);
     QFuture<void> oldFuture = QtConcurrent::run([&oldDataRetriever]{ oldDataRetriever.run(); });
     QFuture<void> newFuture = QtConcurrent::run([&newDataRetriever]{ newDataRetriever.run(); });
     oldFuture.waitForFinished();
@@ -115,7 +122,7 @@ void Benchmarker::rememberCurrentRepoState()
     m_commitToRestore = QString::fromLatin1(commit);
 }
 
-void Benchmarker::buildQbs(const QString &buildDir) const
+void Benchmarker::buildQbs(const QString &buildDir, const QStringList &buildProperties) const
 {
     if (!QDir::root().mkpath(buildDir))
         throw Exception(QStringLiteral("Failed to create directory '%1'.").arg(buildDir));
@@ -124,6 +131,7 @@ void Benchmarker::buildQbs(const QString &buildDir) const
                << "config:benchmarker"
                << "qbs.buildVariant:profiling"
                << "qbs.installPrefix:''"
+               << buildProperties
                << "-f" << m_qbsRepo + "/qbs.qbs", buildDir);
     runProcess(QStringList() << QCoreApplication::applicationDirPath() + "/qbs"
                << "build"
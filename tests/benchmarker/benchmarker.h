@@ -51,7 +51,8 @@ class Benchmarker
 {
 public:
     Benchmarker(Activities activities, QString oldCommit, QString newCommit,
-                QString testProject, QString qbsRepo);
+                QString testProject, QString qbsRepo, QStringList oldBuildProperties,
+                QStringList newBuildProperties);
     ~Benchmarker();
 
     void benchmark();
@@ -62,13 +63,15 @@ public:
 
 private:
     void rememberCurrentRepoState();
-    void buildQbs(const QString &buildDir) const;
+    void buildQbs(const QString &buildDir, const QStringList &buildProperties) const;
 
     const Activities m_activities;
     const QString m_oldCommit;
     const QString m_newCommit;
     const QString m_testProject;
     const QString m_qbsRepo;
+    const QStringList m_oldBuildProperties;
+    const QStringList m_newBuildProperties;
     QString m_commitToRestore;
     QTemporaryDir m_baseOutputDir;
     BenchmarkResults m_results;
@@ -71,6 +71,15 @@ void CommandLineParser::parse()
             "All temporary data from running the benchmarks will be kept if that happens.",
             "value in per cent");
     parser.addOption(thresholdOption);
+    QCommandLineOption oldBuildPropertyOption(QStringList{"old-build-property"},
+            "A property to set when building qbs from the old commit, e.g. to select a "
+            "feature that is chosen at build time. Can be given more than once.",
+            "key:value");
+    parser.addOption(oldBuildPropertyOption);
+    QCommandLineOption newBuildPropertyOption(QStringList{"new-build-property"},
+            "A property to set when building qbs from the new commit. "
+            "Can be given more than once.", "key:value");
+    parser.addOption(newBuildPropertyOption);
     parser.process(*QCoreApplication::instance());
     const QList<QCommandLineOption> mandatoryOptions = QList<QCommandLineOption>()
             << oldCommitOption << newCommitOption << testProjectOption << qbsRepoOption;
@@ -82,9 +91,12 @@ void CommandLineParser::parse()
     }
     m_oldCommit = parser.value(oldCommitOption);
     m_newCommit = parser.value(newCommitOption);
-    if (m_oldCommit == m_newCommit) {
+    m_oldBuildProperties = parser.values(oldBuildPropertyOption);
+    m_newBuildProperties = parser.values(newBuildPropertyOption);
+    if (m_oldCommit == m_newCommit && m_oldBuildProperties == m_newBuildProperties) {
         throw Exception(QStringLiteral("Error parsing command line: "
-                "'new commit' and 'old commit' must be different commits.\n%1").arg(parser.helpText()));
+                "'new commit' and 'old commit' must be different commits, unless different "
+                "build properties are given.\n%1").arg(parser.helpText()));
     }
     m_testProjectFilePath = parser.value(testProjectOption);
     m_qbsRepoDirPath = parser.value(qbsRepoOption);
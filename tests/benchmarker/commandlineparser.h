@@ -46,6 +46,8 @@ public:
     QString newCommit() const { return m_newCommit; }
     QString testProjectFilePath() const { return m_testProjectFilePath; }
     QString qbsRepoDirPath() const { return m_qbsRepoDirPath; }
+    QStringList oldBuildProperties() const { return m_oldBuildProperties; }
+    QStringList newBuildProperties() const { return m_newBuildProperties; }
     int regressionThreshold() const { return m_regressionThreshold; }
 
 private:
@@ -58,6 +60,8 @@ private:
     QString m_newCommit;
     QString m_testProjectFilePath;
     QString m_qbsRepoDirPath;
+    QStringList m_oldBuildProperties;
+    QStringList m_newBuildProperties;
     int m_regressionThreshold = 0;
 };
 